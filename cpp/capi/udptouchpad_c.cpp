@@ -0,0 +1,210 @@
+#include <udptouchpad_c.h>
+#include <udptouchpad.hpp>
+#include <deque>
+
+
+/**
+ * @brief The event system behind the opaque handle of the C API. Callbacks write directly into the caller-provided arrays
+ * that are set for the duration of one @ref udptouchpad_poll_events call.
+ */
+struct udptouchpad_event_system {
+    udptouchpad::EventSystem eventSystem;              // The actual event system.
+    udptouchpad_connection_events* connectionEvents;   // Destination for connection events during polling.
+    udptouchpad_pointer_events* pointerEvents;         // Destination for touchpad pointer events during polling.
+    udptouchpad_motion_events* motionEvents;           // Destination for motion sensor events during polling.
+    std::deque<std::string> errors;                    // Collected error messages, oldest first.
+    std::vector<udptouchpad::DeviceState> states;      // Buffer for device states, its capacity is reused.
+};
+
+
+/**
+ * @brief Convert a timepoint of the steady clock to seconds.
+ * @param[in] t The timepoint to be converted.
+ * @return Seconds since the epoch of the steady clock.
+ */
+static double ToSeconds(std::chrono::time_point<std::chrono::steady_clock> t){
+    return 1.0e-9 * static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count());
+}
+
+
+/**
+ * @brief Copy touchpad pointer data into flat arrays.
+ * @param[in] index Index of the event or device state in the arrays.
+ * @param[in] pointer The touch pointers to be copied.
+ * @param[out] pressed Destination array for pressed flags.
+ * @param[out] startPosition Destination array for start positions.
+ * @param[out] position Destination array for positions.
+ */
+static void CopyPointers(uint32_t index, const std::array<udptouchpad::TouchpadPointer, UDPTOUCHPAD_NUM_POINTERS>& pointer, uint8_t* pressed, double* startPosition, double* position){
+    for(size_t i = 0; i < pointer.size(); ++i){
+        size_t k = static_cast<size_t>(index) * UDPTOUCHPAD_NUM_POINTERS + i;
+        pressed[k] = static_cast<uint8_t>(pointer[i].pressed);
+        startPosition[2 * k] = pointer[i].startPosition[0];
+        startPosition[2 * k + 1] = pointer[i].startPosition[1];
+        position[2 * k] = pointer[i].position[0];
+        position[2 * k + 1] = pointer[i].position[1];
+    }
+}
+
+
+/**
+ * @brief Copy motion sensor data into flat arrays.
+ * @param[in] index Index of the event or device state in the arrays.
+ * @param[in] rotationVector, acceleration, angularRate The sensor data to be copied.
+ * @param[out] dstRotationVector, dstAcceleration, dstAngularRate Destination arrays.
+ */
+static void CopyMotion(uint32_t index, const std::array<float,3>& rotationVector, const std::array<float,3>& acceleration, const std::array<float,3>& angularRate, float* dstRotationVector, float* dstAcceleration, float* dstAngularRate){
+    for(size_t i = 0; i < 3; ++i){
+        dstRotationVector[3 * index + i] = rotationVector[i];
+        dstAcceleration[3 * index + i] = acceleration[i];
+        dstAngularRate[3 * index + i] = angularRate[i];
+    }
+}
+
+
+uint32_t udptouchpad_get_api_version(void){
+    return UDPTOUCHPAD_C_API_VERSION;
+}
+
+
+udptouchpad_event_system* udptouchpad_create(void){
+    udptouchpad_event_system* system = new (std::nothrow) udptouchpad_event_system();
+    if(!system){
+        return nullptr;
+    }
+    system->connectionEvents = nullptr;
+    system->pointerEvents = nullptr;
+    system->motionEvents = nullptr;
+    system->eventSystem.SetErrorCallback([system](udptouchpad::ErrorEvent e){
+        if(system->errors.size() >= 64){
+            system->errors.pop_front();
+        }
+        system->errors.push_back(e.message);
+    });
+    system->eventSystem.SetDeviceConnectionCallback([system](udptouchpad::DeviceConnectionEvent e){
+        udptouchpad_connection_events* dst = system->connectionEvents;
+        if(!dst){
+            return;
+        }
+        if(dst->count >= dst->capacity){
+            dst->dropped++;
+            return;
+        }
+        dst->deviceID[dst->count] = e.deviceID;
+        dst->timestamp[dst->count] = ToSeconds(e.timestamp);
+        dst->connected[dst->count] = static_cast<uint8_t>(e.connected);
+        dst->count++;
+    });
+    system->eventSystem.SetTouchpadPointerCallback([system](udptouchpad::TouchpadPointerEvent e){
+        udptouchpad_pointer_events* dst = system->pointerEvents;
+        if(!dst){
+            return;
+        }
+        if(dst->count >= dst->capacity){
+            dst->dropped++;
+            return;
+        }
+        dst->deviceID[dst->count] = e.deviceID;
+        dst->timestamp[dst->count] = ToSeconds(e.timestamp);
+        dst->aspectRatio[dst->count] = e.aspectRatio;
+        CopyPointers(dst->count, e.pointer, dst->pressed, dst->startPosition, dst->position);
+        dst->count++;
+    });
+    system->eventSystem.SetMotionSensorCallback([system](udptouchpad::MotionSensorEvent e){
+        udptouchpad_motion_events* dst = system->motionEvents;
+        if(!dst){
+            return;
+        }
+        if(dst->count >= dst->capacity){
+            dst->dropped++;
+            return;
+        }
+        dst->deviceID[dst->count] = e.deviceID;
+        dst->timestamp[dst->count] = ToSeconds(e.timestamp);
+        CopyMotion(dst->count, e.rotationVector, e.acceleration, e.angularRate, dst->rotationVector, dst->acceleration, dst->angularRate);
+        dst->count++;
+    });
+    return system;
+}
+
+
+void udptouchpad_destroy(udptouchpad_event_system* system){
+    delete system;
+}
+
+
+void udptouchpad_clear(udptouchpad_event_system* system){
+    if(system){
+        system->eventSystem.Clear();
+        system->errors.clear();
+    }
+}
+
+
+uint32_t udptouchpad_poll_events(udptouchpad_event_system* system, udptouchpad_connection_events* connectionEvents, udptouchpad_pointer_events* pointerEvents, udptouchpad_motion_events* motionEvents){
+    if(!system){
+        return 0;
+    }
+    uint32_t count = 0;
+    if(connectionEvents){
+        connectionEvents->count = 0;
+        connectionEvents->dropped = 0;
+    }
+    if(pointerEvents){
+        pointerEvents->count = 0;
+        pointerEvents->dropped = 0;
+    }
+    if(motionEvents){
+        motionEvents->count = 0;
+        motionEvents->dropped = 0;
+    }
+    system->connectionEvents = connectionEvents;
+    system->pointerEvents = pointerEvents;
+    system->motionEvents = motionEvents;
+    system->eventSystem.PollEvents();
+    system->connectionEvents = nullptr;
+    system->pointerEvents = nullptr;
+    system->motionEvents = nullptr;
+    count += connectionEvents ? connectionEvents->count : 0;
+    count += pointerEvents ? pointerEvents->count : 0;
+    count += motionEvents ? motionEvents->count : 0;
+    return count;
+}
+
+
+uint32_t udptouchpad_get_device_states(udptouchpad_event_system* system, udptouchpad_device_states* states){
+    if(!system || !states){
+        return 0;
+    }
+    states->count = 0;
+    states->dropped = 0;
+    system->eventSystem.GetAllDeviceStates(system->states);
+    for(auto&& state : system->states){
+        if(states->count >= states->capacity){
+            states->dropped++;
+            continue;
+        }
+        states->deviceID[states->count] = state.deviceID;
+        states->timestamp[states->count] = ToSeconds(state.timestampReceive);
+        states->aspectRatio[states->count] = state.aspectRatio;
+        CopyPointers(states->count, state.pointer, states->pressed, states->startPosition, states->position);
+        CopyMotion(states->count, state.rotationVector, state.acceleration, state.angularRate, states->rotationVector, states->acceleration, states->angularRate);
+        states->count++;
+    }
+    return states->count;
+}
+
+
+int32_t udptouchpad_poll_error(udptouchpad_event_system* system, char* buffer, uint32_t size){
+    if(!system || system->errors.empty()){
+        return 0;
+    }
+    if(buffer && size){
+        size_t length = std::min(static_cast<size_t>(size - 1), system->errors.front().size());
+        std::memcpy(buffer, system->errors.front().data(), length);
+        buffer[length] = 0;
+    }
+    system->errors.pop_front();
+    return 1;
+}
+
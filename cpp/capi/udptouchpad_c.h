@@ -0,0 +1,177 @@
+/**
+ * @file udptouchpad_c.h
+ * @brief C API of the UDPTouchpad library, e.g. for MATLAB/Simulink or Python via FFI. All pending events are exported in
+ * one call into caller-provided flat arrays (structure of arrays).
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+
+#include <stdint.h>
+
+
+#ifdef _WIN32
+#ifdef UDPTOUCHPAD_C_API_EXPORTS
+#define UDPTOUCHPAD_C_API __declspec(dllexport)
+#else
+#define UDPTOUCHPAD_C_API __declspec(dllimport)
+#endif
+#else
+#define UDPTOUCHPAD_C_API __attribute__((visibility("default")))
+#endif
+
+
+/**
+ * @brief Version of the C API. It is incremented whenever the API or one of the structures below changes.
+ */
+#define UDPTOUCHPAD_C_API_VERSION (1)
+
+
+/**
+ * @brief Number of touch pointers per device.
+ */
+#define UDPTOUCHPAD_NUM_POINTERS (10)
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Opaque handle of an event system.
+ */
+typedef struct udptouchpad_event_system udptouchpad_event_system;
+
+
+/**
+ * @brief Device connection events. All arrays are provided by the caller and must have at least capacity elements.
+ * Timestamps are given in seconds of the monotonic clock of the operating system.
+ */
+typedef struct udptouchpad_connection_events {
+    uint32_t capacity;    // [in] Maximum number of events that can be stored in the arrays.
+    uint32_t count;       // [out] Number of events that have been stored in the arrays.
+    uint32_t dropped;     // [out] Number of events that have been dropped because the capacity was too small.
+    uint32_t* deviceID;   // [out] Device IDs (IPv4 addresses), capacity elements.
+    double* timestamp;    // [out] Timestamps in seconds, capacity elements.
+    uint8_t* connected;   // [out] 1 if the device has been connected, 0 if it has been disconnected, capacity elements.
+} udptouchpad_connection_events;
+
+
+/**
+ * @brief Touchpad pointer events. All arrays are provided by the caller, pointer data is stored event by event, e.g.
+ * position[(event * UDPTOUCHPAD_NUM_POINTERS + pointer) * 2 + axis].
+ */
+typedef struct udptouchpad_pointer_events {
+    uint32_t capacity;       // [in] Maximum number of events that can be stored in the arrays.
+    uint32_t count;          // [out] Number of events that have been stored in the arrays.
+    uint32_t dropped;        // [out] Number of events that have been dropped because the capacity was too small.
+    uint32_t* deviceID;      // [out] Device IDs (IPv4 addresses), capacity elements.
+    double* timestamp;       // [out] Timestamps in seconds, capacity elements.
+    double* aspectRatio;     // [out] Aspect ratio of the touch screen (width/height), capacity elements.
+    uint8_t* pressed;        // [out] 1 if a pointer is pressed, 0 otherwise, capacity * UDPTOUCHPAD_NUM_POINTERS elements.
+    double* startPosition;   // [out] Pointer positions when pressed in relative screen coordinates, capacity * UDPTOUCHPAD_NUM_POINTERS * 2 elements.
+    double* position;        // [out] Current pointer positions in relative screen coordinates, capacity * UDPTOUCHPAD_NUM_POINTERS * 2 elements.
+} udptouchpad_pointer_events;
+
+
+/**
+ * @brief Motion sensor events. All arrays are provided by the caller, sensor data is stored event by event, e.g.
+ * acceleration[event * 3 + axis].
+ */
+typedef struct udptouchpad_motion_events {
+    uint32_t capacity;       // [in] Maximum number of events that can be stored in the arrays.
+    uint32_t count;          // [out] Number of events that have been stored in the arrays.
+    uint32_t dropped;        // [out] Number of events that have been dropped because the capacity was too small.
+    uint32_t* deviceID;      // [out] Device IDs (IPv4 addresses), capacity elements.
+    double* timestamp;       // [out] Timestamps in seconds, capacity elements.
+    float* rotationVector;   // [out] 3D rotation vectors, capacity * 3 elements.
+    float* acceleration;     // [out] 3D accelerations in m/s^2, capacity * 3 elements.
+    float* angularRate;      // [out] 3D angular rates in rad/s, capacity * 3 elements.
+} udptouchpad_motion_events;
+
+
+/**
+ * @brief Latest states of connected devices. All arrays are provided by the caller, the layout of pointer and sensor data
+ * is the same as for @ref udptouchpad_pointer_events and @ref udptouchpad_motion_events.
+ */
+typedef struct udptouchpad_device_states {
+    uint32_t capacity;       // [in] Maximum number of device states that can be stored in the arrays.
+    uint32_t count;          // [out] Number of device states that have been stored in the arrays.
+    uint32_t dropped;        // [out] Number of device states that have been dropped because the capacity was too small.
+    uint32_t* deviceID;      // [out] Device IDs (IPv4 addresses), capacity elements.
+    double* timestamp;       // [out] Timestamps of the latest received messages in seconds, capacity elements.
+    double* aspectRatio;     // [out] Aspect ratio of the touch screen (width/height), capacity elements.
+    uint8_t* pressed;        // [out] 1 if a pointer is pressed, 0 otherwise, capacity * UDPTOUCHPAD_NUM_POINTERS elements.
+    double* startPosition;   // [out] Pointer positions when pressed in relative screen coordinates, capacity * UDPTOUCHPAD_NUM_POINTERS * 2 elements.
+    double* position;        // [out] Current pointer positions in relative screen coordinates, capacity * UDPTOUCHPAD_NUM_POINTERS * 2 elements.
+    float* rotationVector;   // [out] 3D rotation vectors, capacity * 3 elements.
+    float* acceleration;     // [out] 3D accelerations in m/s^2, capacity * 3 elements.
+    float* angularRate;      // [out] 3D angular rates in rad/s, capacity * 3 elements.
+} udptouchpad_device_states;
+
+
+/**
+ * @brief Get the version of the C API that the shared library has been built with.
+ * @return Version number, compare with @ref UDPTOUCHPAD_C_API_VERSION.
+ */
+UDPTOUCHPAD_C_API uint32_t udptouchpad_get_api_version(void);
+
+
+/**
+ * @brief Create a new event system that starts receiving messages immediately.
+ * @return Handle of the event system or NULL on failure.
+ */
+UDPTOUCHPAD_C_API udptouchpad_event_system* udptouchpad_create(void);
+
+
+/**
+ * @brief Destroy an event system.
+ * @param[in] system Handle of the event system. May be NULL.
+ */
+UDPTOUCHPAD_C_API void udptouchpad_destroy(udptouchpad_event_system* system);
+
+
+/**
+ * @brief Clear all pending events and reset the internal device database.
+ * @param[in] system Handle of the event system.
+ */
+UDPTOUCHPAD_C_API void udptouchpad_clear(udptouchpad_event_system* system);
+
+
+/**
+ * @brief Poll all pending events and store them in caller-provided arrays.
+ * @param[in] system Handle of the event system.
+ * @param[inout] connectionEvents Destination for device connection events or NULL to discard them.
+ * @param[inout] pointerEvents Destination for touchpad pointer events or NULL to discard them.
+ * @param[inout] motionEvents Destination for motion sensor events or NULL to discard them.
+ * @return Total number of events that have been stored.
+ * @details Error messages are buffered internally and can be obtained via @ref udptouchpad_poll_error.
+ */
+UDPTOUCHPAD_C_API uint32_t udptouchpad_poll_events(udptouchpad_event_system* system, udptouchpad_connection_events* connectionEvents, udptouchpad_pointer_events* pointerEvents, udptouchpad_motion_events* motionEvents);
+
+
+/**
+ * @brief Get the latest states of all connected devices without consuming any events.
+ * @param[in] system Handle of the event system.
+ * @param[inout] states Destination for the device states.
+ * @return Number of device states that have been stored.
+ */
+UDPTOUCHPAD_C_API uint32_t udptouchpad_get_device_states(udptouchpad_event_system* system, udptouchpad_device_states* states);
+
+
+/**
+ * @brief Get the oldest error message that has been collected by @ref udptouchpad_poll_events.
+ * @param[in] system Handle of the event system.
+ * @param[out] buffer Destination for the zero-terminated error message.
+ * @param[in] size Size of the destination buffer in bytes. Longer messages are truncated.
+ * @return 1 if an error message has been stored, 0 if there are no more error messages.
+ */
+UDPTOUCHPAD_C_API int32_t udptouchpad_poll_error(udptouchpad_event_system* system, char* buffer, uint32_t size);
+
+
+#ifdef __cplusplus
+}
+#endif
+
@@ -0,0 +1,72 @@
+#include <udptouchpad.hpp>
+#include <iostream>
+#include <csignal>
+
+
+/**
+ * @brief Minimal fire-and-forget coroutine type. The coroutine starts immediately and destroys itself when finished.
+ */
+struct Task {
+    struct promise_type {
+        Task get_return_object(void){ return {}; }
+        std::suspend_never initial_suspend(void) noexcept { return {}; }
+        std::suspend_never final_suspend(void) noexcept { return {}; }
+        void return_void(void){}
+        void unhandled_exception(void){ std::terminate(); }
+    };
+};
+
+
+static Task ObserveDevice(udptouchpad::DeviceEventStream stream){
+    std::cerr << "[DEVICE " << stream.GetDeviceID() << "] observing\n";
+    while(true){
+        udptouchpad::Event event = co_await stream.Next();
+        if(auto e = std::get_if<udptouchpad::DeviceConnectionEvent>(&event)){
+            if(!e->connected){
+                break;
+            }
+        }
+        else if(auto e = std::get_if<udptouchpad::TouchpadPointerEvent>(&event)){
+            std::cerr << "[DEVICE " << stream.GetDeviceID() << "] " << e->ToString() << "\n";
+        }
+    }
+    std::cerr << "[DEVICE " << stream.GetDeviceID() << "] disconnected\n";
+}
+
+
+static Task ObserveConnections(udptouchpad::EventSystem& eventSystem){
+    while(true){
+        udptouchpad::Event event = co_await eventSystem.NextEvent();
+        if(auto e = std::get_if<udptouchpad::ErrorEvent>(&event)){
+            std::cerr << "[ERROR] " << e->ToString() << "\n";
+        }
+        else if(auto e = std::get_if<udptouchpad::DeviceConnectionEvent>(&event)){
+            if(e->connected){
+                ObserveDevice(eventSystem.Events(e->deviceID));
+            }
+        }
+    }
+}
+
+
+static bool terminate = false;
+static void SignalHandler(int){ terminate = true; }
+
+
+int main(int, char**){
+    std::signal(SIGINT, &SignalHandler);
+    std::signal(SIGTERM, &SignalHandler);
+    std::cerr << "Running example\nPress Ctrl+C to terminate\n";
+
+    // create an event system and start a coroutine that waits for new devices
+    udptouchpad::EventSystem eventSystem;
+    eventSystem.Clear();
+    ObserveConnections(eventSystem);
+
+    // coroutines are resumed from within PollEvents
+    while(!terminate){
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+        eventSystem.PollEvents();
+    }
+    return 0;
+}
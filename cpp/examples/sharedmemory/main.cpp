@@ -0,0 +1,83 @@
+#include <udptouchpad.hpp>
+#include <iostream>
+#include <csignal>
+
+
+static void CallbackError(udptouchpad::ErrorEvent e){
+    std::cerr << "[ERROR] " << e.ToString() << "\n";
+}
+
+static void CallbackDeviceConnection(udptouchpad::DeviceConnectionEvent e){
+    std::cerr << "[DEVCON] " << e.ToString() << "\n";
+}
+
+static void CallbackTouchpadPointer(udptouchpad::TouchpadPointerEvent e){
+    std::cerr << "[POINTER] " << e.ToString() << "\n";
+}
+
+static bool terminate = false;
+static void SignalHandler(int){ terminate = true; }
+
+
+static void RunPublisher(void){
+    // create an event system that publishes everything to shared memory
+    udptouchpad::EventSystem eventSystem;
+    eventSystem.SetErrorCallback(CallbackError);
+    eventSystem.Clear();
+    if(!eventSystem.EnableSharedMemoryPublisher("udptouchpad")){
+        eventSystem.PollEvents();
+        return;
+    }
+
+    // events are published whenever events are polled
+    while(!terminate){
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+        eventSystem.PollEvents();
+    }
+}
+
+
+static void RunSubscriber(void){
+    // open the shared memory of the publisher and set user-defined callback functions
+    udptouchpad::SharedMemorySubscriber subscriber;
+    if(!subscriber.Open("udptouchpad")){
+        std::cerr << "[ERROR] " << subscriber.GetErrorString() << "\n";
+        return;
+    }
+    subscriber.SetErrorCallback(CallbackError);
+    subscriber.SetDeviceConnectionCallback(CallbackDeviceConnection);
+    subscriber.SetTouchpadPointerCallback(CallbackTouchpadPointer);
+
+    // poll events and print the latest state of all devices once per second
+    std::vector<udptouchpad::DeviceState> states;
+    for(int i = 0; !terminate; ++i){
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+        subscriber.PollEvents();
+        if(!(i % 64)){
+            subscriber.GetAllDeviceStates(states);
+            for(auto&& state : states){
+                std::cerr << "[STATE] " << state.ToString() << "\n";
+            }
+        }
+    }
+}
+
+
+int main(int argc, char** argv){
+    std::signal(SIGINT, &SignalHandler);
+    std::signal(SIGTERM, &SignalHandler);
+    bool publish = (argc > 1) && (std::string("publish") == argv[1]);
+    bool subscribe = (argc > 1) && (std::string("subscribe") == argv[1]);
+    if(!publish && !subscribe){
+        std::cerr << "Usage: " << argv[0] << " publish|subscribe\n";
+        return -1;
+    }
+    std::cerr << "Running example\nPress Ctrl+C to terminate\n";
+    if(publish){
+        RunPublisher();
+    }
+    else{
+        RunSubscriber();
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/TouchpadMessage.hpp>
+#include <udptouchpad/detail/BatchMessage.hpp>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief One sample of a batched touchpad message, given in native byte order.
+ */
+class BatchSample {
+    public:
+        uint32_t timestamp;                                   // Timestamp of the sample in microseconds, given by a free-running clock of the device.
+        std::array<uint8_t,10> pointerID;                     // ID of the pointer that touches the screen or 0xFF if a pointer is not present.
+        std::array<std::array<float,2>,10> pointerPosition;   // 2D position for each pointer in pixels or zero if the corresponding pointer is not present.
+        std::array<float,3> rotationVector;                   // 3D rotation vector sensor data or NaN if no motion sensor is available.
+        std::array<float,3> acceleration;                     // 3D accelerometer sensor data in m/s^2 or NaN if no motion sensor is available.
+        std::array<float,3> angularRate;                      // 3D gyroscope sensor data in rad/s or NaN if no motion sensor is available.
+
+        /**
+         * @brief Construct a new batch sample without pointers and without motion sensor data.
+         */
+        BatchSample(): timestamp(0) {
+            pointerID.fill(0xFF);
+            for(auto&& p : pointerPosition){
+                p.fill(0.0f);
+            }
+            rotationVector.fill(std::numeric_limits<float>::quiet_NaN());
+            acceleration.fill(std::numeric_limits<float>::quiet_NaN());
+            angularRate.fill(std::numeric_limits<float>::quiet_NaN());
+        }
+};
+
+
+/**
+ * @brief Encodes samples of one device into batched touchpad messages (header 0x43) using the latest layout version. The
+ * encoder is intended for testing and benchmarking, e.g. to send batched messages to an @ref EventSystem on the local host.
+ */
+class BatchEncoder {
+    public:
+        /**
+         * @brief Construct a new batch encoder.
+         * @param[in] screenWidth Width of the device screen in pixels.
+         * @param[in] screenHeight Height of the device screen in pixels.
+         * @param[in] deltaEncoding True if samples should be delta-encoded, false otherwise.
+         */
+        BatchEncoder(uint32_t screenWidth, uint32_t screenHeight, bool deltaEncoding): screenWidth(screenWidth), screenHeight(screenHeight), deltaEncoding(deltaEncoding), counter(0), maxMessageSize(UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE) {}
+
+        /**
+         * @brief Set the maximum size of an encoded message.
+         * @param[in] size The maximum size in bytes. By default, this is @ref UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE.
+         */
+        void SetMaxMessageSize(size_t size){ maxMessageSize = size; }
+
+        /**
+         * @brief Encode samples into one batched touchpad message.
+         * @param[out] message The encoded message. The container is cleared first, its capacity is reused.
+         * @param[in] samples Pointer to the samples to be encoded.
+         * @param[in] numSamples The number of samples to be encoded.
+         * @param[in] transmitTimestamp Time of transmission in microseconds, given by the same clock as the sample timestamps.
+         * @return The number of samples that have been encoded, starting with the first one. Encoding stops if the message
+         * would exceed the maximum message size, if 255 samples have been encoded or if a sample cannot be delta-encoded.
+         * The remaining samples should be encoded into the next message. Zero is returned if not even a single sample fits.
+         */
+        size_t Encode(std::vector<uint8_t>& message, const udptouchpad::BatchSample* samples, size_t numSamples, uint32_t transmitTimestamp){
+            message.clear();
+            numSamples = std::min(numSamples, static_cast<size_t>(std::numeric_limits<uint8_t>::max()));
+            if(!numSamples || ((sizeof(udptouchpad::detail::SerializationBatchHeader) + sizeof(Sample)) > maxMessageSize)){
+                return 0;
+            }
+
+            // the first sample is always complete
+            message.resize(sizeof(udptouchpad::detail::SerializationBatchHeader) + sizeof(Sample));
+            udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct previous = ToMessage(samples[0]);
+            uint32_t previousTimestamp = samples[0].timestamp;
+            Sample sample;
+            sample.Encode(previous, previousTimestamp);
+            std::memcpy(&message[sizeof(udptouchpad::detail::SerializationBatchHeader)], static_cast<const void*>(&sample), sizeof(Sample));
+
+            // all other samples are complete samples or delta samples
+            size_t n = 1;
+            for(; n < numSamples; ++n){
+                size_t offset = message.size();
+                udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct msg = ToMessage(samples[n]);
+                if(deltaEncoding){
+                    if((offset + sizeof(DeltaSample)) > maxMessageSize){
+                        break;
+                    }
+                    DeltaSample delta;
+                    if(!delta.Encode(msg, samples[n].timestamp, previous, previousTimestamp)){
+                        break;
+                    }
+                    message.resize(offset + sizeof(DeltaSample));
+                    std::memcpy(&message[offset], static_cast<const void*>(&delta), sizeof(DeltaSample));
+                }
+                else{
+                    if((offset + sizeof(Sample)) > maxMessageSize){
+                        break;
+                    }
+                    sample.Encode(msg, samples[n].timestamp);
+                    message.resize(offset + sizeof(Sample));
+                    std::memcpy(&message[offset], static_cast<const void*>(&sample), sizeof(Sample));
+                }
+            }
+
+            // the header is written last, when the number of samples is known
+            udptouchpad::detail::SerializationBatchHeader header;
+            header.header = 0x43;
+            header.version = Layout::version;
+            header.counter = counter;
+            header.flags = deltaEncoding ? udptouchpad::detail::batch_flag_delta_encoded : 0;
+            header.numSamples = static_cast<uint8_t>(n);
+            header.screenWidth = udptouchpad::detail::NetworkToNative(screenWidth);
+            header.screenHeight = udptouchpad::detail::NetworkToNative(screenHeight);
+            header.timestamp = udptouchpad::detail::NetworkToNative(transmitTimestamp);
+            std::memcpy(&message[0], static_cast<const void*>(&header), sizeof(header));
+            counter += static_cast<uint8_t>(n);
+            return n;
+        }
+
+        /**
+         * @brief Encode samples into one batched touchpad message.
+         * @param[out] message The encoded message. The container is cleared first, its capacity is reused.
+         * @param[in] samples The samples to be encoded.
+         * @param[in] transmitTimestamp Time of transmission in microseconds, given by the same clock as the sample timestamps.
+         * @return The number of samples that have been encoded, starting with the first one.
+         */
+        size_t Encode(std::vector<uint8_t>& message, const std::vector<udptouchpad::BatchSample>& samples, uint32_t transmitTimestamp){
+            return Encode(message, samples.data(), samples.size(), transmitTimestamp);
+        }
+
+    private:
+        using Layout = std::tuple_element_t<std::tuple_size_v<udptouchpad::detail::BatchMessageLayouts> - 1, udptouchpad::detail::BatchMessageLayouts>;
+        using Sample = typename Layout::SampleType;
+        using DeltaSample = typename Layout::DeltaSampleType;
+
+        uint32_t screenWidth;    // Width of the device screen in pixels.
+        uint32_t screenHeight;   // Height of the device screen in pixels.
+        bool deltaEncoding;      // True if samples should be delta-encoded, false otherwise.
+        uint8_t counter;         // Counter of the next sample.
+        size_t maxMessageSize;   // Maximum size of an encoded message in bytes.
+
+        /**
+         * @brief Convert a batch sample to a touchpad message in native byte order.
+         * @param[in] s The sample to be converted.
+         * @return The touchpad message.
+         */
+        udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct ToMessage(const udptouchpad::BatchSample& s){
+            udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct msg;
+            msg.header = 0x42;
+            msg.counter = 0;
+            msg.screenWidth = screenWidth;
+            msg.screenHeight = screenHeight;
+            msg.pointerID = s.pointerID;
+            msg.pointerPosition = s.pointerPosition;
+            msg.rotationVector = s.rotationVector;
+            msg.acceleration = s.acceleration;
+            msg.angularRate = s.angularRate;
+            return msg;
+        }
+};
+
+
+} /* namespace: udptouchpad */
+
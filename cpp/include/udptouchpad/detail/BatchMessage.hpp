@@ -0,0 +1,335 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/TouchpadMessage.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Convert a value between network byte order (big-endian) and native byte order.
+ * @tparam T Template datatype.
+ * @param[in] value The value to be converted.
+ * @return The converted value.
+ */
+template <typename T> inline T NetworkToNative(T value){
+    if constexpr (std::endian::native != std::endian::big){
+        return udptouchpad::detail::SwapEndian(value);
+    }
+    return value;
+}
+
+
+/**
+ * @brief Header of a batched touchpad message. A batch carries several timestamped samples of one device in a single datagram.
+ * The header is followed by the samples, whose layout is selected by the version.
+ */
+#pragma pack(push, 1)
+struct SerializationBatchHeader {
+    uint8_t header;          // Must be 0x43.
+    uint8_t version;         // Version of the sample layout, see @ref BatchMessageLayouts.
+    uint8_t counter;         // Counter of the first sample, the counter of sample i is counter + i.
+    uint8_t flags;           // Bitmask of @ref BatchMessageFlags.
+    uint8_t numSamples;      // Number of samples following the header.
+    uint32_t screenWidth;    // Width of the device screen in pixels.
+    uint32_t screenHeight;   // Height of the device screen in pixels.
+    uint32_t timestamp;      // Time of transmission in microseconds, given by the same clock as the sample timestamps.
+};
+#pragma pack(pop)
+
+
+/**
+ * @brief Flags of a batched touchpad message.
+ */
+enum BatchMessageFlags: uint8_t {
+    batch_flag_delta_encoded = (1 << 0)   // If set, all samples except the first one are delta samples.
+};
+
+
+/**
+ * @brief Version 1 of a complete sample of a batched touchpad message.
+ */
+#pragma pack(push, 1)
+struct SerializationBatchSampleV1 {
+    uint32_t timestamp;                                   // Timestamp of the sample in microseconds, given by a free-running clock of the device.
+    std::array<uint8_t,10> pointerID;                     // ID of the pointer that touches the screen or 0xFF if a pointer is not present.
+    std::array<std::array<float,2>,10> pointerPosition;   // 2D position for each pointer in pixels or zero if the corresponding pointer is not present.
+    std::array<float,3> rotationVector;                   // 3D rotation vector sensor data or NaN if no motion sensor is available.
+    std::array<float,3> acceleration;                     // 3D accelerometer sensor data in m/s^2 or NaN if no motion sensor is available.
+    std::array<float,3> angularRate;                      // 3D gyroscope sensor data in rad/s or NaN if no motion sensor is available.
+
+    /**
+     * @brief Decode this sample.
+     * @param[out] msg The message to be set. Header, counter and screen size are not changed.
+     * @param[out] t The timestamp of the sample.
+     */
+    void Decode(udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg, uint32_t& t) const {
+        t = udptouchpad::detail::NetworkToNative(timestamp);
+        msg.pointerID = pointerID;
+        for(size_t i = 0; i < pointerPosition.size(); ++i){
+            msg.pointerPosition[i][0] = udptouchpad::detail::NetworkToNative(pointerPosition[i][0]);
+            msg.pointerPosition[i][1] = udptouchpad::detail::NetworkToNative(pointerPosition[i][1]);
+        }
+        for(size_t i = 0; i < 3; ++i){
+            msg.rotationVector[i] = udptouchpad::detail::NetworkToNative(rotationVector[i]);
+            msg.acceleration[i] = udptouchpad::detail::NetworkToNative(acceleration[i]);
+            msg.angularRate[i] = udptouchpad::detail::NetworkToNative(angularRate[i]);
+        }
+    }
+
+    /**
+     * @brief Encode this sample.
+     * @param[in] msg The message to be encoded.
+     * @param[in] t The timestamp of the sample.
+     */
+    void Encode(const udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg, const uint32_t t){
+        timestamp = udptouchpad::detail::NetworkToNative(t);
+        pointerID = msg.pointerID;
+        for(size_t i = 0; i < pointerPosition.size(); ++i){
+            pointerPosition[i][0] = udptouchpad::detail::NetworkToNative(msg.pointerPosition[i][0]);
+            pointerPosition[i][1] = udptouchpad::detail::NetworkToNative(msg.pointerPosition[i][1]);
+        }
+        for(size_t i = 0; i < 3; ++i){
+            rotationVector[i] = udptouchpad::detail::NetworkToNative(msg.rotationVector[i]);
+            acceleration[i] = udptouchpad::detail::NetworkToNative(msg.acceleration[i]);
+            angularRate[i] = udptouchpad::detail::NetworkToNative(msg.angularRate[i]);
+        }
+    }
+};
+#pragma pack(pop)
+
+
+/**
+ * @brief Version 1 of a delta sample of a batched touchpad message. All values are given as quantized differences to the
+ * previous sample, where the previous sample is the sample that the decoder has reconstructed.
+ */
+#pragma pack(push, 1)
+struct SerializationBatchDeltaSampleV1 {
+    uint16_t timestampDelta;                                    // Difference to the timestamp of the previous sample in microseconds.
+    std::array<uint8_t,10> pointerID;                           // ID of the pointer that touches the screen or 0xFF if a pointer is not present.
+    std::array<std::array<int16_t,2>,10> pointerPositionDelta;  // Difference to the previous pointer position in units of @ref pointerPositionScale.
+    std::array<int16_t,3> rotationVectorDelta;                  // Difference to the previous rotation vector in units of @ref rotationVectorScale.
+    std::array<int16_t,3> accelerationDelta;                    // Difference to the previous acceleration in units of @ref accelerationScale.
+    std::array<int16_t,3> angularRateDelta;                     // Difference to the previous angular rate in units of @ref angularRateScale.
+
+    static constexpr float pointerPositionScale = 0.0625f;   // Quantization of pointer positions in pixels.
+    static constexpr float rotationVectorScale = 1.0e-4f;    // Quantization of the rotation vector.
+    static constexpr float accelerationScale = 1.0e-3f;      // Quantization of the acceleration in m/s^2.
+    static constexpr float angularRateScale = 1.0e-4f;       // Quantization of the angular rate in rad/s.
+
+    /**
+     * @brief Decode this sample by applying the differences to the previous sample.
+     * @param[inout] msg The previous sample, which is updated to this sample. Header, counter and screen size are not changed.
+     * @param[inout] t The timestamp of the previous sample, which is updated to the timestamp of this sample.
+     */
+    void Decode(udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg, uint32_t& t) const {
+        t += udptouchpad::detail::NetworkToNative(timestampDelta);
+        msg.pointerID = pointerID;
+        for(size_t i = 0; i < pointerPositionDelta.size(); ++i){
+            msg.pointerPosition[i][0] = Apply(msg.pointerPosition[i][0], udptouchpad::detail::NetworkToNative(pointerPositionDelta[i][0]), pointerPositionScale);
+            msg.pointerPosition[i][1] = Apply(msg.pointerPosition[i][1], udptouchpad::detail::NetworkToNative(pointerPositionDelta[i][1]), pointerPositionScale);
+        }
+        for(size_t i = 0; i < 3; ++i){
+            msg.rotationVector[i] = Apply(msg.rotationVector[i], udptouchpad::detail::NetworkToNative(rotationVectorDelta[i]), rotationVectorScale);
+            msg.acceleration[i] = Apply(msg.acceleration[i], udptouchpad::detail::NetworkToNative(accelerationDelta[i]), accelerationScale);
+            msg.angularRate[i] = Apply(msg.angularRate[i], udptouchpad::detail::NetworkToNative(angularRateDelta[i]), angularRateScale);
+        }
+    }
+
+    /**
+     * @brief Encode the differences of a sample to the previous sample.
+     * @param[in] msg The sample to be encoded.
+     * @param[in] t The timestamp of the sample to be encoded.
+     * @param[inout] previous The previous sample as reconstructed by a decoder, which is updated to the reconstruction of this sample.
+     * @param[inout] previousTimestamp The timestamp of the previous sample, which is updated to the timestamp of this sample.
+     * @return True if success, false if a difference cannot be represented. In this case, previous and previousTimestamp are undefined.
+     */
+    bool Encode(const udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg, const uint32_t t, udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& previous, uint32_t& previousTimestamp){
+        uint32_t dt = t - previousTimestamp;
+        if(dt > std::numeric_limits<uint16_t>::max()){
+            return false;
+        }
+        timestampDelta = udptouchpad::detail::NetworkToNative(static_cast<uint16_t>(dt));
+        previousTimestamp = t;
+        pointerID = msg.pointerID;
+        previous.pointerID = msg.pointerID;
+        bool success = true;
+        for(size_t i = 0; i < pointerPositionDelta.size(); ++i){
+            success &= Quantize(msg.pointerPosition[i][0], previous.pointerPosition[i][0], pointerPositionDelta[i][0], pointerPositionScale);
+            success &= Quantize(msg.pointerPosition[i][1], previous.pointerPosition[i][1], pointerPositionDelta[i][1], pointerPositionScale);
+        }
+        for(size_t i = 0; i < 3; ++i){
+            success &= Quantize(msg.rotationVector[i], previous.rotationVector[i], rotationVectorDelta[i], rotationVectorScale);
+            success &= Quantize(msg.acceleration[i], previous.acceleration[i], accelerationDelta[i], accelerationScale);
+            success &= Quantize(msg.angularRate[i], previous.angularRate[i], angularRateDelta[i], angularRateScale);
+        }
+        return success;
+    }
+
+    /**
+     * @brief Apply a quantized difference to a value. Encoder and decoder use this function, so that both obtain exactly the same result.
+     * @param[in] value The previous value.
+     * @param[in] delta The quantized difference.
+     * @param[in] scale The quantization.
+     * @return The new value.
+     */
+    static float Apply(const float value, const int16_t delta, const float scale){
+        return value + static_cast<float>(delta) * scale;
+    }
+
+    /**
+     * @brief Quantize the difference between a value and the previous reconstructed value.
+     * @param[in] value The value to be encoded.
+     * @param[inout] previous The previous reconstructed value, which is updated to the new reconstructed value.
+     * @param[out] delta The quantized difference in network byte order.
+     * @param[in] scale The quantization.
+     * @return True if success, false if the difference cannot be represented.
+     * @details NaN values can only be encoded if the previous value is NaN as well (e.g. no motion sensor is available).
+     */
+    static bool Quantize(const float value, float& previous, int16_t& delta, const float scale){
+        if(!std::isfinite(value) || !std::isfinite(previous)){
+            delta = 0;
+            return std::isnan(value) && std::isnan(previous);
+        }
+        double d = std::round(static_cast<double>(value - previous) / static_cast<double>(scale));
+        if((d < std::numeric_limits<int16_t>::min()) || (d > std::numeric_limits<int16_t>::max())){
+            return false;
+        }
+        previous = Apply(previous, static_cast<int16_t>(d), scale);
+        delta = udptouchpad::detail::NetworkToNative(static_cast<int16_t>(d));
+        return true;
+    }
+};
+#pragma pack(pop)
+
+
+/**
+ * @brief Describes the sample layout of one version of the batched touchpad message.
+ * @tparam Version The version number that is transmitted in @ref SerializationBatchHeader::version.
+ * @tparam Sample The type of a complete sample.
+ * @tparam DeltaSample The type of a delta sample.
+ */
+template <uint8_t Version, class Sample, class DeltaSample> struct BatchMessageLayout {
+    static constexpr uint8_t version = Version;
+    using SampleType = Sample;
+    using DeltaSampleType = DeltaSample;
+};
+
+
+/**
+ * @brief Compile-time table of all supported versions of the batched touchpad message. New versions are added to the end,
+ * the last entry is used by the @ref udptouchpad::BatchEncoder.
+ */
+using BatchMessageLayouts = std::tuple<
+    udptouchpad::detail::BatchMessageLayout<1, udptouchpad::detail::SerializationBatchSampleV1, udptouchpad::detail::SerializationBatchDeltaSampleV1>
+>;
+
+
+/**
+ * @brief Decode all samples of a batched touchpad message with a specific layout in a single pass.
+ * @tparam Layout The @ref BatchMessageLayout of the message.
+ * @tparam Callback Callback type with prototype void(const SerializationTouchpadMessageStruct& msg, uint32_t age).
+ * @param[in] header The header of the message in network byte order.
+ * @param[in] bytes The bytes following the header.
+ * @param[in] length The number of bytes following the header.
+ * @param[in] callback The callback function that is called for each sample in the order of transmission.
+ * @return True if the message is valid, false otherwise. No callback is called for invalid messages.
+ */
+template <class Layout, class Callback> bool DecodeBatchSamples(const udptouchpad::detail::SerializationBatchHeader& header, const uint8_t* bytes, size_t length, Callback&& callback){
+    using Sample = typename Layout::SampleType;
+    using DeltaSample = typename Layout::DeltaSampleType;
+    const bool deltaEncoded = (0 != (header.flags & udptouchpad::detail::batch_flag_delta_encoded));
+    const size_t numSamples = header.numSamples;
+    if(!numSamples){
+        return false;
+    }
+    const size_t expectedLength = deltaEncoded ? (sizeof(Sample) + (numSamples - 1) * sizeof(DeltaSample)) : (numSamples * sizeof(Sample));
+    if(length != expectedLength){
+        return false;
+    }
+    udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct msg;
+    msg.header = 0x42;
+    msg.counter = header.counter;
+    msg.screenWidth = udptouchpad::detail::NetworkToNative(header.screenWidth);
+    msg.screenHeight = udptouchpad::detail::NetworkToNative(header.screenHeight);
+    const uint32_t transmitTimestamp = udptouchpad::detail::NetworkToNative(header.timestamp);
+    uint32_t timestamp = 0;
+    for(size_t i = 0; i < numSamples; ++i){
+        if(deltaEncoded && i){
+            DeltaSample delta;
+            std::memcpy(static_cast<void*>(&delta), bytes, sizeof(DeltaSample));
+            delta.Decode(msg, timestamp);
+            bytes += sizeof(DeltaSample);
+        }
+        else{
+            Sample sample;
+            std::memcpy(static_cast<void*>(&sample), bytes, sizeof(Sample));
+            sample.Decode(msg, timestamp);
+            bytes += sizeof(Sample);
+        }
+        int32_t age = static_cast<int32_t>(transmitTimestamp - timestamp);
+        callback(static_cast<const udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct&>(msg), static_cast<uint32_t>(std::max(age, 0)));
+        msg.counter++;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Look up the layout of a batched touchpad message in the @ref BatchMessageLayouts table and decode all samples.
+ * @tparam I Index of the table entry to be checked.
+ * @tparam Callback Callback type with prototype void(const SerializationTouchpadMessageStruct& msg, uint32_t age).
+ * @param[in] header The header of the message in network byte order.
+ * @param[in] bytes The bytes following the header.
+ * @param[in] length The number of bytes following the header.
+ * @param[in] callback The callback function that is called for each sample in the order of transmission.
+ * @return True if the message is valid and its version is known, false otherwise.
+ */
+template <size_t I = 0, class Callback> bool DecodeBatchVersion(const udptouchpad::detail::SerializationBatchHeader& header, const uint8_t* bytes, size_t length, Callback&& callback){
+    if constexpr (I < std::tuple_size_v<udptouchpad::detail::BatchMessageLayouts>){
+        using Layout = std::tuple_element_t<I, udptouchpad::detail::BatchMessageLayouts>;
+        if(Layout::version == header.version){
+            return udptouchpad::detail::DecodeBatchSamples<Layout>(header, bytes, length, callback);
+        }
+        return udptouchpad::detail::DecodeBatchVersion<I + 1>(header, bytes, length, callback);
+    }
+    else{
+        return false;
+    }
+}
+
+
+/**
+ * @brief Decode a batched touchpad message in a single pass.
+ * @tparam Callback Callback type with prototype void(const SerializationTouchpadMessageStruct& msg, uint32_t age).
+ * @param[in] bytes The bytes of the received datagram.
+ * @param[in] length The length of the received datagram.
+ * @param[in] callback The callback function that is called for each sample in the order of transmission. The message
+ * is given in native byte order, the age is the time in microseconds between the sample and the transmission of the message.
+ * @return True if the message is a valid batched touchpad message of a known version, false otherwise.
+ */
+template <class Callback> bool DecodeBatchMessage(const uint8_t* bytes, size_t length, Callback&& callback){
+    if(length < sizeof(udptouchpad::detail::SerializationBatchHeader)){
+        return false;
+    }
+    udptouchpad::detail::SerializationBatchHeader header;
+    std::memcpy(static_cast<void*>(&header), bytes, sizeof(header));
+    if(0x43 != header.header){
+        return false;
+    }
+    bytes += sizeof(header);
+    length -= sizeof(header);
+    return udptouchpad::detail::DecodeBatchVersion(header, bytes, length, callback);
+}
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
@@ -0,0 +1,31 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief Deadband thresholds for the change detection of touchpad pointer and motion sensor data. A new event is only generated
+ * if a value differs from the value of the last generated event by more than the threshold, so that sensor noise of a resting
+ * device does not generate events. A threshold of zero generates an event for every change.
+ */
+class ChangeThresholds {
+    public:
+        double pointerPosition;   // Threshold for pointer positions in relative device screen coordinates.
+        double aspectRatio;       // Threshold for the aspect ratio of the touch screen.
+        double rotationVector;    // Threshold for each component of the rotation vector.
+        double acceleration;      // Threshold for each component of the acceleration in m/s^2.
+        double angularRate;       // Threshold for each component of the angular rate in rad/s.
+
+        /**
+         * @brief Construct new change thresholds, where all thresholds are zero.
+         */
+        ChangeThresholds(): pointerPosition(0.0), aspectRatio(0.0), rotationVector(0.0), acceleration(0.0), angularRate(0.0) {}
+};
+
+
+} /* namespace: udptouchpad */
+
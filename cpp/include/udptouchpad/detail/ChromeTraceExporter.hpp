@@ -0,0 +1,88 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/Trace.hpp>
+#include <fstream>
+#include <iomanip>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief Exports the trace spans that have been recorded by all threads in the Chrome trace event format (JSON), which can be
+ * opened with chrome://tracing or https://ui.perfetto.dev. Trace spans are only recorded if UDP_TOUCHPAD_ENABLE_TRACING is
+ * defined, otherwise the exported trace is empty.
+ */
+class ChromeTraceExporter {
+    public:
+        /**
+         * @brief Check whether trace spans are recorded or not.
+         * @return True if UDP_TOUCHPAD_ENABLE_TRACING is defined, false otherwise.
+         */
+        static constexpr bool IsTracingEnabled(void){
+            #ifdef UDP_TOUCHPAD_ENABLE_TRACING
+            return true;
+            #else
+            return false;
+            #endif
+        }
+
+        /**
+         * @brief Write all recorded trace spans to a stream.
+         * @param[in] stream The output stream.
+         * @details Each thread keeps the latest UDP_TOUCHPAD_TRACE_BUFFER_CAPACITY spans. Timestamps are given in microseconds
+         * of the steady clock, the argument of a span (e.g. a device ID or a message length) is stored as "value".
+         */
+        static void Write(std::ostream& stream){
+            std::vector<std::tuple<uint32_t, const char*, std::vector<udptouchpad::detail::TraceEvent>>> threads;
+            udptouchpad::detail::TraceRegistry::Get().Read(threads);
+            stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+            const char* separator = "";
+            for(auto&& [threadIndex, threadName, events] : threads){
+                stream << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadIndex << ",\"args\":{\"name\":\"";
+                if(threadName){
+                    stream << threadName;
+                }
+                else{
+                    stream << "thread " << threadIndex;
+                }
+                stream << "\"}}";
+                separator = ",\n";
+                for(auto&& e : events){
+                    stream << separator << "{\"name\":\"" << e.name << "\",\"cat\":\"udptouchpad\",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadIndex;
+                    stream << ",\"ts\":" << (e.begin / 1000) << "." << std::setw(3) << std::setfill('0') << (e.begin % 1000);
+                    stream << ",\"dur\":" << (e.duration / 1000) << "." << std::setw(3) << std::setfill('0') << (e.duration % 1000);
+                    stream << ",\"args\":{\"value\":" << e.argument << "}}";
+                }
+            }
+            stream << "]}\n";
+        }
+
+        /**
+         * @brief Write all recorded trace spans to a file.
+         * @param[in] filename Name of the JSON file to be written.
+         * @return True if success, false otherwise.
+         */
+        static bool Export(const std::string& filename){
+            std::ofstream file(filename);
+            if(!file){
+                return false;
+            }
+            Write(file);
+            file.close();
+            return !file.fail();
+        }
+
+        /**
+         * @brief Discard all trace spans that have been recorded so far.
+         */
+        static void Clear(void){
+            udptouchpad::detail::TraceRegistry::Get().Clear();
+        }
+};
+
+
+} /* namespace: udptouchpad */
+
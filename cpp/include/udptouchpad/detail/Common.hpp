@@ -3,10 +3,19 @@
 
 /* Default C/C++ headers */
 #include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
 #include <string>
+#include <memory>
+#include <new>
 #include <atomic>
 #include <tuple>
 #include <vector>
+#include <list>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -16,6 +25,9 @@
 #include <unordered_map>
 #include <cmath>
 #include <sstream>
+#include <variant>
+#include <coroutine>
+#include <span>
 
 
 /* OS depending */
@@ -29,6 +41,10 @@
 #include <arpa/inet.h>
 #include <net/if.h>
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #else
 #error "Platform is not supported!"
 #endif
@@ -37,5 +53,14 @@
 #define UDP_TOUCHPAD_MULTICAST_GROUP_ADDRESS "239.192.82.74"
 #define UDP_TOUCHPAD_MULTICAST_DESTINATION_PORT (10891)
 #define UDP_TOUCHPAD_REOPEN_SOCKET_RETRY_TIME_MS (1000)
+#define UDP_TOUCHPAD_RECEIVE_BUFFER_SIZE (1048576)
+#define UDP_TOUCHPAD_MAX_RECEIVE_BUFFER_SIZE (8388608)
 #define UDP_TOUCHPAD_DEVICE_DISCONNECT_TIMEOUT_S (1.0)
+#define UDP_TOUCHPAD_PENDING_EVENTS_RESERVE (256)
+#define UDP_TOUCHPAD_MAX_DEVICE_STATES (65536)
+#define UDP_TOUCHPAD_SHARED_MEMORY_MAX_DEVICES (64)
+#define UDP_TOUCHPAD_SHARED_MEMORY_EVENT_CAPACITY (1024)
+#define UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE (1472)
+#define UDP_TOUCHPAD_TRACE_BUFFER_CAPACITY (16384)
+#define UDP_TOUCHPAD_IN_PROCESS_TRANSPORT_CAPACITY (1024)
 
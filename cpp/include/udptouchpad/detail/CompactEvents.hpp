@@ -0,0 +1,204 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/TouchpadPointer.hpp>
+#include <udptouchpad/detail/Events.hpp>
+#include <udptouchpad/detail/DeviceState.hpp>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief Conversion between relative device screen coordinates in [0,1] and the scalar type of a compact layout.
+ * @tparam Scalar The scalar type, either float or uint16_t (16-bit fixed point with a resolution of 1/65535).
+ */
+template <class Scalar> class CompactScalar {
+    static_assert(std::is_same_v<Scalar, float> || std::is_same_v<Scalar, uint16_t>, "Compact layouts support float and uint16_t only!");
+    public:
+        /**
+         * @brief Encode a relative coordinate.
+         * @param[in] value The relative coordinate in [0,1]. Fixed-point values are clamped to this range.
+         * @return The encoded value.
+         */
+        static Scalar Encode(double value){
+            if constexpr(std::is_same_v<Scalar, float>){
+                return static_cast<float>(value);
+            }
+            else{
+                return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0, 1.0) * 65535.0));
+            }
+        }
+
+        /**
+         * @brief Decode a relative coordinate.
+         * @param[in] value The encoded value.
+         * @return The relative coordinate.
+         */
+        static double Decode(Scalar value){
+            if constexpr(std::is_same_v<Scalar, float>){
+                return static_cast<double>(value);
+            }
+            else{
+                return static_cast<double>(value) / 65535.0;
+            }
+        }
+};
+
+
+/**
+ * @brief Compact representation of a @ref TouchpadPointerEvent. Pointer positions are stored with the given scalar type and the
+ * pressed state of all pointers is packed into a bitmask, so that the event is trivially copyable and less than half the size.
+ * @tparam Scalar The scalar type of pointer positions, either float or uint16_t (16-bit fixed point).
+ */
+template <class Scalar> class BasicCompactTouchpadPointerEvent {
+    public:
+        std::chrono::time_point<std::chrono::steady_clock> timestamp;   // Timepoint when the underlying message has been received.
+        uint32_t deviceID;                                              // The device ID, which is equal to the IPv4 address.
+        float aspectRatio;                                              // Aspect ratio of the touch screen, given as width/height.
+        uint16_t pressedMask;                                           // Bit i is set if pointer i is pressed.
+        uint16_t endpoint;                                              // Index of the network endpoint on which the messages of the device are received.
+        std::array<std::array<Scalar,2>,10> startPosition;              // Pointer positions when the pointers were pressed in relative device screen coordinates.
+        std::array<std::array<Scalar,2>,10> position;                   // Current pointer positions in relative device screen coordinates.
+
+        /**
+         * @brief Construct a new compact touchpad pointer event without pressed pointers.
+         */
+        BasicCompactTouchpadPointerEvent(): deviceID(0), aspectRatio(0.0f), pressedMask(0), endpoint(0) {
+            for(size_t i = 0; i < position.size(); ++i){
+                startPosition[i].fill(Scalar(0));
+                position[i].fill(Scalar(0));
+            }
+        }
+
+        /**
+         * @brief Construct a new compact touchpad pointer event from a touchpad pointer event.
+         * @param[in] e The touchpad pointer event to be converted.
+         */
+        explicit BasicCompactTouchpadPointerEvent(const udptouchpad::TouchpadPointerEvent& e): timestamp(e.timestamp), deviceID(e.deviceID), aspectRatio(static_cast<float>(e.aspectRatio)), pressedMask(0), endpoint(e.endpoint) {
+            for(size_t i = 0; i < position.size(); ++i){
+                pressedMask |= static_cast<uint16_t>(e.pointer[i].pressed) << i;
+                for(size_t k = 0; k < 2; ++k){
+                    startPosition[i][k] = udptouchpad::CompactScalar<Scalar>::Encode(e.pointer[i].startPosition[k]);
+                    position[i][k] = udptouchpad::CompactScalar<Scalar>::Encode(e.pointer[i].position[k]);
+                }
+            }
+        }
+
+        /**
+         * @brief Check whether a pointer is pressed.
+         * @param[in] index The index of the pointer in [0,9].
+         * @return True if the pointer is pressed, false otherwise.
+         */
+        bool IsPressed(size_t index) const { return 0 != (pressedMask & (1 << index)); }
+
+        /**
+         * @brief Convert this event to a touchpad pointer event.
+         * @return The touchpad pointer event.
+         */
+        udptouchpad::TouchpadPointerEvent ToTouchpadPointerEvent(void) const {
+            udptouchpad::TouchpadPointerEvent e;
+            e.deviceID = deviceID;
+            e.endpoint = endpoint;
+            e.timestamp = timestamp;
+            e.aspectRatio = static_cast<double>(aspectRatio);
+            for(size_t i = 0; i < position.size(); ++i){
+                e.pointer[i].pressed = IsPressed(i);
+                for(size_t k = 0; k < 2; ++k){
+                    e.pointer[i].startPosition[k] = udptouchpad::CompactScalar<Scalar>::Decode(startPosition[i][k]);
+                    e.pointer[i].position[k] = udptouchpad::CompactScalar<Scalar>::Decode(position[i][k]);
+                }
+            }
+            return e;
+        }
+};
+
+
+/**
+ * @brief Compact representation of a @ref DeviceState. Pointer positions are stored with the given scalar type and the pressed
+ * state of all pointers is packed into a bitmask. Motion sensor data is kept as float, as given by the device.
+ * @tparam Scalar The scalar type of pointer positions, either float or uint16_t (16-bit fixed point).
+ */
+template <class Scalar> class BasicCompactDeviceState {
+    public:
+        std::chrono::time_point<std::chrono::steady_clock> timestampReceive;   // Timepoint when latest message has been received from this device.
+        uint32_t deviceID;                                                     // The device ID, which is equal to the IPv4 address.
+        float aspectRatio;                                                     // Aspect ratio of the touch screen, given as width/height.
+        uint16_t pressedMask;                                                  // Bit i is set if pointer i is pressed.
+        uint16_t endpoint;                                                     // Index of the network endpoint on which the messages of the device are received.
+        uint8_t messageCounter;                                                // Message counter of latest message that has been received from this device.
+        std::array<std::array<Scalar,2>,10> startPosition;                     // Pointer positions when the pointers were pressed in relative device screen coordinates.
+        std::array<std::array<Scalar,2>,10> position;                          // Current pointer positions in relative device screen coordinates.
+        std::array<float,3> rotationVector;                                    // Latest 3D rotation vector sensor data or NaN if no motion sensor is available.
+        std::array<float,3> acceleration;                                      // Latest 3D accelerometer sensor data in m/s^2 or NaN if no motion sensor is available.
+        std::array<float,3> angularRate;                                       // Latest 3D gyroscope sensor data in rad/s or NaN if no motion sensor is available.
+
+        /**
+         * @brief Construct a new compact device state without pressed pointers and without motion sensor data.
+         */
+        BasicCompactDeviceState(): deviceID(0), aspectRatio(0.0f), pressedMask(0), endpoint(0), messageCounter(0) {
+            for(size_t i = 0; i < position.size(); ++i){
+                startPosition[i].fill(Scalar(0));
+                position[i].fill(Scalar(0));
+            }
+            rotationVector.fill(std::numeric_limits<float>::quiet_NaN());
+            acceleration.fill(std::numeric_limits<float>::quiet_NaN());
+            angularRate.fill(std::numeric_limits<float>::quiet_NaN());
+        }
+
+        /**
+         * @brief Construct a new compact device state from a device state.
+         * @param[in] s The device state to be converted.
+         */
+        explicit BasicCompactDeviceState(const udptouchpad::DeviceState& s): timestampReceive(s.timestampReceive), deviceID(s.deviceID), aspectRatio(static_cast<float>(s.aspectRatio)), pressedMask(0), endpoint(s.endpoint), messageCounter(s.messageCounter), rotationVector(s.rotationVector), acceleration(s.acceleration), angularRate(s.angularRate) {
+            for(size_t i = 0; i < position.size(); ++i){
+                pressedMask |= static_cast<uint16_t>(s.pointer[i].pressed) << i;
+                for(size_t k = 0; k < 2; ++k){
+                    startPosition[i][k] = udptouchpad::CompactScalar<Scalar>::Encode(s.pointer[i].startPosition[k]);
+                    position[i][k] = udptouchpad::CompactScalar<Scalar>::Encode(s.pointer[i].position[k]);
+                }
+            }
+        }
+
+        /**
+         * @brief Check whether a pointer is pressed.
+         * @param[in] index The index of the pointer in [0,9].
+         * @return True if the pointer is pressed, false otherwise.
+         */
+        bool IsPressed(size_t index) const { return 0 != (pressedMask & (1 << index)); }
+
+        /**
+         * @brief Convert this state to a device state.
+         * @return The device state.
+         */
+        udptouchpad::DeviceState ToDeviceState(void) const {
+            udptouchpad::DeviceState s;
+            s.deviceID = deviceID;
+            s.endpoint = endpoint;
+            s.messageCounter = messageCounter;
+            s.timestampReceive = timestampReceive;
+            s.aspectRatio = static_cast<double>(aspectRatio);
+            for(size_t i = 0; i < position.size(); ++i){
+                s.pointer[i].pressed = IsPressed(i);
+                for(size_t k = 0; k < 2; ++k){
+                    s.pointer[i].startPosition[k] = udptouchpad::CompactScalar<Scalar>::Decode(startPosition[i][k]);
+                    s.pointer[i].position[k] = udptouchpad::CompactScalar<Scalar>::Decode(position[i][k]);
+                }
+            }
+            s.rotationVector = rotationVector;
+            s.acceleration = acceleration;
+            s.angularRate = angularRate;
+            return s;
+        }
+};
+
+
+using CompactTouchpadPointerEvent = udptouchpad::BasicCompactTouchpadPointerEvent<float>;         // Compact touchpad pointer event with float positions.
+using FixedPointTouchpadPointerEvent = udptouchpad::BasicCompactTouchpadPointerEvent<uint16_t>;   // Compact touchpad pointer event with 16-bit fixed-point positions.
+using CompactDeviceState = udptouchpad::BasicCompactDeviceState<float>;                           // Compact device state with float positions.
+using FixedPointDeviceState = udptouchpad::BasicCompactDeviceState<uint16_t>;                     // Compact device state with 16-bit fixed-point positions.
+
+
+} /* namespace: udptouchpad */
+
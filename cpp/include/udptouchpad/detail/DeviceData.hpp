@@ -5,6 +5,8 @@
 #include <udptouchpad/detail/TouchpadMessage.hpp>
 #include <udptouchpad/detail/TouchpadPointer.hpp>
 #include <udptouchpad/detail/Events.hpp>
+#include <udptouchpad/detail/DeviceState.hpp>
+#include <udptouchpad/detail/RateLimiter.hpp>
 
 
 namespace udptouchpad {
@@ -14,16 +16,16 @@ namespace detail {
 
 
 /**
- * @brief Represent a data entry of the @ref DeviceDatabase.
+ * @brief Represent a data entry of the @ref DeviceDatabase. A source that sends on several endpoints has one entry per endpoint.
  */
 class DeviceData {
     public:
         /* general */
         uint8_t messageCounter;                                                // Message counter of latest message that has been received from this device.
+        uint16_t endpoint;                                                     // Index of the network endpoint on which the messages of this device are received.
         std::chrono::time_point<std::chrono::steady_clock> timestampReceive;   // Timepoint when latest message has been received from this device.
 
         /* motion sensor data */
-        bool newMotionDataAvailable;          // True if new motion data is available, false otherwise.
         std::array<float,3> rotationVector;   // Latest 3D rotation vector sensor data from an onboard motion sensor. If no motion sensor is available, all three values are NaN.
         std::array<float,3> acceleration;     // Latest 3D accelerometer sensor data from an onboard motion sensor in m/s^2. If no motion sensor is available, all three values are NaN.
         std::array<float,3> angularRate;      // Latest 3D gyroscope sensor data from an onboard motion sensor in rad/s. If no motion sensor is available, all three values are NaN.
@@ -32,23 +34,85 @@ class DeviceData {
         double aspectRatio;                                     // Aspect ratio of the touch screen, given as width/height.
         std::array<udptouchpad::TouchpadPointer, 10> pointer;   // List of touch pointers.
 
+        /* data of the last generated events, used as reference for the change detection */
+        std::array<float,3> reportedRotationVector;                     // Rotation vector of the last motion sensor event.
+        std::array<float,3> reportedAcceleration;                       // Acceleration of the last motion sensor event.
+        std::array<float,3> reportedAngularRate;                        // Angular rate of the last motion sensor event.
+        double reportedAspectRatio;                                     // Aspect ratio of the last touchpad pointer event.
+        std::array<udptouchpad::TouchpadPointer, 10> reportedPointer;   // Pointers of the last touchpad pointer event.
+
+        /* output rate limiting */
+        udptouchpad::detail::RateLimiter rateLimiter;   // Coalesces events if a @ref udptouchpad::RateLimit is set.
+
+        /* bookkeeping of the device database, which is kept when new data is received */
+        std::list<uint64_t>::iterator activity;                                 // Position in the list of devices of the database, ordered by the time of the latest message.
+        uint64_t motionEventGeneration;                                         // Generation of the pending events of the database that contain a motion sensor event of this device.
+        size_t motionEventIndex;                                                // Index of the motion sensor event in the pending events, valid for @ref motionEventGeneration.
+        bool rateLimiterScheduled;                                              // True if the rate limiter is scheduled to be emptied at @ref rateLimiterExpiry.
+        std::chrono::time_point<std::chrono::steady_clock> rateLimiterExpiry;   // Time when the rate limiter is to be emptied.
+        uint32_t stateSlot;                                                     // Index of the slot in the device state pool of the database.
+
         /**
          * @brief Construct a new device data object.
          */
-        DeviceData(): messageCounter(0) {
+        DeviceData(): messageCounter(0), endpoint(0), motionEventGeneration(0), motionEventIndex(0), rateLimiterScheduled(false), stateSlot(0xFFFFFFFF) {
             rotationVector.fill(std::numeric_limits<float>::quiet_NaN());
             acceleration.fill(std::numeric_limits<float>::quiet_NaN());
             angularRate.fill(std::numeric_limits<float>::quiet_NaN());
             aspectRatio = 0.0;
-            newMotionDataAvailable = false;
+            UpdateReportedMotionData();
+            UpdateReportedPointerData();
+        }
+
+        /**
+         * @brief Use the current motion sensor data as reference for the change detection.
+         */
+        void UpdateReportedMotionData(void){
+            reportedRotationVector = rotationVector;
+            reportedAcceleration = acceleration;
+            reportedAngularRate = angularRate;
+        }
+
+        /**
+         * @brief Use the current touchpad pointer data as reference for the change detection.
+         */
+        void UpdateReportedPointerData(void){
+            reportedAspectRatio = aspectRatio;
+            reportedPointer = pointer;
+        }
+
+        /**
+         * @brief Copy the reference data for the change detection from other device data.
+         * @param[in] d The device data from which to copy the reference data.
+         */
+        void CopyReportedData(const udptouchpad::detail::DeviceData& d){
+            reportedRotationVector = d.reportedRotationVector;
+            reportedAcceleration = d.reportedAcceleration;
+            reportedAngularRate = d.reportedAngularRate;
+            reportedAspectRatio = d.reportedAspectRatio;
+            reportedPointer = d.reportedPointer;
+        }
+
+        /**
+         * @brief Copy the rate limiter and the bookkeeping of the device database from other device data.
+         * @param[in] d The device data from which to copy the state.
+         */
+        void CopyDatabaseState(const udptouchpad::detail::DeviceData& d){
+            rateLimiter = d.rateLimiter;
+            activity = d.activity;
+            motionEventGeneration = d.motionEventGeneration;
+            motionEventIndex = d.motionEventIndex;
+            rateLimiterScheduled = d.rateLimiterScheduled;
+            rateLimiterExpiry = d.rateLimiterExpiry;
+            stateSlot = d.stateSlot;
         }
 
         /**
          * @brief Measure the elapsed time to the @ref timestampReceive timepoint.
+         * @param[in] timepointNow The current timepoint.
          * @return Time (seconds) to the latest received message.
          */
-        double TimeToLatestReceivedMessage(void){
-            auto timepointNow = std::chrono::steady_clock::now();
+        double TimeToLatestReceivedMessage(const std::chrono::time_point<std::chrono::steady_clock> timepointNow){
             return 1.0e-9 * static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(timepointNow - timestampReceive).count());
         }
 
@@ -60,6 +124,8 @@ class DeviceData {
         udptouchpad::TouchpadPointerEvent ToTouchpadPointerEvent(const uint32_t deviceID){
             udptouchpad::TouchpadPointerEvent event;
             event.deviceID = deviceID;
+            event.endpoint = endpoint;
+            event.timestamp = timestampReceive;
             event.aspectRatio = aspectRatio;
             event.pointer = pointer;
             return event;
@@ -73,6 +139,8 @@ class DeviceData {
         udptouchpad::MotionSensorEvent ToMotionSensorEvent(const uint32_t deviceID){
             udptouchpad::MotionSensorEvent event;
             event.deviceID = deviceID;
+            event.endpoint = endpoint;
+            event.timestamp = timestampReceive;
             event.rotationVector = rotationVector;
             event.acceleration = acceleration;
             event.angularRate = angularRate;
@@ -80,30 +148,22 @@ class DeviceData {
         }
 
         /**
-         * @brief Create a new touchpad pointer event based on this data.
-         * @param[in] deviceID The device ID to be set for the event.
-         * @return A touchpad pointer event built from this device data.
-         */
-        udptouchpad::TouchpadPointerEvent* NewTouchpadPointerEvent(const uint32_t deviceID){
-            udptouchpad::TouchpadPointerEvent* event = new udptouchpad::TouchpadPointerEvent();
-            event->deviceID = deviceID;
-            event->aspectRatio = aspectRatio;
-            event->pointer = pointer;
-            return event;
-        }
-
-        /**
-         * @brief Create a new motion sensor eventbased on this data.
-         * @param[in] deviceID The device ID to be set for the event.
-         * @return A motion sensor event built from this device data.
+         * @brief Convert this data to a device state.
+         * @param[in] deviceID The device ID to be set for the state.
+         * @return A device state built from this device data.
          */
-        udptouchpad::MotionSensorEvent* NewMotionSensorEvent(const uint32_t deviceID){
-            udptouchpad::MotionSensorEvent* event = new udptouchpad::MotionSensorEvent();
-            event->deviceID = deviceID;
-            event->rotationVector = rotationVector;
-            event->acceleration = acceleration;
-            event->angularRate = angularRate;
-            return event;
+        udptouchpad::DeviceState ToDeviceState(const uint32_t deviceID){
+            udptouchpad::DeviceState state;
+            state.deviceID = deviceID;
+            state.endpoint = endpoint;
+            state.messageCounter = messageCounter;
+            state.timestampReceive = timestampReceive;
+            state.aspectRatio = aspectRatio;
+            state.pointer = pointer;
+            state.rotationVector = rotationVector;
+            state.acceleration = acceleration;
+            state.angularRate = angularRate;
+            return state;
         }
 };
 
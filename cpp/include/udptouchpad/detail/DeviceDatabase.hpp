@@ -5,7 +5,16 @@
 #include <udptouchpad/detail/TouchpadMessage.hpp>
 #include <udptouchpad/detail/TouchpadPointer.hpp>
 #include <udptouchpad/detail/Events.hpp>
+#include <udptouchpad/detail/CompactEvents.hpp>
 #include <udptouchpad/detail/DeviceData.hpp>
+#include <udptouchpad/detail/DeviceState.hpp>
+#include <udptouchpad/detail/DeviceStatePool.hpp>
+#include <udptouchpad/detail/EventFilter.hpp>
+#include <udptouchpad/detail/ChangeThresholds.hpp>
+#include <udptouchpad/detail/Statistics.hpp>
+#include <udptouchpad/detail/RateLimit.hpp>
+#include <udptouchpad/detail/SharedMemoryPublisher.hpp>
+#include <udptouchpad/detail/Trace.hpp>
 
 
 namespace udptouchpad {
@@ -14,11 +23,72 @@ namespace udptouchpad {
 namespace detail {
 
 
+/**
+ * @brief A pending event that is stored in the @ref DeviceDatabase until it is fetched. Touchpad pointer events are stored in
+ * their compact form to keep the queue small. Each device has at most one pending motion sensor event without rate limiting,
+ * which is replaced by newer data until events are fetched.
+ */
+using PendingDeviceEvent = std::variant<udptouchpad::DeviceConnectionEvent, udptouchpad::CompactTouchpadPointerEvent, udptouchpad::MotionSensorEvent>;
+
+
+/**
+ * @brief Build the key under which a device is stored in the @ref DeviceDatabase. A source that sends on several endpoints
+ * is stored as a separate device per endpoint.
+ * @param[in] deviceID The ID of the device.
+ * @param[in] endpoint Index of the network endpoint on which the messages of the device are received.
+ * @return The key of the device.
+ */
+inline uint64_t MakeDeviceKey(const uint32_t deviceID, const uint16_t endpoint){
+    return (static_cast<uint64_t>(endpoint) << 32) | static_cast<uint64_t>(deviceID);
+}
+
+
+/**
+ * @brief Get the device ID from the key of a device.
+ * @param[in] key The key of the device, see @ref MakeDeviceKey.
+ * @return The ID of the device.
+ */
+inline uint32_t GetDeviceIDFromKey(const uint64_t key){
+    return static_cast<uint32_t>(key & 0xFFFFFFFF);
+}
+
+
+/**
+ * @brief The events of one call to @ref DeviceDatabase::FetchEvents, partitioned by their type into contiguous arrays. Only the
+ * selected types are collected, the capacity of all arrays is reused.
+ */
+class FetchedEventBatches {
+    public:
+        bool collectDeviceConnection;                                                   // True if device connection events are to be collected.
+        bool collectCompactTouchpadPointer;                                             // True if compact touchpad pointer events are to be collected.
+        bool collectMotionSensor;                                                       // True if motion sensor events are to be collected.
+        std::vector<udptouchpad::DeviceConnectionEvent> deviceConnection;               // Device connection events in the order in which they have been fetched.
+        std::vector<udptouchpad::CompactTouchpadPointerEvent> compactTouchpadPointer;   // Compact touchpad pointer events in the order in which they have been fetched.
+        std::vector<udptouchpad::MotionSensorEvent> motionSensor;                       // Motion sensor events in the order in which they have been fetched.
+
+        /**
+         * @brief Construct new batches, where no event type is collected.
+         */
+        FetchedEventBatches(): collectDeviceConnection(false), collectCompactTouchpadPointer(false), collectMotionSensor(false){}
+};
+
+
 /**
  * @brief Stores all data for motion sensor and touchpad pointer events for all devices.
  */
 class DeviceDatabase {
     public:
+        /**
+         * @brief Construct a new device database.
+         * @details Memory for pending events is reserved in advance, so that no allocation is required in steady state.
+         */
+        DeviceDatabase(): eventGeneration(1), deviceFilter(std::make_shared<const udptouchpad::detail::DeviceFilter>()){
+            sharedDeviceFilter.store(deviceFilter, std::memory_order_release);
+            events.reserve(UDP_TOUCHPAD_PENDING_EVENTS_RESERVE);
+            fetchedEvents.reserve(UDP_TOUCHPAD_PENDING_EVENTS_RESERVE);
+            rateLimiterQueue.reserve(UDP_TOUCHPAD_PENDING_EVENTS_RESERVE);
+        }
+
         /**
          * @brief Destroy the device database.
          */
@@ -27,13 +97,28 @@ class DeviceDatabase {
         /**
          * @brief Push a new message, received from a specific device, to the database.
          * @param[in] deviceID ID of the device, e.g. the source address of the message.
+         * @param[in] endpoint Index of the network endpoint on which the message has been received.
          * @param[in] msg The message that has been received from the specified device.
-         * @details This function is thread-safe.
+         * @param[in] timestamp Time when the message has been received. For batched messages, this is the time of the sample.
+         * @details This function is thread-safe. Messages of rejected devices are discarded before the database lock is taken.
          */
-        void PushNewMessage(const uint32_t deviceID, const udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg){
-            std::lock_guard<std::mutex> lock(mtx);
-            auto it = devices.find(deviceID);
-            if(it != devices.end()){ // deviceID exists
+        void PushNewMessage(const uint32_t deviceID, const uint16_t endpoint, const udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg, const std::chrono::time_point<std::chrono::steady_clock> timestamp){
+            UDP_TOUCHPAD_TRACE_SCOPE("PushNewMessage", deviceID);
+            std::shared_ptr<const udptouchpad::detail::DeviceFilter> f = sharedDeviceFilter.load(std::memory_order_acquire);
+            if(!f->AcceptsDevice(deviceID)){
+                return;
+            }
+            std::unique_lock<std::mutex> lock(mtx, std::defer_lock);
+            {
+                UDP_TOUCHPAD_TRACE_SCOPE("LockDeviceDatabase", 0);
+                lock.lock();
+            }
+            if((f != deviceFilter) && !deviceFilter->AcceptsDevice(deviceID)){
+                return; // the filter has been changed in the meantime
+            }
+            const uint64_t key = udptouchpad::detail::MakeDeviceKey(deviceID, endpoint);
+            auto it = devices.find(key);
+            if(it != devices.end()){ // device exists on this endpoint
                 udptouchpad::detail::DeviceData& device = it->second;
 
                 // discard message if counter is too old
@@ -41,7 +126,7 @@ class DeviceDatabase {
                 if(counterIsOld) return;
 
                 // generate new data
-                udptouchpad::detail::DeviceData newData = GenerateDefaultDeviceData(msg);
+                udptouchpad::detail::DeviceData newData = GenerateDefaultDeviceData(msg, endpoint, timestamp);
 
                 // set start position for pointers that are pressed the first time
                 for(size_t i = 0; i < newData.pointer.size(); ++i){
@@ -54,77 +139,310 @@ class DeviceDatabase {
                     }
                 }
 
-                // check if new data is available
-                auto [newPointerData, newMotionData] = DetectDataChange(newData, device);
-                newData.newMotionDataAvailable = device.newMotionDataAvailable || (newMotionData && MotionSensorDataIsFinite(newData));
+                // check if new data is available, changes within the deadband of the thresholds are suppressed, a message is
+                // only counted as suppressed if its data differs from the data of the previous message
+                newData.CopyReportedData(device);
+                DataChange change = DetectDataChange(newData, device, thresholds);
+                bool newPointerData = change.pointer;
+                bool newMotionData = change.motion;
+                bool acceptPointer = filter.AcceptsEventType(udptouchpad::event_mask_touchpad_pointer);
+                bool acceptMotion = filter.AcceptsEventType(udptouchpad::event_mask_motion_sensor) && MotionSensorDataIsFinite(newData);
+                statistics.suppressedTouchpadPointerEvents += static_cast<uint64_t>(acceptPointer && change.previousPointer && !newPointerData);
+                statistics.suppressedMotionSensorEvents += static_cast<uint64_t>(acceptMotion && change.previousMotion && !newMotionData);
+                if(newPointerData){
+                    newData.UpdateReportedPointerData();
+                }
+                if(newMotionData){
+                    newData.UpdateReportedMotionData();
+                }
 
-                // update device data and add events
+                // update device data and move the device to the end of the activity list
+                newData.CopyDatabaseState(device);
                 device = newData;
-                if(newPointerData){
-                    events.push_back(reinterpret_cast<udptouchpad::detail::EventBase*>(device.NewTouchpadPointerEvent(deviceID)));
+                activity.splice(activity.end(), activity, device.activity);
+
+                // add events, the output of the rate limiter is added as soon as a message arrives after the window has
+                // expired, windows of devices that stop sending are emptied by FetchEvents
+                const udptouchpad::RateLimit& limit = GetRateLimit(deviceID);
+                if(newPointerData && acceptPointer){
+                    if(limit.IsEnabled()){
+                        size_t n = device.rateLimiter.PushTouchpadPointer(device.ToTouchpadPointerEvent(deviceID), limit, pointerEvents, statistics.coalescedTouchpadPointerEvents);
+                        for(size_t i = 0; i < n; ++i){
+                            events.push_back(udptouchpad::CompactTouchpadPointerEvent(pointerEvents[i]));
+                        }
+                    }
+                    else{
+                        events.push_back(udptouchpad::CompactTouchpadPointerEvent(device.ToTouchpadPointerEvent(deviceID)));
+                    }
+                }
+                if(newMotionData && acceptMotion){
+                    if(limit.IsEnabled()){
+                        device.rateLimiter.PushMotionSensor(device.ToMotionSensorEvent(deviceID));
+                        size_t n = device.rateLimiter.PopMotionSensor(timestamp, limit, motionEvents, statistics.coalescedMotionSensorEvents);
+                        for(size_t i = 0; i < n; ++i){
+                            events.push_back(motionEvents[i]);
+                        }
+                    }
+                    else{
+                        PushMotionSensorSnapshot(deviceID, device);
+                    }
                 }
+                if(limit.IsEnabled()){
+                    ScheduleRateLimiter(key, device, limit);
+                }
+                PublishDeviceState(device, device.ToDeviceState(deviceID));
             }
-            else{ // deviceID does not exist
-                udptouchpad::detail::DeviceData newData = GenerateDefaultDeviceData(msg);
-                devices.insert(std::make_pair(deviceID, newData));
-                events.push_back(reinterpret_cast<udptouchpad::detail::EventBase*>(new udptouchpad::DeviceConnectionEvent(deviceID, true)));
+            else{ // device does not exist on this endpoint
+                udptouchpad::detail::DeviceData newData = GenerateDefaultDeviceData(msg, endpoint, timestamp);
+                newData.UpdateReportedPointerData();
+                newData.UpdateReportedMotionData();
+                newData.activity = activity.insert(activity.end(), key);
+                newData.stateSlot = statePool.Allocate();
+                statistics.missingDeviceStates += static_cast<uint64_t>(udptouchpad::detail::DeviceStatePool::invalidSlot == newData.stateSlot);
+                devices.insert(std::make_pair(key, newData));
+                if(filter.AcceptsEventType(udptouchpad::event_mask_connection)){
+                    events.push_back(udptouchpad::DeviceConnectionEvent(deviceID, true, newData.timestampReceive, endpoint));
+                }
+                PublishDeviceState(newData, newData.ToDeviceState(deviceID));
             }
         }
 
         /**
          * @brief Fetch new events from the device database and run callback functions.
          * @param[in] fDeviceConnection The function to be called for device connection events.
-         * @param[in] fTouchpadPointer The function to be called for touchpad pointer events.
+         * @param[in] fTouchpadPointer The function to be called for touchpad pointer events, given in their compact form.
          * @param[in] fMotionSensor The function to be called for motion sensor events.
-         * @details This function is thread-safe.
+         * @param[in] timepointNow The timepoint at which connection timeouts and rate limits are evaluated. Offline processing
+         * of recorded messages passes the recorded time instead of the current time.
+         * @param[inout] batches Batches to which the fetched events of the selected types are appended in the same pass in which
+         * the callbacks are run or nullptr. Callbacks that are empty are skipped.
+         * @details This function is thread-safe. No memory is allocated as long as no device connects. Pending events are
+         * swapped out of the database and all callbacks are run without holding the database lock, so that slow callbacks
+         * never block @ref PushNewMessage. While the lock is held, only devices that have timed out and rate limiters whose
+         * window has expired are visited, the work does not depend on the number of connected devices.
          */
-        void FetchEvents(std::function<void(udptouchpad::DeviceConnectionEvent)> fDeviceConnection, std::function<void(udptouchpad::TouchpadPointerEvent)> fTouchpadPointer, std::function<void(udptouchpad::MotionSensorEvent)> fMotionSensor){
-            std::lock_guard<std::mutex> lock(mtx);
+        void FetchEvents(const std::function<void(udptouchpad::DeviceConnectionEvent)>& fDeviceConnection, const std::function<void(const udptouchpad::CompactTouchpadPointerEvent&)>& fTouchpadPointer, const std::function<void(udptouchpad::MotionSensorEvent)>& fMotionSensor, const std::chrono::time_point<std::chrono::steady_clock> timepointNow = std::chrono::steady_clock::now(), udptouchpad::detail::FetchedEventBatches* batches = nullptr){
+            UDP_TOUCHPAD_TRACE_SCOPE("FetchEvents", 0);
+            const std::lock_guard<std::mutex> fetchLock(fetchMutex);
+            std::shared_ptr<udptouchpad::detail::SharedMemoryPublisher> fetchPublisher;
+            {
+                std::unique_lock<std::mutex> lock(mtx, std::defer_lock);
+                {
+                    UDP_TOUCHPAD_TRACE_SCOPE("LockDeviceDatabase", 0);
+                    lock.lock();
+                }
 
-            // fetch all connection and touchpad events, insert them to output and delete them from the internal events container
-            for(auto&& e : events){
-                switch(e->GetType()){
-                    case udptouchpad::detail::event_type_connection:
-                        if(fDeviceConnection){
-                            fDeviceConnection(*reinterpret_cast<udptouchpad::DeviceConnectionEvent*>(e));
-                        }
-                        break;
-                    case udptouchpad::detail::event_type_touchpad_pointer:
-                        if(fTouchpadPointer){
-                            fTouchpadPointer(*reinterpret_cast<udptouchpad::TouchpadPointerEvent*>(e));
-                        }
-                        break;
-                    case udptouchpad::detail::event_type_motion_sensor:
-                        // is not fired here
-                        break;
-                    case udptouchpad::detail::event_type_error:
-                        // is not fired here
+                // swap out all pending events, the receive thread continues with the empty container of the previous fetch
+                // and starts new motion sensor snapshots
+                fetchedEvents.clear();
+                fetchedEvents.swap(events);
+                eventGeneration++;
+                fetchPublisher = publisher;
+
+                // disconnect devices that have timed out, which are at the front of the activity list
+                while(!activity.empty()){
+                    auto it = devices.find(activity.front());
+                    if(it->second.TimeToLatestReceivedMessage(timepointNow) <= UDP_TOUCHPAD_DEVICE_DISCONNECT_TIMEOUT_S){
                         break;
+                    }
+                    (void) RemoveDevice(it, timepointNow, fetchedEvents);
+                }
+
+                // empty all rate limiters whose window has expired
+                while(!rateLimiterQueue.empty() && (rateLimiterQueue.front().first <= timepointNow)){
+                    std::pop_heap(rateLimiterQueue.begin(), rateLimiterQueue.end(), std::greater<>());
+                    auto [expiry, key] = rateLimiterQueue.back();
+                    rateLimiterQueue.pop_back();
+                    auto it = devices.find(key);
+                    if((it == devices.end()) || !it->second.rateLimiterScheduled || (it->second.rateLimiterExpiry != expiry)){
+                        continue; // the device has been removed or rescheduled
+                    }
+                    udptouchpad::detail::DeviceData& device = it->second;
+                    device.rateLimiterScheduled = false;
+                    const udptouchpad::RateLimit& limit = GetRateLimit(udptouchpad::detail::GetDeviceIDFromKey(key));
+                    if(device.rateLimiter.PopTouchpadPointer(timepointNow, limit, pointerEvents[0], statistics.coalescedTouchpadPointerEvents)){
+                        fetchedEvents.push_back(udptouchpad::CompactTouchpadPointerEvent(pointerEvents[0]));
+                    }
+                    size_t numMotionEvents = device.rateLimiter.PopMotionSensor(timepointNow, limit, motionEvents, statistics.coalescedMotionSensorEvents);
+                    for(size_t i = 0; i < numMotionEvents; ++i){
+                        fetchedEvents.push_back(motionEvents[i]);
+                    }
+                    ScheduleRateLimiter(key, device, limit);
                 }
-                delete e;
             }
-            events.clear();
 
-            // check connection status and fetch new motion sensor events
-            for(auto it = devices.begin(); it != devices.end();){
-                if(it->second.TimeToLatestReceivedMessage() > UDP_TOUCHPAD_DEVICE_DISCONNECT_TIMEOUT_S){
+            // publish the fetched events, run callbacks and partition the events into batches without holding the database lock
+            const bool collectDeviceConnection = batches && batches->collectDeviceConnection;
+            const bool collectCompactTouchpadPointer = batches && batches->collectCompactTouchpadPointer;
+            const bool collectMotionSensor = batches && batches->collectMotionSensor;
+            for(auto&& e : fetchedEvents){
+                if(auto connectionEvent = std::get_if<udptouchpad::DeviceConnectionEvent>(&e)){
+                    if(fetchPublisher){
+                        fetchPublisher->PublishEvent(*connectionEvent);
+                    }
                     if(fDeviceConnection){
-                        fDeviceConnection(udptouchpad::DeviceConnectionEvent(it->first, false));
+                        fDeviceConnection(*connectionEvent);
+                    }
+                    if(collectDeviceConnection){
+                        batches->deviceConnection.push_back(*connectionEvent);
                     }
-                    it = devices.erase(it);
                 }
-                else{
-                    if(it->second.newMotionDataAvailable){
-                        it->second.newMotionDataAvailable = false;
-                        if(fMotionSensor){
-                            fMotionSensor(it->second.ToMotionSensorEvent(it->first));
-                        }
+                else if(auto touchpadPointerEvent = std::get_if<udptouchpad::CompactTouchpadPointerEvent>(&e)){
+                    if(fetchPublisher){
+                        fetchPublisher->PublishEvent(touchpadPointerEvent->ToTouchpadPointerEvent());
+                    }
+                    if(fTouchpadPointer){
+                        fTouchpadPointer(*touchpadPointerEvent);
+                    }
+                    if(collectCompactTouchpadPointer){
+                        batches->compactTouchpadPointer.push_back(*touchpadPointerEvent);
                     }
-                    it++;
                 }
+                else if(auto motionSensorEvent = std::get_if<udptouchpad::MotionSensorEvent>(&e)){
+                    if(fetchPublisher){
+                        fetchPublisher->PublishEvent(*motionSensorEvent);
+                    }
+                    if(fMotionSensor){
+                        fMotionSensor(*motionSensorEvent);
+                    }
+                    if(collectMotionSensor){
+                        batches->motionSensor.push_back(*motionSensorEvent);
+                    }
+                }
+            }
+            fetchedEvents.clear();
+        }
+
+        /**
+         * @brief Set the publisher to which all device states and events are written in addition.
+         * @param[in] p The publisher that has already been opened or nullptr to disable publishing. All devices that are
+         * currently stored in the database are published immediately.
+         * @details This function is thread-safe but must not be called from within a callback of @ref FetchEvents. It waits
+         * for a running @ref FetchEvents to complete, so that the previous publisher has no writer left when it is released.
+         */
+        void SetPublisher(std::unique_ptr<udptouchpad::detail::SharedMemoryPublisher> p){
+            const std::lock_guard<std::mutex> fetchLock(fetchMutex);
+            std::lock_guard<std::mutex> lock(mtx);
+            publisher = std::move(p);
+            if(publisher){
+                for(auto&& [key, device] : devices){
+                    publisher->PublishDeviceState(device.ToDeviceState(udptouchpad::detail::GetDeviceIDFromKey(key)));
+                }
+            }
+        }
+
+        /**
+         * @brief Set the filter that selects the devices, event types and screen region to be processed.
+         * @param[in] f The new filter. Devices that are connected but not accepted by the new filter are removed and a
+         * disconnection event is generated for them.
+         * @details This function is thread-safe.
+         */
+        void SetFilter(const udptouchpad::EventFilter& f){
+            std::shared_ptr<const udptouchpad::detail::DeviceFilter> newDeviceFilter = std::make_shared<const udptouchpad::detail::DeviceFilter>(f);
+            std::lock_guard<std::mutex> lock(mtx);
+            filter = f;
+            deviceFilter = newDeviceFilter;
+            sharedDeviceFilter.store(newDeviceFilter, std::memory_order_release);
+            for(auto it = devices.begin(); it != devices.end();){
+                it = deviceFilter->AcceptsDevice(udptouchpad::detail::GetDeviceIDFromKey(it->first)) ? std::next(it) : RemoveDevice(it, std::chrono::steady_clock::now(), events);
             }
         }
 
+        /**
+         * @brief Set the deadband thresholds for the change detection.
+         * @param[in] t The new thresholds.
+         * @details This function is thread-safe.
+         */
+        void SetChangeThresholds(const udptouchpad::ChangeThresholds& t){
+            std::lock_guard<std::mutex> lock(mtx);
+            thresholds = t;
+        }
+
+        /**
+         * @brief Set the rate limit for all devices that have no device-specific rate limit.
+         * @param[in] limit The new rate limit.
+         * @details This function is thread-safe.
+         */
+        void SetRateLimit(const udptouchpad::RateLimit& limit){
+            std::lock_guard<std::mutex> lock(mtx);
+            rateLimit = limit;
+        }
+
+        /**
+         * @brief Set the rate limit for a specific device, which overrides the rate limit for all devices.
+         * @param[in] deviceID The ID of the device.
+         * @param[in] limit The new rate limit for the device.
+         * @details This function is thread-safe.
+         */
+        void SetDeviceRateLimit(const uint32_t deviceID, const udptouchpad::RateLimit& limit){
+            std::lock_guard<std::mutex> lock(mtx);
+            deviceRateLimits[deviceID] = limit;
+        }
+
+        /**
+         * @brief Remove the rate limit of a specific device, so that the rate limit for all devices applies again.
+         * @param[in] deviceID The ID of the device.
+         * @details This function is thread-safe.
+         */
+        void ResetDeviceRateLimit(const uint32_t deviceID){
+            std::lock_guard<std::mutex> lock(mtx);
+            deviceRateLimits.erase(deviceID);
+        }
+
+        /**
+         * @brief Get the statistics of the database.
+         * @return A copy of the current statistics.
+         * @details This function is thread-safe.
+         */
+        udptouchpad::Statistics GetStatistics(void){
+            std::lock_guard<std::mutex> lock(mtx);
+            return statistics;
+        }
+
+        /**
+         * @brief Count datagrams that have been dropped by the kernel in the statistics.
+         * @param[in] numDropped Number of datagrams that have been dropped, because the receive buffer was full.
+         * @param[in] numRejected Number of datagrams that have been rejected by the kernel filter.
+         * @details This function is thread-safe.
+         */
+        void CountDroppedDatagrams(const uint64_t numDropped, const uint64_t numRejected){
+            std::lock_guard<std::mutex> lock(mtx);
+            statistics.droppedDatagrams += numDropped;
+            statistics.rejectedDatagrams += numRejected;
+        }
+
+        /**
+         * @brief Get the latest state of a connected device.
+         * @param[in] deviceID The ID of the device.
+         * @param[out] state The latest state of the device. If the device sends on several endpoints, this is the state of any of them.
+         * @return True if the device is connected, false otherwise.
+         * @details This function is thread-safe. It does not take the database lock and never blocks @ref PushNewMessage.
+         */
+        bool GetDeviceState(const uint32_t deviceID, udptouchpad::DeviceState& state){
+            return statePool.Load(deviceID, state);
+        }
+
+        /**
+         * @brief Get the latest state of a device that is connected on a specific endpoint.
+         * @param[in] deviceID The ID of the device.
+         * @param[in] endpoint Index of the network endpoint on which the messages of the device are received.
+         * @param[out] state The latest state of the device.
+         * @return True if the device is connected on the endpoint, false otherwise.
+         * @details This function is thread-safe. It does not take the database lock and never blocks @ref PushNewMessage.
+         */
+        bool GetDeviceState(const uint32_t deviceID, const uint16_t endpoint, udptouchpad::DeviceState& state){
+            return statePool.Load(deviceID, endpoint, state);
+        }
+
+        /**
+         * @brief Get the latest states of all connected devices.
+         * @param[out] states Container where to store the device states. The container is cleared first, its capacity is reused.
+         * @details This function is thread-safe. It does not take the database lock and never blocks @ref PushNewMessage.
+         */
+        void GetAllDeviceStates(std::vector<udptouchpad::DeviceState>& states){
+            statePool.LoadAll(states);
+        }
+
         /**
          * @brief Clear the database and remove all events.
          * @details This function is thread-safe.
@@ -132,56 +450,197 @@ class DeviceDatabase {
         void Clear(void){
             std::lock_guard<std::mutex> lock(mtx);
             devices.clear();
-            for(auto&& e : events){
-                delete e;
-            }
+            activity.clear();
+            rateLimiterQueue.clear();
             events.clear();
+            eventGeneration++;
+            statistics = udptouchpad::Statistics();
+            statePool.ReleaseAll();
+            if(publisher){
+                publisher->RemoveAllDevices();
+            }
         }
 
     private:
-        std::unordered_map<uint32_t, udptouchpad::detail::DeviceData> devices;   // Internal data storage for all devices.
-        std::vector<udptouchpad::detail::EventBase*> events;                     // Stores connection and touchpad pointer events.
-        std::mutex mtx;                                                          // Protect @ref devices and @ref events.
+        /**
+         * @brief Result of the change detection of one message.
+         */
+        struct DataChange {
+            bool pointer;           // True if touchpad pointer data differs from the last touchpad pointer event by more than the thresholds.
+            bool motion;            // True if motion sensor data differs from the last motion sensor event by more than the thresholds.
+            bool previousPointer;   // True if touchpad pointer data differs from the previous message.
+            bool previousMotion;    // True if motion sensor data differs from the previous message.
+        };
+
+        std::unordered_map<uint64_t, udptouchpad::detail::DeviceData> devices;                                   // Internal data storage for all devices, see @ref MakeDeviceKey for the keys.
+        std::list<uint64_t> activity;                                                                            // Keys of all devices, ordered by the time of their latest message (oldest first).
+        std::vector<std::pair<std::chrono::time_point<std::chrono::steady_clock>, uint64_t>> rateLimiterQueue;   // Min-heap of the expiry times of rate limiters that contain events together with the device keys.
+        std::vector<udptouchpad::detail::PendingDeviceEvent> events;                                             // Pending events, filled by the receive thread.
+        std::vector<udptouchpad::detail::PendingDeviceEvent> fetchedEvents;                                      // Events that have been swapped out by @ref FetchEvents and are delivered without holding @ref mtx.
+        uint64_t eventGeneration;                                                                                // Incremented whenever @ref events is swapped out or cleared, invalidates the motion sensor snapshots of all devices.
+        std::shared_ptr<udptouchpad::detail::SharedMemoryPublisher> publisher;                                   // Optional publisher for device states and events, shared with a running @ref FetchEvents.
+        udptouchpad::EventFilter filter;                                                                         // Selects the event types and screen region to be processed.
+        std::shared_ptr<const udptouchpad::detail::DeviceFilter> deviceFilter;                                   // Selects the devices to be processed, built from @ref filter.
+        std::atomic<std::shared_ptr<const udptouchpad::detail::DeviceFilter>> sharedDeviceFilter;                // Copy of @ref deviceFilter that is checked before @ref mtx is taken.
+        udptouchpad::ChangeThresholds thresholds;                                                                // Deadband thresholds for the change detection.
+        udptouchpad::RateLimit rateLimit;                                                                        // Rate limit for all devices without a device-specific rate limit.
+        std::unordered_map<uint32_t, udptouchpad::RateLimit> deviceRateLimits;                                   // Device-specific rate limits.
+        std::array<udptouchpad::TouchpadPointerEvent,2> pointerEvents;                                           // Scratch buffer for touchpad pointer events emitted by a rate limiter.
+        std::array<udptouchpad::MotionSensorEvent,2> motionEvents;                                               // Scratch buffer for motion sensor events emitted by a rate limiter.
+        udptouchpad::Statistics statistics;                                                                      // Statistics about suppressed and coalesced events.
+        udptouchpad::detail::DeviceStatePool statePool;                                                          // Latest state of each device, readable without taking @ref mtx.
+        std::mutex mtx;                                                                                          // Protect all members except the slots of @ref statePool and @ref fetchedEvents.
+        std::mutex fetchMutex;                                                                                   // Serializes @ref FetchEvents and protects @ref fetchedEvents.
+
+        /**
+         * @brief Store the latest state of a device to its slot and the publisher.
+         * @param[in] device The data of the device.
+         * @param[in] state The latest state of the device.
+         */
+        void PublishDeviceState(const udptouchpad::detail::DeviceData& device, const udptouchpad::DeviceState& state){
+            statePool.Store(device.stateSlot, state);
+            if(publisher){
+                publisher->PublishDeviceState(state);
+            }
+        }
+
+        /**
+         * @brief Remove a device from the database.
+         * @param[in] it Iterator to the device to be removed.
+         * @param[in] timestamp Time of the disconnection event.
+         * @param[inout] destination The container to which the disconnection event is added if connection events are accepted.
+         * @return Iterator to the device that follows the removed device.
+         */
+        std::unordered_map<uint64_t, udptouchpad::detail::DeviceData>::iterator RemoveDevice(std::unordered_map<uint64_t, udptouchpad::detail::DeviceData>::iterator it, const std::chrono::time_point<std::chrono::steady_clock> timestamp, std::vector<udptouchpad::detail::PendingDeviceEvent>& destination){
+            const uint32_t deviceID = udptouchpad::detail::GetDeviceIDFromKey(it->first);
+            if(filter.AcceptsEventType(udptouchpad::event_mask_connection)){
+                destination.push_back(udptouchpad::DeviceConnectionEvent(deviceID, false, timestamp, it->second.endpoint));
+            }
+            statePool.Release(it->second.stateSlot);
+            if(publisher){
+                publisher->RemoveDevice(deviceID, it->second.endpoint);
+            }
+            activity.erase(it->second.activity);
+            return devices.erase(it);
+        }
+
+        /**
+         * @brief Add a motion sensor event with the latest data of a device to the pending events. If the pending events
+         * already contain a motion sensor event of the device, it is replaced, so that at most one motion sensor event per
+         * device is fetched at once.
+         * @param[in] deviceID The ID of the device.
+         * @param[inout] device The data of the device.
+         */
+        void PushMotionSensorSnapshot(const uint32_t deviceID, udptouchpad::detail::DeviceData& device){
+            if(device.motionEventGeneration == eventGeneration){
+                events[device.motionEventIndex] = device.ToMotionSensorEvent(deviceID);
+                return;
+            }
+            device.motionEventGeneration = eventGeneration;
+            device.motionEventIndex = events.size();
+            events.push_back(device.ToMotionSensorEvent(deviceID));
+        }
+
+        /**
+         * @brief Schedule the rate limiter of a device to be emptied by @ref FetchEvents as soon as its window expires.
+         * @param[in] key The key of the device, see @ref MakeDeviceKey.
+         * @param[inout] device The data of the device.
+         * @param[in] limit The rate limit of the device.
+         * @details Nothing happens if the rate limiter is empty or has already been scheduled.
+         */
+        void ScheduleRateLimiter(const uint64_t key, udptouchpad::detail::DeviceData& device, const udptouchpad::RateLimit& limit){
+            if(device.rateLimiterScheduled || !device.rateLimiter.GetExpiry(limit, device.rateLimiterExpiry)){
+                return;
+            }
+            device.rateLimiterScheduled = true;
+            rateLimiterQueue.push_back(std::make_pair(device.rateLimiterExpiry, key));
+            std::push_heap(rateLimiterQueue.begin(), rateLimiterQueue.end(), std::greater<>());
+        }
+
+        /**
+         * @brief Get the rate limit that applies to a device.
+         * @param[in] deviceID The ID of the device.
+         * @return The device-specific rate limit if set, otherwise the rate limit for all devices.
+         */
+        const udptouchpad::RateLimit& GetRateLimit(const uint32_t deviceID){
+            auto it = deviceRateLimits.find(deviceID);
+            return (it != deviceRateLimits.end()) ? it->second : rateLimit;
+        }
 
         /**
          * @brief Generate default device data based on a received message.
          * @param[in] msg The message from which to generate the device data.
-         * @return Generated device data, where the timestamp is set to the current time and the start position for all pointers is equal to their position.
+         * @param[in] endpoint Index of the network endpoint on which the message has been received.
+         * @param[in] timestamp Time when the message has been received.
+         * @return Generated device data, where the start position for all pointers is equal to their position.
          */
-        udptouchpad::detail::DeviceData GenerateDefaultDeviceData(const udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg){
+        udptouchpad::detail::DeviceData GenerateDefaultDeviceData(const udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg, const uint16_t endpoint, const std::chrono::time_point<std::chrono::steady_clock> timestamp){
             udptouchpad::detail::DeviceData result;
             result.messageCounter = msg.counter;
-            result.timestampReceive = std::chrono::steady_clock::now();
-            result.newMotionDataAvailable = false;
+            result.endpoint = endpoint;
+            result.timestampReceive = timestamp;
             result.rotationVector = msg.rotationVector;
             result.acceleration = msg.acceleration;
             result.angularRate = msg.angularRate;
             result.aspectRatio = static_cast<double>(msg.screenWidth) / static_cast<double>(msg.screenHeight);
             for(size_t i = 0; (i < msg.pointerID.size()) && (i < msg.pointerPosition.size()); ++i){
                 if(msg.pointerID[i] >= 10) continue;
+                std::array<double,2> position;
+                position[0] = static_cast<double>(msg.pointerPosition[i][0]) / static_cast<double>(msg.screenWidth);
+                position[1] = static_cast<double>(msg.pointerPosition[i][1]) / static_cast<double>(msg.screenHeight);
+                if(!filter.AcceptsPosition(position)) continue; // pointers outside the screen region are treated as not pressed
                 result.pointer[msg.pointerID[i]].pressed = true;
-                result.pointer[msg.pointerID[i]].position[0] = static_cast<double>(msg.pointerPosition[i][0]) / static_cast<double>(msg.screenWidth);
-                result.pointer[msg.pointerID[i]].position[1] = static_cast<double>(msg.pointerPosition[i][1]) / static_cast<double>(msg.screenHeight);
-                result.pointer[msg.pointerID[i]].startPosition = result.pointer[msg.pointerID[i]].position;
+                result.pointer[msg.pointerID[i]].position = position;
+                result.pointer[msg.pointerID[i]].startPosition = position;
             }
             return result;
         }
 
         /**
-         * @brief Check whether there are changes in touchpad pointer and motion sensor data values.
-         * @param[in] a First device data to compare.
-         * @param[in] b Second device data to compare.
-         * @return Two flags indicating if touchpad pointer data (<0>) and/or motion sensor data (<1>) is different.
+         * @brief Check whether the current touchpad pointer and motion sensor data values differ from the values of the last
+         * generated events by more than the given thresholds and whether they differ from the values of the previous message.
+         * @param[in] d Device data containing current and reported values.
+         * @param[in] previous Device data of the previous message.
+         * @param[in] t The deadband thresholds. If all thresholds are zero, any change is detected.
+         * @return Flags indicating which data is different.
          */
-        std::tuple<bool, bool> DetectDataChange(const udptouchpad::detail::DeviceData& a, const udptouchpad::detail::DeviceData& b){
-            bool pointerDataChanged = (a.aspectRatio != b.aspectRatio);
-            for(size_t i = 0; i < a.pointer.size(); ++i){
-                pointerDataChanged |= !a.pointer[i].IsEqual(b.pointer[i]);
+        DataChange DetectDataChange(const udptouchpad::detail::DeviceData& d, const udptouchpad::detail::DeviceData& previous, const udptouchpad::ChangeThresholds& t){
+            DataChange change;
+            change.pointer = Exceeds(d.aspectRatio, d.reportedAspectRatio, t.aspectRatio);
+            change.previousPointer = (d.aspectRatio != previous.aspectRatio);
+            for(size_t i = 0; i < d.pointer.size(); ++i){
+                const udptouchpad::TouchpadPointer& a = d.pointer[i];
+                const udptouchpad::TouchpadPointer& b = d.reportedPointer[i];
+                const udptouchpad::TouchpadPointer& c = previous.pointer[i];
+                change.pointer |= (a.pressed != b.pressed);
+                change.pointer |= Exceeds(a.startPosition[0], b.startPosition[0], t.pointerPosition) || Exceeds(a.startPosition[1], b.startPosition[1], t.pointerPosition);
+                change.pointer |= Exceeds(a.position[0], b.position[0], t.pointerPosition) || Exceeds(a.position[1], b.position[1], t.pointerPosition);
+                change.previousPointer |= (a.pressed != c.pressed);
+                change.previousPointer |= (a.startPosition[0] != c.startPosition[0]) || (a.startPosition[1] != c.startPosition[1]);
+                change.previousPointer |= (a.position[0] != c.position[0]) || (a.position[1] != c.position[1]);
             }
-            bool motionDataChanged = (a.rotationVector[0] != b.rotationVector[0]) || (a.rotationVector[1] != b.rotationVector[1]) || (a.rotationVector[2] != b.rotationVector[2]);
-            motionDataChanged |= (a.acceleration[0] != b.acceleration[0]) || (a.acceleration[1] != b.acceleration[1]) || (a.acceleration[2] != b.acceleration[2]);
-            motionDataChanged |= (a.angularRate[0] != b.angularRate[0]) || (a.angularRate[1] != b.angularRate[1]) || (a.angularRate[2] != b.angularRate[2]);
-            return std::make_tuple(pointerDataChanged, motionDataChanged);
+            change.motion = false;
+            change.previousMotion = false;
+            for(size_t i = 0; i < 3; ++i){
+                change.motion |= Exceeds(d.rotationVector[i], d.reportedRotationVector[i], t.rotationVector);
+                change.motion |= Exceeds(d.acceleration[i], d.reportedAcceleration[i], t.acceleration);
+                change.motion |= Exceeds(d.angularRate[i], d.reportedAngularRate[i], t.angularRate);
+                change.previousMotion |= (d.rotationVector[i] != previous.rotationVector[i]);
+                change.previousMotion |= (d.acceleration[i] != previous.acceleration[i]);
+                change.previousMotion |= (d.angularRate[i] != previous.angularRate[i]);
+            }
+            return change;
+        }
+
+        /**
+         * @brief Check whether two values differ by more than a threshold.
+         * @param[in] a First value.
+         * @param[in] b Second value.
+         * @param[in] threshold The threshold. If zero, any difference is detected.
+         * @return True if the values differ by more than the threshold, false otherwise. NaN values always differ.
+         */
+        static bool Exceeds(const double a, const double b, const double threshold){
+            return (a != b) && !(std::fabs(a - b) <= threshold);
         }
 
         /**
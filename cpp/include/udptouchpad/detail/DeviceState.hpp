@@ -0,0 +1,87 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/TouchpadPointer.hpp>
+#include <udptouchpad/detail/Events.hpp>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief Represents the latest known state of one device, including touchpad pointer and motion sensor data.
+ * @details This class is trivially copyable, so that it can be exchanged via sequence locks and shared memory.
+ */
+class DeviceState {
+    public:
+        uint32_t deviceID;                                                     // The device ID, which is equal to the IPv4 address.
+        uint8_t messageCounter;                                                // Message counter of latest message that has been received from this device.
+        uint16_t endpoint;                                                     // Index of the network endpoint on which the messages of the device are received, see @ref NetworkConfiguration::endpoints.
+        std::chrono::time_point<std::chrono::steady_clock> timestampReceive;   // Timepoint when latest message has been received from this device.
+        double aspectRatio;                                                    // Aspect ratio of the touch screen, given as width/height.
+        std::array<TouchpadPointer, 10> pointer;                               // List of touch pointers.
+        std::array<float,3> rotationVector;                                    // Latest 3D rotation vector sensor data from an onboard motion sensor. If no motion sensor is available, all three values are NaN.
+        std::array<float,3> acceleration;                                      // Latest 3D accelerometer sensor data from an onboard motion sensor in m/s^2. If no motion sensor is available, all three values are NaN.
+        std::array<float,3> angularRate;                                       // Latest 3D gyroscope sensor data from an onboard motion sensor in rad/s. If no motion sensor is available, all three values are NaN.
+
+        /**
+         * @brief Construct a new device state.
+         */
+        DeviceState(): deviceID(0), messageCounter(0), endpoint(0), aspectRatio(0.0) {
+            rotationVector.fill(std::numeric_limits<float>::quiet_NaN());
+            acceleration.fill(std::numeric_limits<float>::quiet_NaN());
+            angularRate.fill(std::numeric_limits<float>::quiet_NaN());
+        }
+
+        /**
+         * @brief Measure the elapsed time to the @ref timestampReceive timepoint.
+         * @return Time (seconds) to the latest received message.
+         */
+        double TimeToLatestReceivedMessage(void) const {
+            auto timepointNow = std::chrono::steady_clock::now();
+            return 1.0e-9 * static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(timepointNow - timestampReceive).count());
+        }
+
+        /**
+         * @brief Convert this state to a touchpad pointer event.
+         * @return A touchpad pointer event built from this device state.
+         */
+        udptouchpad::TouchpadPointerEvent ToTouchpadPointerEvent(void) const {
+            udptouchpad::TouchpadPointerEvent event;
+            event.deviceID = deviceID;
+            event.endpoint = endpoint;
+            event.timestamp = timestampReceive;
+            event.aspectRatio = aspectRatio;
+            event.pointer = pointer;
+            return event;
+        }
+
+        /**
+         * @brief Convert this state to a motion sensor event.
+         * @return A motion sensor event built from this device state.
+         */
+        udptouchpad::MotionSensorEvent ToMotionSensorEvent(void) const {
+            udptouchpad::MotionSensorEvent event;
+            event.deviceID = deviceID;
+            event.endpoint = endpoint;
+            event.timestamp = timestampReceive;
+            event.rotationVector = rotationVector;
+            event.acceleration = acceleration;
+            event.angularRate = angularRate;
+            return event;
+        }
+
+        /**
+         * @brief Convert this state to a string.
+         * @return String representing this state.
+         */
+        std::string ToString(void){
+            std::string motion = ToMotionSensorEvent().ToString();
+            return ToTouchpadPointerEvent().ToString() + motion.substr(motion.find(' '));
+        }
+};
+
+
+} /* namespace: udptouchpad */
+
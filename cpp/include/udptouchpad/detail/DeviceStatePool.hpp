@@ -0,0 +1,189 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+#include <udptouchpad/detail/DeviceState.hpp>
+#include <udptouchpad/detail/DeviceStateTable.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Stores the latest state of each connected device in a slot of its own. One writer allocates, updates and releases
+ * the slots while any number of readers query them concurrently without locks and without ever blocking the writer.
+ * @details Slots are allocated in chunks that are never moved or freed before the pool is destroyed, so that readers can
+ * access them while the pool grows. Up to @ref UDP_TOUCHPAD_MAX_DEVICE_STATES slots can be allocated.
+ */
+class DeviceStatePool: public udptouchpad::detail::NonCopyable {
+    public:
+        static constexpr uint32_t invalidSlot = 0xFFFFFFFF;   // Index that does not refer to any slot.
+
+        /**
+         * @brief Construct a new pool without any slot.
+         */
+        DeviceStatePool(): numChunks(0){
+            for(auto&& chunk : chunks){
+                chunk.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Destroy the pool and free all chunks.
+         */
+        ~DeviceStatePool(){
+            for(auto&& chunk : chunks){
+                delete chunk.load(std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Allocate a slot for a device.
+         * @return Index of the slot or @ref invalidSlot if all @ref UDP_TOUCHPAD_MAX_DEVICE_STATES slots are in use.
+         * @details Only one thread may write to the pool at a time. Memory is only allocated if all slots of all chunks are in use.
+         */
+        uint32_t Allocate(void){
+            if(freeSlots.empty()){
+                size_t n = numChunks.load(std::memory_order_relaxed);
+                if(n >= chunks.size()){
+                    return invalidSlot;
+                }
+                chunks[n].store(new Chunk(), std::memory_order_release);
+                numChunks.store(n + 1, std::memory_order_release);
+                freeSlots.reserve((n + 1) * chunkSize);
+                for(size_t i = chunkSize; i > 0; --i){
+                    freeSlots.push_back(static_cast<uint32_t>(n * chunkSize + i - 1));
+                }
+            }
+            uint32_t index = freeSlots.back();
+            freeSlots.pop_back();
+            return index;
+        }
+
+        /**
+         * @brief Release a slot, so that it can be allocated for another device.
+         * @param[in] index Index of the slot. Nothing happens if this is @ref invalidSlot.
+         * @details Only one thread may write to the pool at a time.
+         */
+        void Release(const uint32_t index){
+            if(invalidSlot != index){
+                GetSlot(index).valid.store(false, std::memory_order_release);
+                freeSlots.push_back(index);
+            }
+        }
+
+        /**
+         * @brief Release all slots.
+         * @details Only one thread may write to the pool at a time.
+         */
+        void ReleaseAll(void){
+            size_t n = numChunks.load(std::memory_order_relaxed);
+            freeSlots.clear();
+            for(size_t i = n * chunkSize; i > 0; --i){
+                GetSlot(static_cast<uint32_t>(i - 1)).valid.store(false, std::memory_order_release);
+                freeSlots.push_back(static_cast<uint32_t>(i - 1));
+            }
+        }
+
+        /**
+         * @brief Store the latest state of a device to its slot.
+         * @param[in] index Index of the slot that has been allocated for the device. Nothing happens if this is @ref invalidSlot.
+         * @param[in] state The state to be stored.
+         * @details Only one thread may write to the pool at a time.
+         */
+        void Store(const uint32_t index, const udptouchpad::DeviceState& state){
+            if(invalidSlot != index){
+                udptouchpad::detail::DeviceStateSlot& slot = GetSlot(index);
+                slot.state.Store(state);
+                slot.deviceID.store(state.deviceID, std::memory_order_release);
+                slot.valid.store(true, std::memory_order_release);
+            }
+        }
+
+        /**
+         * @brief Load the latest state of a device.
+         * @param[in] deviceID The ID of the device.
+         * @param[out] state The latest state of the device. If the device sends on several endpoints, this is the state of any of them.
+         * @return True if the state of the device is stored, false otherwise.
+         * @details This function is thread-safe and never blocks the writer. All allocated slots are searched.
+         */
+        bool Load(const uint32_t deviceID, udptouchpad::DeviceState& state) const {
+            return FindSlot([&](const udptouchpad::detail::DeviceStateSlot& slot){ return slot.Load(deviceID, state); });
+        }
+
+        /**
+         * @brief Load the latest state of a device on a specific endpoint.
+         * @param[in] deviceID The ID of the device.
+         * @param[in] endpoint Index of the endpoint on which the messages of the device are received.
+         * @param[out] state The latest state of the device.
+         * @return True if the state of the device is stored, false otherwise.
+         * @details This function is thread-safe and never blocks the writer. All allocated slots are searched.
+         */
+        bool Load(const uint32_t deviceID, const uint16_t endpoint, udptouchpad::DeviceState& state) const {
+            return FindSlot([&](const udptouchpad::detail::DeviceStateSlot& slot){ return slot.Load(deviceID, endpoint, state); });
+        }
+
+        /**
+         * @brief Load the latest states of all devices.
+         * @param[out] states Container where to store the device states. The container is cleared first, its capacity is reused.
+         * @details This function is thread-safe and never blocks the writer.
+         */
+        void LoadAll(std::vector<udptouchpad::DeviceState>& states) const {
+            states.clear();
+            udptouchpad::DeviceState state;
+            (void) FindSlot([&](const udptouchpad::detail::DeviceStateSlot& slot){
+                if(slot.Load(state)){
+                    states.push_back(state);
+                }
+                return false;
+            });
+        }
+
+    private:
+        static constexpr size_t chunkSize = 64;                                               // Number of slots per chunk.
+        using Chunk = std::array<udptouchpad::detail::DeviceStateSlot, chunkSize>;
+        std::array<std::atomic<Chunk*>, UDP_TOUCHPAD_MAX_DEVICE_STATES / chunkSize> chunks;   // All chunks, only the first @ref numChunks are allocated.
+        std::atomic<size_t> numChunks;                                                        // Number of allocated chunks.
+        std::vector<uint32_t> freeSlots;                                                      // Indices of all allocated slots that are not in use, the lowest index is taken first.
+
+        /**
+         * @brief Get a slot of an allocated chunk.
+         * @param[in] index Index of the slot.
+         * @return Reference to the slot.
+         */
+        udptouchpad::detail::DeviceStateSlot& GetSlot(const uint32_t index){
+            return (*chunks[index / chunkSize].load(std::memory_order_relaxed))[index % chunkSize];
+        }
+
+        /**
+         * @brief Visit the slots of all allocated chunks until a slot is found.
+         * @tparam Function Function type with prototype bool(const DeviceStateSlot& slot).
+         * @param[in] f The function that is called for each slot, returns true if the slot has been found.
+         * @return True if a slot has been found, false otherwise.
+         * @details This function is thread-safe and never blocks the writer.
+         */
+        template <class Function> bool FindSlot(Function&& f) const {
+            size_t n = numChunks.load(std::memory_order_acquire);
+            for(size_t c = 0; c < n; ++c){
+                for(auto&& slot : *chunks[c].load(std::memory_order_acquire)){
+                    if(f(slot)){
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        static_assert((UDP_TOUCHPAD_MAX_DEVICE_STATES % chunkSize) == 0, "UDP_TOUCHPAD_MAX_DEVICE_STATES must be a multiple of 64!");
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
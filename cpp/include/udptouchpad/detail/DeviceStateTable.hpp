@@ -0,0 +1,234 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+#include <udptouchpad/detail/DeviceState.hpp>
+#include <udptouchpad/detail/SeqLock.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief One slot of a @ref DeviceStateTable.
+ * @details The layout does not contain any pointers, so that slots can also be placed in shared memory.
+ */
+struct DeviceStateSlot {
+    std::atomic<bool> valid;                                        // True if this slot contains the state of a connected device.
+    std::atomic<uint32_t> deviceID;                                 // ID of the device whose state is stored in this slot.
+    udptouchpad::detail::SeqLock<udptouchpad::DeviceState> state;   // The latest state of the device.
+
+    /**
+     * @brief Construct a new, invalid device state slot.
+     */
+    DeviceStateSlot(): valid(false), deviceID(0){}
+
+    /**
+     * @brief Load the state of a device if this slot contains it.
+     * @param[in] id The ID of the device.
+     * @param[out] s The latest state of the device.
+     * @return True if this slot contains the state of the device, false otherwise.
+     * @details This function is thread-safe and never blocks the writer.
+     */
+    bool Load(const uint32_t id, udptouchpad::DeviceState& s) const {
+        if(!valid.load(std::memory_order_acquire) || (id != deviceID.load(std::memory_order_acquire))){
+            return false;
+        }
+        state.Load(s);
+        return (id == s.deviceID) && valid.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Load the state of a device if this slot contains the state of the device on a specific endpoint.
+     * @param[in] id The ID of the device.
+     * @param[in] endpoint Index of the endpoint on which the messages of the device are received.
+     * @param[out] s The latest state of the device.
+     * @return True if this slot contains the state of the device on the endpoint, false otherwise.
+     * @details This function is thread-safe and never blocks the writer.
+     */
+    bool Load(const uint32_t id, const uint16_t endpoint, udptouchpad::DeviceState& s) const {
+        return Load(id, s) && (endpoint == s.endpoint);
+    }
+
+    /**
+     * @brief Load the state of any device if this slot is valid.
+     * @param[out] s The latest state of the device whose state is stored in this slot.
+     * @return True if this slot contains the state of a device, false otherwise.
+     * @details This function is thread-safe and never blocks the writer.
+     */
+    bool Load(udptouchpad::DeviceState& s) const {
+        return valid.load(std::memory_order_acquire) && Load(deviceID.load(std::memory_order_acquire), s);
+    }
+};
+
+
+/**
+ * @brief Stores the latest state of up to N devices in fixed slots. One writer updates the slots while any number of readers
+ * query them concurrently without locks and without ever blocking the writer.
+ * @tparam N Number of slots. If more than N devices are stored, the slot of the device with the oldest state is reused. A
+ * device that sends on several endpoints has one slot per endpoint.
+ * @details The slots are not owned by the table, they are attached via @ref Attach, e.g. from shared memory.
+ */
+template <size_t N> class DeviceStateTable: public udptouchpad::detail::NonCopyable {
+    public:
+        using Slots = std::array<udptouchpad::detail::DeviceStateSlot, N>;
+
+        /**
+         * @brief Construct a new device state table without attached slots.
+         */
+        DeviceStateTable(): slots(nullptr) {
+            slotUsed.fill(false);
+            slotDeviceID.fill(0);
+            slotEndpoint.fill(0);
+        }
+
+        /**
+         * @brief Attach the slots to be written by this table. All slots are assumed to be invalid.
+         * @param[in] s The slots to be written or nullptr to detach.
+         */
+        void Attach(Slots* s){
+            slots = s;
+            slotUsed.fill(false);
+            slotDeviceID.fill(0);
+            slotEndpoint.fill(0);
+        }
+
+        /**
+         * @brief Store the latest state of a device.
+         * @param[in] state The state to be stored.
+         * @details Only one thread may write to the table at a time.
+         */
+        void Store(const udptouchpad::DeviceState& state){
+            size_t index = FindSlot(state.deviceID, state.endpoint);
+            if(index >= N){
+                index = 0;
+                for(size_t i = 0; i < N; ++i){
+                    if(!slotUsed[i]){
+                        index = i;
+                        break;
+                    }
+                    if(slotTimestamp[i] < slotTimestamp[index]){
+                        index = i;
+                    }
+                }
+                (*slots)[index].valid.store(false, std::memory_order_release);
+            }
+            (*slots)[index].state.Store(state);
+            (*slots)[index].deviceID.store(state.deviceID, std::memory_order_release);
+            (*slots)[index].valid.store(true, std::memory_order_release);
+            slotUsed[index] = true;
+            slotDeviceID[index] = state.deviceID;
+            slotEndpoint[index] = state.endpoint;
+            slotTimestamp[index] = state.timestampReceive;
+        }
+
+        /**
+         * @brief Remove the state of a device.
+         * @param[in] deviceID The ID of the device to be removed.
+         * @param[in] endpoint Index of the endpoint on which the messages of the device are received.
+         * @details Only one thread may write to the table at a time.
+         */
+        void Remove(const uint32_t deviceID, const uint16_t endpoint){
+            size_t index = FindSlot(deviceID, endpoint);
+            if(index < N){
+                (*slots)[index].valid.store(false, std::memory_order_release);
+                slotUsed[index] = false;
+            }
+        }
+
+        /**
+         * @brief Remove the states of all devices.
+         * @details Only one thread may write to the table at a time.
+         */
+        void RemoveAll(void){
+            for(size_t i = 0; i < N; ++i){
+                if(slotUsed[i]){
+                    (*slots)[i].valid.store(false, std::memory_order_release);
+                    slotUsed[i] = false;
+                }
+            }
+        }
+
+        /**
+         * @brief Load the latest state of a device from a set of slots.
+         * @param[in] s The slots to be read.
+         * @param[in] deviceID The ID of the device.
+         * @param[out] state The latest state of the device. If the device sends on several endpoints, this is the state of any of them.
+         * @return True if the state of the device is stored, false otherwise.
+         * @details This function is thread-safe and never blocks the writer.
+         */
+        static bool Load(const Slots& s, const uint32_t deviceID, udptouchpad::DeviceState& state){
+            for(auto&& slot : s){
+                if(slot.Load(deviceID, state)){
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Load the latest state of a device on a specific endpoint from a set of slots.
+         * @param[in] s The slots to be read.
+         * @param[in] deviceID The ID of the device.
+         * @param[in] endpoint Index of the endpoint on which the messages of the device are received.
+         * @param[out] state The latest state of the device.
+         * @return True if the state of the device is stored, false otherwise.
+         * @details This function is thread-safe and never blocks the writer.
+         */
+        static bool Load(const Slots& s, const uint32_t deviceID, const uint16_t endpoint, udptouchpad::DeviceState& state){
+            for(auto&& slot : s){
+                if(slot.Load(deviceID, endpoint, state)){
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Load the latest states of all devices from a set of slots.
+         * @param[in] s The slots to be read.
+         * @param[out] states Container where to store the device states. The container is cleared first, its capacity is reused.
+         * @details This function is thread-safe and never blocks the writer.
+         */
+        static void LoadAll(const Slots& s, std::vector<udptouchpad::DeviceState>& states){
+            states.clear();
+            udptouchpad::DeviceState state;
+            for(auto&& slot : s){
+                if(slot.Load(state)){
+                    states.push_back(state);
+                }
+            }
+        }
+
+    private:
+        Slots* slots;                                                                      // The attached slots.
+        std::array<bool, N> slotUsed;                                                      // Writer-side copy of the valid flags of all slots.
+        std::array<uint32_t, N> slotDeviceID;                                              // Writer-side copy of the device IDs of all slots.
+        std::array<uint16_t, N> slotEndpoint;                                              // Writer-side copy of the endpoints of all slots.
+        std::array<std::chrono::time_point<std::chrono::steady_clock>, N> slotTimestamp;   // Writer-side copy of the receive timestamps of all slots.
+
+        /**
+         * @brief Find the slot of a device.
+         * @param[in] deviceID The device ID to be searched for.
+         * @param[in] endpoint The endpoint to be searched for.
+         * @return Index of the slot or N if the device has no slot.
+         */
+        size_t FindSlot(const uint32_t deviceID, const uint16_t endpoint){
+            size_t index = 0;
+            while((index < N) && !(slotUsed[index] && (slotDeviceID[index] == deviceID) && (slotEndpoint[index] == endpoint))){
+                index++;
+            }
+            return index;
+        }
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
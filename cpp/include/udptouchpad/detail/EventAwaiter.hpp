@@ -0,0 +1,221 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+#include <udptouchpad/detail/Events.hpp>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief Any event that can be delivered by the event system.
+ */
+using Event = std::variant<udptouchpad::ErrorEvent, udptouchpad::DeviceConnectionEvent, udptouchpad::TouchpadPointerEvent, udptouchpad::MotionSensorEvent>;
+
+
+class EventAwaiter;
+
+
+namespace detail {
+
+
+/**
+ * @brief Intrusive list of suspended coroutines that wait for the next event. The list does not allocate memory, all nodes
+ * are @ref EventAwaiter objects that live inside the coroutine frames.
+ */
+class EventAwaiterList: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Construct a new empty awaiter list.
+         */
+        EventAwaiterList(): head(nullptr){}
+
+        /**
+         * @brief Check whether any coroutine is waiting.
+         * @return True if the list is empty, false otherwise.
+         */
+        bool IsEmpty(void) const { return nullptr == head; }
+
+        /**
+         * @brief Add a suspended awaiter to the list.
+         * @param[in] awaiter The awaiter to be added.
+         */
+        inline void Push(udptouchpad::EventAwaiter* awaiter);
+
+        /**
+         * @brief Remove an awaiter from the list if it is still waiting.
+         * @param[in] awaiter The awaiter to be removed.
+         */
+        inline void Remove(udptouchpad::EventAwaiter* awaiter);
+
+        /**
+         * @brief Resume all coroutines that wait for an event of a specific device or for any event.
+         * @param[in] event The event to be passed to the resumed coroutines.
+         * @param[in] hasDeviceID True if the event belongs to a device, false otherwise (e.g. error events).
+         * @param[in] deviceID The device ID of the event.
+         * @details Coroutines are resumed on the calling thread. A resumed coroutine may immediately wait for the next event
+         * and may destroy other waiting coroutines.
+         */
+        inline void Resume(const udptouchpad::Event& event, bool hasDeviceID, uint32_t deviceID);
+
+    private:
+        udptouchpad::EventAwaiter* head;   // First awaiter in the list or nullptr if the list is empty.
+};
+
+
+} /* namespace: detail */
+
+
+/**
+ * @brief Awaitable object that suspends a coroutine until the next event (optionally of a specific device) is delivered by
+ * @ref EventSystem::PollEvents. The result of the co_await expression is a @ref udptouchpad::Event.
+ * @details The coroutine is resumed on the thread that calls @ref EventSystem::PollEvents, so awaiting must be done on that
+ * thread as well.
+ */
+class EventAwaiter: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Construct a new event awaiter.
+         * @param[in] list The list in which to wait.
+         * @param[in] filterDevice True if only events of the specified device should be awaited, false for any event.
+         * @param[in] deviceID The device ID to wait for if filterDevice is true.
+         */
+        EventAwaiter(udptouchpad::detail::EventAwaiterList& list, bool filterDevice, uint32_t deviceID): list(list), next(nullptr), linked(false), resumePending(false), filterDevice(filterDevice), deviceID(deviceID){}
+
+        /**
+         * @brief Destroy the event awaiter. If the coroutine is destroyed while waiting, the awaiter is removed from the list.
+         */
+        ~EventAwaiter(){
+            if(linked){
+                list.Remove(this);
+            }
+        }
+
+        /**
+         * @brief An event awaiter always suspends the coroutine.
+         * @return Always false.
+         */
+        bool await_ready(void) const noexcept { return false; }
+
+        /**
+         * @brief Suspend the coroutine until the next event is delivered.
+         * @param[in] h The handle of the suspended coroutine.
+         */
+        void await_suspend(std::coroutine_handle<> h) noexcept {
+            handle = h;
+            list.Push(this);
+        }
+
+        /**
+         * @brief Get the event that resumed the coroutine.
+         * @return The delivered event.
+         */
+        udptouchpad::Event await_resume(void){
+            return std::move(event);
+        }
+
+    private:
+        friend class udptouchpad::detail::EventAwaiterList;
+        udptouchpad::detail::EventAwaiterList& list;   // The list in which to wait.
+        EventAwaiter* next;                            // Next awaiter in the list.
+        bool linked;                                   // True if this awaiter is part of the list.
+        bool resumePending;                            // True if this awaiter is to be resumed by the running @ref EventAwaiterList::Resume.
+        bool filterDevice;                             // True if only events of @ref deviceID are awaited.
+        uint32_t deviceID;                             // The device ID to wait for if @ref filterDevice is true.
+        std::coroutine_handle<> handle;                // The suspended coroutine.
+        udptouchpad::Event event;                      // The delivered event.
+};
+
+
+/**
+ * @brief Represents the asynchronous stream of events of one device. Use co_await stream.Next() to obtain the next event.
+ */
+class DeviceEventStream {
+    public:
+        /**
+         * @brief Construct a new device event stream.
+         * @param[in] list The list in which to wait.
+         * @param[in] deviceID The device whose events are awaited.
+         */
+        DeviceEventStream(udptouchpad::detail::EventAwaiterList& list, uint32_t deviceID): list(list), deviceID(deviceID){}
+
+        /**
+         * @brief Wait for the next event of the device.
+         * @return The awaitable object.
+         */
+        udptouchpad::EventAwaiter Next(void){ return udptouchpad::EventAwaiter(list, true, deviceID); }
+
+        /**
+         * @brief Get the device ID of this stream.
+         * @return The device ID.
+         */
+        uint32_t GetDeviceID(void) const { return deviceID; }
+
+    private:
+        udptouchpad::detail::EventAwaiterList& list;   // The list in which to wait.
+        uint32_t deviceID;                             // The device whose events are awaited.
+};
+
+
+namespace detail {
+
+
+inline void EventAwaiterList::Push(udptouchpad::EventAwaiter* awaiter){
+    awaiter->next = head;
+    awaiter->linked = true;
+    awaiter->resumePending = false;
+    head = awaiter;
+}
+
+
+inline void EventAwaiterList::Remove(udptouchpad::EventAwaiter* awaiter){
+    for(udptouchpad::EventAwaiter** p = &head; *p; p = &((*p)->next)){
+        if(*p == awaiter){
+            *p = awaiter->next;
+            break;
+        }
+    }
+    awaiter->next = nullptr;
+    awaiter->linked = false;
+    awaiter->resumePending = false;
+}
+
+
+inline void EventAwaiterList::Resume(const udptouchpad::Event& event, bool hasDeviceID, uint32_t deviceID){
+    // flag all matching awaiters, so that resumed coroutines can wait again without being resumed twice
+    size_t numPending = 0;
+    for(udptouchpad::EventAwaiter* awaiter = head; awaiter; awaiter = awaiter->next){
+        awaiter->resumePending = !awaiter->filterDevice || (hasDeviceID && (awaiter->deviceID == deviceID));
+        numPending += static_cast<size_t>(awaiter->resumePending);
+    }
+
+    // resume one coroutine at a time in the order in which they started waiting, the flagged awaiters stay in the list until
+    // they are resumed, so that a resumed coroutine that destroys another waiting coroutine unlinks its awaiter
+    while(numPending--){
+        udptouchpad::EventAwaiter** p = nullptr;
+        for(udptouchpad::EventAwaiter** q = &head; *q; q = &((*q)->next)){
+            if((*q)->resumePending){
+                p = q;
+            }
+        }
+        if(!p){
+            break;
+        }
+        udptouchpad::EventAwaiter* awaiter = *p;
+        *p = awaiter->next;
+        awaiter->next = nullptr;
+        awaiter->linked = false;
+        awaiter->resumePending = false;
+        awaiter->event = event;
+        awaiter->handle.resume();
+    }
+}
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
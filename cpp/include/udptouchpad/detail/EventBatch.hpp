@@ -0,0 +1,54 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/Trace.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Run a batch callback with all events of a batch and clear the batch. Nothing happens if the batch is empty.
+ * @tparam T Type of the events.
+ * @param[in] callback The batch callback. If empty, the batch is only cleared.
+ * @param[inout] batch The batch to be delivered. The capacity is kept.
+ */
+template <class T> void DeliverBatch(const std::function<void(std::span<const T>)>& callback, std::vector<T>& batch){
+    if(batch.empty()){
+        return;
+    }
+    if(callback){
+        UDP_TOUCHPAD_TRACE_SCOPE("BatchCallback", batch.size());
+        callback(std::span<const T>(batch.data(), batch.size()));
+    }
+    batch.clear();
+}
+
+
+/**
+ * @brief Append an event to a batch if a batch callback is set. A batch that reaches @ref UDP_TOUCHPAD_PENDING_EVENTS_RESERVE
+ * events is delivered immediately, so that the batch never grows beyond its reserved capacity.
+ * @tparam T Type of the event.
+ * @param[in] callback The batch callback.
+ * @param[inout] batch The batch to which to append the event.
+ * @param[in] e The event to be appended.
+ */
+template <class T> void AppendToBatch(const std::function<void(std::span<const T>)>& callback, std::vector<T>& batch, const T& e){
+    if(callback){
+        batch.push_back(e);
+        if(batch.size() >= UDP_TOUCHPAD_PENDING_EVENTS_RESERVE){
+            udptouchpad::detail::DeliverBatch(callback, batch);
+        }
+    }
+}
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
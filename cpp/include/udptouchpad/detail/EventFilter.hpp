@@ -0,0 +1,116 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief Bitmask values to select the event types of an @ref EventFilter.
+ */
+enum EventTypeMask: uint32_t {
+    event_mask_none = 0,
+    event_mask_connection = (1 << 0),
+    event_mask_touchpad_pointer = (1 << 1),
+    event_mask_motion_sensor = (1 << 2),
+    event_mask_all = event_mask_connection | event_mask_touchpad_pointer | event_mask_motion_sensor
+};
+
+
+/**
+ * @brief Selects the devices, event types and the screen region an application is interested in. The filter is applied as
+ * soon as a message has been unpacked, so that messages of rejected devices neither create device data nor events.
+ */
+class EventFilter {
+    public:
+        std::vector<uint32_t> allowedDeviceIDs;   // If not empty, only messages from these devices are processed.
+        std::vector<uint32_t> deniedDeviceIDs;    // Messages from these devices are never processed.
+        uint32_t eventTypes;                      // Bitmask of @ref EventTypeMask values that selects the event types to be generated.
+        std::array<double,2> regionMin;           // Lower bound of the screen region in relative device screen coordinates in [0,1].
+        std::array<double,2> regionMax;           // Upper bound of the screen region in relative device screen coordinates in [0,1]. Pointers outside the region are treated as not pressed.
+
+        /**
+         * @brief Construct a new event filter that accepts everything.
+         */
+        EventFilter(): eventTypes(udptouchpad::event_mask_all), regionMin({0.0, 0.0}), regionMax({1.0, 1.0}) {}
+
+        /**
+         * @brief Check whether messages from a device are accepted.
+         * @param[in] deviceID The ID of the device.
+         * @return True if the device is accepted, false otherwise.
+         */
+        bool AcceptsDevice(const uint32_t deviceID) const {
+            if(std::find(deniedDeviceIDs.begin(), deniedDeviceIDs.end(), deviceID) != deniedDeviceIDs.end()){
+                return false;
+            }
+            return allowedDeviceIDs.empty() || (std::find(allowedDeviceIDs.begin(), allowedDeviceIDs.end(), deviceID) != allowedDeviceIDs.end());
+        }
+
+        /**
+         * @brief Check whether an event type is accepted.
+         * @param[in] mask The event type mask, e.g. @ref event_mask_touchpad_pointer.
+         * @return True if the event type is accepted, false otherwise.
+         */
+        bool AcceptsEventType(const uint32_t mask) const {
+            return 0 != (eventTypes & mask);
+        }
+
+        /**
+         * @brief Check whether a pointer position is inside the screen region.
+         * @param[in] position The pointer position in relative device screen coordinates.
+         * @return True if the position is inside the screen region, false otherwise.
+         */
+        bool AcceptsPosition(const std::array<double,2>& position) const {
+            return (position[0] >= regionMin[0]) && (position[0] <= regionMax[0]) && (position[1] >= regionMin[1]) && (position[1] <= regionMax[1]);
+        }
+};
+
+
+namespace detail {
+
+
+/**
+ * @brief The device selection of an @ref EventFilter, where the device IDs are sorted, so that a device is checked by binary
+ * search. A device filter is immutable once it has been constructed and can therefore be shared between threads.
+ */
+class DeviceFilter {
+    public:
+        /**
+         * @brief Construct a new device filter that accepts all devices.
+         */
+        DeviceFilter(){}
+
+        /**
+         * @brief Construct a new device filter from the device selection of an event filter.
+         * @param[in] f The event filter whose allowed and denied device IDs are to be used.
+         */
+        explicit DeviceFilter(const udptouchpad::EventFilter& f): allowedDeviceIDs(f.allowedDeviceIDs), deniedDeviceIDs(f.deniedDeviceIDs){
+            std::sort(allowedDeviceIDs.begin(), allowedDeviceIDs.end());
+            std::sort(deniedDeviceIDs.begin(), deniedDeviceIDs.end());
+        }
+
+        /**
+         * @brief Check whether messages from a device are accepted.
+         * @param[in] deviceID The ID of the device.
+         * @return True if the device is accepted, false otherwise.
+         */
+        bool AcceptsDevice(const uint32_t deviceID) const {
+            if(std::binary_search(deniedDeviceIDs.begin(), deniedDeviceIDs.end(), deviceID)){
+                return false;
+            }
+            return allowedDeviceIDs.empty() || std::binary_search(allowedDeviceIDs.begin(), allowedDeviceIDs.end(), deviceID);
+        }
+
+    private:
+        std::vector<uint32_t> allowedDeviceIDs;   // Sorted IDs of the devices that are accepted, all devices are accepted if empty.
+        std::vector<uint32_t> deniedDeviceIDs;    // Sorted IDs of the devices that are never accepted.
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
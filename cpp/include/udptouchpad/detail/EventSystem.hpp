@@ -3,10 +3,18 @@
 
 #include <udptouchpad/detail/Common.hpp>
 #include <udptouchpad/detail/EventSystemNetworkBase.hpp>
+#include <udptouchpad/detail/Transport.hpp>
 #include <udptouchpad/detail/TouchpadMessage.hpp>
-#include <udptouchpad/detail/CircularFIFOBuffer.hpp>
+#include <udptouchpad/detail/LockFreeRingBuffer.hpp>
 #include <udptouchpad/detail/Events.hpp>
+#include <udptouchpad/detail/CompactEvents.hpp>
 #include <udptouchpad/detail/DeviceDatabase.hpp>
+#include <udptouchpad/detail/SharedMemoryPublisher.hpp>
+#include <udptouchpad/detail/EventAwaiter.hpp>
+#include <udptouchpad/detail/NetworkConfiguration.hpp>
+#include <udptouchpad/detail/ReceiverHub.hpp>
+#include <udptouchpad/detail/Trace.hpp>
+#include <udptouchpad/detail/EventBatch.hpp>
 
 
 namespace udptouchpad {
@@ -18,6 +26,104 @@ namespace udptouchpad {
  */
 class EventSystem: public udptouchpad::detail::EventSystemNetworkBase {
     public:
+        /**
+         * @brief Construct a new event system.
+         * @param[in] configuration The network configuration, by default the settings of the UDP touchpad app are used.
+         * @param[in] autoStart True if receiving should be started immediately, false if @ref Start is called later on.
+         */
+        explicit EventSystem(const udptouchpad::NetworkConfiguration& configuration = udptouchpad::NetworkConfiguration(), bool autoStart = true){
+            dispatchDeviceConnection = [this](udptouchpad::DeviceConnectionEvent e){ Dispatch(callbackDeviceConnection, std::move(e)); };
+            dispatchTouchpadPointer = [this](const udptouchpad::CompactTouchpadPointerEvent& e){ DispatchCompact(e); };
+            dispatchMotionSensor = [this](udptouchpad::MotionSensorEvent e){ Dispatch(callbackMotionSensor, std::move(e)); };
+            SetNetworkConfiguration(configuration);
+            if(autoStart){
+                Start();
+            }
+        }
+
+        /**
+         * @brief Construct a new event system that receives messages from a user-defined transport instead of multicast UDP.
+         * @param[in] transport The transport from which messages are received, e.g. an @ref InProcessTransport or a @ref ReplayTransport.
+         * @param[in] autoStart True if receiving should be started immediately, false if @ref Start is called later on.
+         */
+        explicit EventSystem(std::shared_ptr<udptouchpad::Transport> transport, bool autoStart = true): EventSystem(udptouchpad::NetworkConfiguration(), false){
+            EventSystemNetworkBase::SetTransport(transport);
+            if(autoStart){
+                Start();
+            }
+        }
+
+        /**
+         * @brief Destroy the event system.
+         */
+        ~EventSystem(){
+            Stop();
+        }
+
+        /**
+         * @brief Start receiving messages with the current network configuration. Nothing happens if receiving is already started.
+         * @details If @ref NetworkConfiguration::sharedReceiver is set, this event system subscribes to the process-wide receiver
+         * hub with equal receive settings instead of starting its own receive thread. A user-defined transport always uses
+         * its own receive thread.
+         */
+        void Start(void){
+            if(HasCustomTransport() || !GetNetworkConfiguration().sharedReceiver){
+                StartWorkerThread();
+            }
+            else if(!receiverHub){
+                receiverHub = udptouchpad::detail::ReceiverHub::Acquire(GetNetworkConfiguration());
+                receiverHub->Subscribe(this);
+            }
+        }
+
+        /**
+         * @brief Stop receiving messages. The receive thread is woken up immediately and has terminated when this member
+         * function returns. Events that have already been received can still be polled.
+         * @details If this event system uses a shared receiver, it is unsubscribed from the receiver hub. The hub and its receive
+         * thread are stopped as soon as the last event system has been unsubscribed.
+         */
+        void Stop(void){
+            if(receiverHub){
+                receiverHub->Unsubscribe(this);
+                receiverHub.reset();
+            }
+            StopWorkerThread();
+        }
+
+        /**
+         * @brief Stop receiving messages and start again with a new network configuration. All buffers are reused.
+         * @param[in] configuration The new network configuration.
+         * @details Start, stop and restart must not be called concurrently from multiple threads.
+         */
+        void Restart(const udptouchpad::NetworkConfiguration& configuration){
+            Stop();
+            SetNetworkConfiguration(configuration);
+            Start();
+        }
+
+        /**
+         * @brief Stop receiving messages and start again with a user-defined transport. All buffers are reused.
+         * @param[in] transport The transport from which messages are received. If nullptr, messages are received via multicast
+         * UDP with the current network configuration.
+         * @details Receiving is only started again if it has been started before.
+         */
+        void SetTransport(std::shared_ptr<udptouchpad::Transport> transport){
+            bool running = IsRunning();
+            Stop();
+            EventSystemNetworkBase::SetTransport(transport);
+            if(running){
+                Start();
+            }
+        }
+
+        /**
+         * @brief Check whether messages are being received or not.
+         * @return True if receiving has been started, false otherwise.
+         */
+        bool IsRunning(void){
+            return IsWorkerThreadRunning() || receiverHub;
+        }
+
         /**
          * @brief Clear all events and reset the internal device database.
          */
@@ -45,11 +151,24 @@ class EventSystem: public udptouchpad::detail::EventSystemNetworkBase {
         /**
          * @brief Set callback function for touchpad pointer events.
          * @param[in] f The callback function with prototype void(udptouchpad::TouchpadPointerEvent).
+         * @details Pending touchpad pointer events are stored as @ref CompactTouchpadPointerEvent, so the pointer positions and
+         * the aspect ratio are rounded to float. Use @ref GetDeviceState to obtain these values with double precision.
          */
         void SetTouchpadPointerCallback(std::function<void(udptouchpad::TouchpadPointerEvent)> f){
             callbackTouchpadPointer = f;
         }
 
+        /**
+         * @brief Set callback function for touchpad pointer events in their compact form. Events are passed as stored in the
+         * internal queue without conversion to @ref TouchpadPointerEvent.
+         * @param[in] f The callback function with prototype void(const udptouchpad::CompactTouchpadPointerEvent&).
+         * @details This callback is called before the callback set by @ref SetTouchpadPointerCallback. If only the compact
+         * callback is set and no coroutine waits for events, touchpad pointer events are never converted.
+         */
+        void SetCompactTouchpadPointerCallback(std::function<void(const udptouchpad::CompactTouchpadPointerEvent&)> f){
+            callbackCompactTouchpadPointer = f;
+        }
+
         /**
          * @brief Set callback function for motion sensor events.
          * @param[in] f The callback function with prototype void(udptouchpad::MotionSensorEvent).
@@ -59,16 +178,238 @@ class EventSystem: public udptouchpad::detail::EventSystemNetworkBase {
         }
 
         /**
-         * @brief Poll events and run user-defined callback functions.
+         * @brief Set batch callback function for device connection events. All device connection events of one call to
+         * @ref PollEvents are delivered at once from contiguous storage.
+         * @param[in] f The callback function with prototype void(std::span<const udptouchpad::DeviceConnectionEvent>).
+         * @details Batch callbacks are called at the end of @ref PollEvents, after all callbacks for single events, in the
+         * order device connection, touchpad pointer, compact touchpad pointer and motion sensor. The span is only valid
+         * during the call. Batch storage is reused, so that no memory is allocated in steady state. Events are delivered to
+         * batch callbacks directly from the fetched events, so if only batch callbacks are set for an event type and no
+         * coroutine waits for events, no per-event dispatch takes place.
+         */
+        void SetDeviceConnectionBatchCallback(std::function<void(std::span<const udptouchpad::DeviceConnectionEvent>)> f){
+            callbackDeviceConnectionBatch = f;
+            fetchedBatches.collectDeviceConnection = static_cast<bool>(f);
+            fetchedBatches.deviceConnection.reserve(UDP_TOUCHPAD_PENDING_EVENTS_RESERVE);
+        }
+
+        /**
+         * @brief Set batch callback function for touchpad pointer events. All touchpad pointer events of one call to
+         * @ref PollEvents are delivered at once from contiguous storage.
+         * @param[in] f The callback function with prototype void(std::span<const udptouchpad::TouchpadPointerEvent>).
+         * @details See @ref SetDeviceConnectionBatchCallback for the order of batch callbacks. The compact events are converted
+         * in one pass right before the callback is called, so the pointer positions and the aspect ratio are rounded to float.
+         */
+        void SetTouchpadPointerBatchCallback(std::function<void(std::span<const udptouchpad::TouchpadPointerEvent>)> f){
+            callbackTouchpadPointerBatch = f;
+            fetchedBatches.collectCompactTouchpadPointer = callbackTouchpadPointerBatch || callbackCompactTouchpadPointerBatch;
+            fetchedBatches.compactTouchpadPointer.reserve(UDP_TOUCHPAD_PENDING_EVENTS_RESERVE);
+            batchTouchpadPointer.reserve(UDP_TOUCHPAD_PENDING_EVENTS_RESERVE);
+        }
+
+        /**
+         * @brief Set batch callback function for touchpad pointer events in their compact form. All touchpad pointer events of
+         * one call to @ref PollEvents are delivered at once from contiguous storage without conversion.
+         * @param[in] f The callback function with prototype void(std::span<const udptouchpad::CompactTouchpadPointerEvent>).
+         * @details See @ref SetDeviceConnectionBatchCallback for the order of batch callbacks.
+         */
+        void SetCompactTouchpadPointerBatchCallback(std::function<void(std::span<const udptouchpad::CompactTouchpadPointerEvent>)> f){
+            callbackCompactTouchpadPointerBatch = f;
+            fetchedBatches.collectCompactTouchpadPointer = callbackTouchpadPointerBatch || callbackCompactTouchpadPointerBatch;
+            fetchedBatches.compactTouchpadPointer.reserve(UDP_TOUCHPAD_PENDING_EVENTS_RESERVE);
+        }
+
+        /**
+         * @brief Set batch callback function for motion sensor events. All motion sensor events of one call to
+         * @ref PollEvents are delivered at once from contiguous storage.
+         * @param[in] f The callback function with prototype void(std::span<const udptouchpad::MotionSensorEvent>).
+         * @details See @ref SetDeviceConnectionBatchCallback for the order of batch callbacks.
+         */
+        void SetMotionSensorBatchCallback(std::function<void(std::span<const udptouchpad::MotionSensorEvent>)> f){
+            callbackMotionSensorBatch = f;
+            fetchedBatches.collectMotionSensor = static_cast<bool>(f);
+            fetchedBatches.motionSensor.reserve(UDP_TOUCHPAD_PENDING_EVENTS_RESERVE);
+        }
+
+        /**
+         * @brief Set the filter that selects the devices, event types and screen region to be processed. Messages from rejected
+         * devices are dropped right after they have been unpacked, so that they neither create device data nor events.
+         * @param[in] filter The new filter. Connected devices that are rejected by the new filter are disconnected.
+         */
+        void SetEventFilter(const udptouchpad::EventFilter& filter){
+            deviceDatabase.SetFilter(filter);
+        }
+
+        /**
+         * @brief Set deadband thresholds for the change detection. Touchpad pointer and motion sensor events are only generated
+         * if a value differs from the value of the last generated event by more than the corresponding threshold.
+         * @param[in] thresholds The new thresholds. By default, all thresholds are zero and every change generates an event.
+         */
+        void SetChangeThresholds(const udptouchpad::ChangeThresholds& thresholds){
+            deviceDatabase.SetChangeThresholds(thresholds);
+        }
+
+        /**
+         * @brief Limit the rate of touchpad pointer and motion sensor events of all devices that have no device-specific rate
+         * limit. Events within one window are coalesced according to the policy of the rate limit.
+         * @param[in] limit The new rate limit. By default, rate limiting is disabled.
+         * @details Changes of the pressed state of touchpad pointers are always reported immediately. Coalesced events are
+         * emitted by @ref PollEvents, so it should be called at least at the maximum event rate.
+         */
+        void SetRateLimit(const udptouchpad::RateLimit& limit){
+            deviceDatabase.SetRateLimit(limit);
+        }
+
+        /**
+         * @brief Limit the rate of touchpad pointer and motion sensor events of a specific device.
+         * @param[in] deviceID The ID of the device.
+         * @param[in] limit The new rate limit for this device, which overrides the rate limit set by @ref SetRateLimit.
+         */
+        void SetDeviceRateLimit(const uint32_t deviceID, const udptouchpad::RateLimit& limit){
+            deviceDatabase.SetDeviceRateLimit(deviceID, limit);
+        }
+
+        /**
+         * @brief Remove the device-specific rate limit of a device, so that the rate limit set by @ref SetRateLimit applies again.
+         * @param[in] deviceID The ID of the device.
+         */
+        void ResetDeviceRateLimit(const uint32_t deviceID){
+            deviceDatabase.ResetDeviceRateLimit(deviceID);
+        }
+
+        /**
+         * @brief Get statistics about the processing of received messages, e.g. the number of suppressed events.
+         * @return A copy of the current statistics.
+         */
+        udptouchpad::Statistics GetStatistics(void){
+            return deviceDatabase.GetStatistics();
+        }
+
+        /**
+         * @brief Get the latest state of a connected device without consuming any events.
+         * @param[in] deviceID The ID of the device.
+         * @param[out] state The latest state of the device. If the device sends on several endpoints, this is the state of any of them.
+         * @return True if the device is connected, false otherwise.
+         * @details This call is thread-safe and never blocks the receive thread.
+         */
+        bool GetDeviceState(const uint32_t deviceID, udptouchpad::DeviceState& state){
+            return deviceDatabase.GetDeviceState(deviceID, state);
+        }
+
+        /**
+         * @brief Get the latest state of a device that is connected on a specific endpoint without consuming any events.
+         * @param[in] deviceID The ID of the device.
+         * @param[in] endpoint Index of the network endpoint on which the messages of the device are received.
+         * @param[out] state The latest state of the device.
+         * @return True if the device is connected on the endpoint, false otherwise.
+         * @details This call is thread-safe and never blocks the receive thread.
+         */
+        bool GetDeviceState(const uint32_t deviceID, const uint16_t endpoint, udptouchpad::DeviceState& state){
+            return deviceDatabase.GetDeviceState(deviceID, endpoint, state);
+        }
+
+        /**
+         * @brief Get the latest states of all connected devices without consuming any events.
+         * @param[out] states Container where to store the device states. The container is cleared first, its capacity is reused.
+         * @details This call is thread-safe and never blocks the receive thread.
+         */
+        void GetAllDeviceStates(std::vector<udptouchpad::DeviceState>& states){
+            deviceDatabase.GetAllDeviceStates(states);
+        }
+
+        /**
+         * @brief Publish all device states and events of this event system to a shared memory segment. Other processes can
+         * read them via a @ref SharedMemorySubscriber without receiving and processing network traffic on their own.
+         * @param[in] name The name of the shared memory segment.
+         * @return True if success, false otherwise. If publishing could not be enabled, an error event is generated.
+         * @details Events are published whenever @ref PollEvents is called, device states are published as soon as messages are received.
+         * A previous publisher is released before the segment is opened, so that a segment is never written by two publishers.
+         * Must not be called from within a callback.
+         */
+        bool EnableSharedMemoryPublisher(const std::string& name){
+            deviceDatabase.SetPublisher(nullptr);
+            auto publisher = std::make_unique<udptouchpad::detail::SharedMemoryPublisher>();
+            if(!publisher->Open(name)){
+                ProcessErrorMessage(publisher->GetErrorString());
+                return false;
+            }
+            deviceDatabase.SetPublisher(std::move(publisher));
+            return true;
+        }
+
+        /**
+         * @brief Stop publishing device states and events to shared memory.
+         * @details Must not be called from within a callback.
+         */
+        void DisableSharedMemoryPublisher(void){
+            deviceDatabase.SetPublisher(nullptr);
+        }
+
+        /**
+         * @brief Wait for the next event of any type and any device.
+         * @return Awaitable object, use co_await eventSystem.NextEvent() inside a coroutine to obtain the next @ref udptouchpad::Event.
+         * @details The coroutine is resumed from within @ref PollEvents after the user-defined callback of the event has been
+         * called. Awaiting and polling must be done on the same thread. As for @ref SetTouchpadPointerCallback, the pointer
+         * positions and the aspect ratio of touchpad pointer events are rounded to float.
+         */
+        udptouchpad::EventAwaiter NextEvent(void){
+            return udptouchpad::EventAwaiter(awaiters, false, 0);
+        }
+
+        /**
+         * @brief Wait for the next event of a specific device. Error events are not delivered.
+         * @param[in] deviceID The ID of the device.
+         * @return Awaitable object, use co_await eventSystem.NextEvent(deviceID) inside a coroutine to obtain the next @ref udptouchpad::Event.
+         * @details The coroutine is resumed from within @ref PollEvents after the user-defined callback of the event has been
+         * called. Awaiting and polling must be done on the same thread.
+         */
+        udptouchpad::EventAwaiter NextEvent(const uint32_t deviceID){
+            return udptouchpad::EventAwaiter(awaiters, true, deviceID);
+        }
+
+        /**
+         * @brief Get the asynchronous event stream of a specific device.
+         * @param[in] deviceID The ID of the device.
+         * @return The event stream, use co_await stream.Next() inside a coroutine to obtain the next event of the device.
+         */
+        udptouchpad::DeviceEventStream Events(const uint32_t deviceID){
+            return udptouchpad::DeviceEventStream(awaiters, deviceID);
+        }
+
+        /**
+         * @brief Poll events, run user-defined callback functions and resume coroutines that wait for events.
+         * @details Single event callbacks are called first, batch callbacks are called at the end with all events of this poll.
+         * Each event is dispatched to the coroutines that wait at the time of the event, so coroutines that start to wait
+         * during this poll, e.g. from within a callback, are resumed with the subsequent events of this poll.
          */
         void PollEvents(void){
-            auto errorEvents = errorBuffer.Get();
-            if(callbackError){
-                for(auto&& e : errorEvents){
+            (void) errorBuffer.Drain([this](udptouchpad::ErrorEvent& e){
+                UDP_TOUCHPAD_TRACE_SCOPE("ErrorCallback", 0);
+                if(awaiters.IsEmpty()){ // the message is only copied if a coroutine waits for the event as well
+                    if(callbackError){
+                        callbackError(std::move(e));
+                    }
+                    return;
+                }
+                if(callbackError){
                     callbackError(e);
                 }
+                awaiters.Resume(udptouchpad::Event(std::move(e)), false, 0);
+            });
+
+            // single events are always dispatched, the dispatchers check for waiting coroutines per event
+            deviceDatabase.FetchEvents(dispatchDeviceConnection, dispatchTouchpadPointer, dispatchMotionSensor, std::chrono::steady_clock::now(), &fetchedBatches);
+
+            // batches are delivered directly from the partitioned events, touchpad pointer events are converted in one pass
+            udptouchpad::detail::DeliverBatch(callbackDeviceConnectionBatch, fetchedBatches.deviceConnection);
+            if(callbackTouchpadPointerBatch){
+                for(auto&& e : fetchedBatches.compactTouchpadPointer){
+                    batchTouchpadPointer.push_back(e.ToTouchpadPointerEvent());
+                }
+                udptouchpad::detail::DeliverBatch(callbackTouchpadPointerBatch, batchTouchpadPointer);
             }
-            deviceDatabase.FetchEvents(callbackDeviceConnection, callbackTouchpadPointer, callbackMotionSensor);
+            udptouchpad::detail::DeliverBatch(callbackCompactTouchpadPointerBatch, fetchedBatches.compactTouchpadPointer);
+            udptouchpad::detail::DeliverBatch(callbackMotionSensorBatch, fetchedBatches.motionSensor);
         }
 
     protected:
@@ -77,28 +418,89 @@ class EventSystem: public udptouchpad::detail::EventSystemNetworkBase {
          * @param[in] msg The error message to be handled.
          */
         void ProcessErrorMessage(const std::string& msg){
-            errorBuffer.Add(ErrorEvent(msg));
+            errorBuffer.PushOverwrite(ErrorEvent(msg));
+        }
+
+        /**
+         * @brief Count messages that have been dropped by the kernel in the statistics.
+         * @param[in] endpoint Index of the network endpoint on which the messages have been dropped.
+         * @param[in] numDropped Number of messages that have been dropped, because the receive buffer was full.
+         * @param[in] numRejected Number of messages that have been rejected by the kernel filter.
+         */
+        void ProcessDroppedMessages(const uint16_t endpoint, const uint64_t numDropped, const uint64_t numRejected){
+            (void) endpoint;
+            deviceDatabase.CountDroppedDatagrams(numDropped, numRejected);
         }
 
         /**
          * @brief Process a received message from the UDP touchpad app.
          * @param[in] source The source address from where the message was sent.
+         * @param[in] endpoint Index of the network endpoint on which the message has been received.
          * @param[in] msg The message that has been received.
+         * @param[in] timestamp Time when the message has been received.
          */
-        void ProcessTouchMessage(const uint32_t source, const udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg){
-            deviceDatabase.PushNewMessage(source, msg);
+        void ProcessTouchMessage(const uint32_t source, const uint16_t endpoint, const udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg, const std::chrono::time_point<std::chrono::steady_clock> timestamp){
+            deviceDatabase.PushNewMessage(source, endpoint, msg, timestamp);
         }
 
     private:
         /* user-defined callbacks */
-        std::function<void(udptouchpad::ErrorEvent)> callbackError;                         // Callback for error messages.
-        std::function<void(udptouchpad::DeviceConnectionEvent)> callbackDeviceConnection;   // Callback for device connection events.
-        std::function<void(udptouchpad::TouchpadPointerEvent)> callbackTouchpadPointer;     // Callback for touchpad pointer events.
-        std::function<void(udptouchpad::MotionSensorEvent)> callbackMotionSensor;           // Callback for motion sensor events.
+        std::function<void(udptouchpad::ErrorEvent)> callbackError;                                                           // Callback for error messages.
+        std::function<void(udptouchpad::DeviceConnectionEvent)> callbackDeviceConnection;                                     // Callback for device connection events.
+        std::function<void(udptouchpad::TouchpadPointerEvent)> callbackTouchpadPointer;                                       // Callback for touchpad pointer events.
+        std::function<void(const udptouchpad::CompactTouchpadPointerEvent&)> callbackCompactTouchpadPointer;                  // Callback for compact touchpad pointer events.
+        std::function<void(udptouchpad::MotionSensorEvent)> callbackMotionSensor;                                             // Callback for motion sensor events.
+
+        /* user-defined batch callbacks and the events that are collected for them during one poll */
+        std::function<void(std::span<const udptouchpad::DeviceConnectionEvent>)> callbackDeviceConnectionBatch;               // Batch callback for device connection events.
+        std::function<void(std::span<const udptouchpad::TouchpadPointerEvent>)> callbackTouchpadPointerBatch;                 // Batch callback for touchpad pointer events.
+        std::function<void(std::span<const udptouchpad::CompactTouchpadPointerEvent>)> callbackCompactTouchpadPointerBatch;   // Batch callback for compact touchpad pointer events.
+        std::function<void(std::span<const udptouchpad::MotionSensorEvent>)> callbackMotionSensorBatch;                       // Batch callback for motion sensor events.
+        udptouchpad::detail::FetchedEventBatches fetchedBatches;                                                              // Events of the current poll, partitioned by type.
+        std::vector<udptouchpad::TouchpadPointerEvent> batchTouchpadPointer;                                                  // Touchpad pointer events of the current poll, converted from their compact form.
+
+        /* internal dispatchers that run user-defined callbacks and resume awaiting coroutines */
+        std::function<void(udptouchpad::DeviceConnectionEvent)> dispatchDeviceConnection;                                     // Dispatcher for device connection events.
+        std::function<void(const udptouchpad::CompactTouchpadPointerEvent&)> dispatchTouchpadPointer;                         // Dispatcher for touchpad pointer events.
+        std::function<void(udptouchpad::MotionSensorEvent)> dispatchMotionSensor;                                             // Dispatcher for motion sensor events.
+        udptouchpad::detail::EventAwaiterList awaiters;                                                                       // Coroutines that wait for the next event.
 
         /* event buffers */
-        udptouchpad::detail::CircularFIFOBuffer<udptouchpad::ErrorEvent, 64> errorBuffer;   // Thread-safe buffer for error messages.
-        udptouchpad::detail::DeviceDatabase deviceDatabase;                                 // Stores data for touchpad pointer and motion sensor events.
+        udptouchpad::detail::LockFreeRingBuffer<udptouchpad::ErrorEvent, 64> errorBuffer;                                     // Lock-free buffer for error messages, the oldest messages are dropped if full.
+        udptouchpad::detail::DeviceDatabase deviceDatabase;                                                                   // Stores data for touchpad pointer and motion sensor events.
+        std::shared_ptr<udptouchpad::detail::ReceiverHub> receiverHub;                                                        // The process-wide receiver hub if a shared receiver is used.
+
+        /**
+         * @brief Run a user-defined callback function and resume all coroutines that wait for the event.
+         * @tparam T The type of the event.
+         * @param[in] callback The user-defined callback function.
+         * @param[in] e The event to be dispatched.
+         */
+        template<class T> void Dispatch(const std::function<void(T)>& callback, T&& e){
+            if(callback){
+                UDP_TOUCHPAD_TRACE_SCOPE("Callback", e.deviceID);
+                callback(e);
+            }
+            if(!awaiters.IsEmpty()){
+                const uint32_t deviceID = e.deviceID;
+                awaiters.Resume(udptouchpad::Event(std::move(e)), true, deviceID);
+            }
+        }
+
+        /**
+         * @brief Run the user-defined callbacks of a compact touchpad pointer event and resume all coroutines that wait for the
+         * event. The event is only converted if a callback or a coroutine requires a @ref TouchpadPointerEvent.
+         * @param[in] e The compact touchpad pointer event to be dispatched.
+         */
+        void DispatchCompact(const udptouchpad::CompactTouchpadPointerEvent& e){
+            if(callbackCompactTouchpadPointer){
+                UDP_TOUCHPAD_TRACE_SCOPE("CompactCallback", e.deviceID);
+                callbackCompactTouchpadPointer(e);
+            }
+            if(callbackTouchpadPointer || !awaiters.IsEmpty()){
+                Dispatch(callbackTouchpadPointer, e.ToTouchpadPointerEvent());
+            }
+        }
 };
 
 
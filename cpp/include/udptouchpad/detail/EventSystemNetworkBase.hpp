@@ -3,9 +3,14 @@
 
 #include <udptouchpad/detail/Common.hpp>
 #include <udptouchpad/detail/NonCopyable.hpp>
-#include <udptouchpad/detail/MulticastSocket.hpp>
+#include <udptouchpad/detail/Transport.hpp>
+#include <udptouchpad/detail/MulticastTransport.hpp>
 #include <udptouchpad/detail/ConditionVariable.hpp>
 #include <udptouchpad/detail/TouchpadMessage.hpp>
+#include <udptouchpad/detail/BatchMessage.hpp>
+#include <udptouchpad/detail/NetworkConfiguration.hpp>
+#include <udptouchpad/detail/MessageSink.hpp>
+#include <udptouchpad/detail/Trace.hpp>
 
 
 namespace udptouchpad {
@@ -15,110 +20,196 @@ namespace detail {
 
 
 /**
- * @brief Abstract base class for the event system that handles all network stuff.
+ * @brief Abstract base class for the event system that handles all network stuff. A worker thread receives datagrams from a
+ * @ref Transport, which is multicast UDP by default. Unpacked messages are passed to the @ref MessageSink interface, which is
+ * implemented by the derived class.
  */
-class EventSystemNetworkBase: public udptouchpad::detail::NonCopyable {
+class EventSystemNetworkBase: public udptouchpad::detail::NonCopyable, public udptouchpad::detail::MessageSink, private udptouchpad::DatagramSink {
     public:
         /**
-         * @brief Construct a new event system base.
+         * @brief Construct a new event system base. The worker thread is not started until @ref StartWorkerThread is called.
          */
         EventSystemNetworkBase(){
             terminate = false;
-            workerThread = std::thread(&EventSystemNetworkBase::ThreadFunction, this);
+            multicastTransport.SetNetworkConfiguration(networkConfiguration);
         }
 
         /**
          * @brief Destroy the event system base.
          */
         virtual ~EventSystemNetworkBase(){
+            StopWorkerThread();
+        }
+
+    protected:
+        /**
+         * @brief Start the worker thread that receives messages. Must be called by the derived class after it has been constructed
+         * completely, because the worker thread calls the pure virtual member functions.
+         * @details Nothing happens if the worker thread is already running.
+         */
+        void StartWorkerThread(void){
+            if(!workerThread.joinable()){
+                terminate = false;
+                retryTimer.Clear();
+                workerThread = std::thread(&EventSystemNetworkBase::ThreadFunction, this);
+            }
+        }
+
+        /**
+         * @brief Stop the worker thread. Must be called by the derived class before it is destroyed, because the worker thread calls
+         * the pure virtual member functions.
+         * @details The transport is woken up and closed by the worker thread itself.
+         */
+        void StopWorkerThread(void){
             terminate = true;
-            udpSocket.Close();
+            GetTransport().WakeUp();
             retryTimer.NotifyOne();
             if(workerThread.joinable()){
                 workerThread.join();
             }
         }
 
-    protected:
         /**
-         * @brief Process an error message.
-         * @param[in] msg The error message to be handled.
+         * @brief Set the network configuration to be used the next time the worker thread is started.
+         * @param[in] configuration The new network configuration.
+         * @details Must only be called while the worker thread is not running.
+         */
+        void SetNetworkConfiguration(const udptouchpad::NetworkConfiguration& configuration){
+            networkConfiguration = configuration;
+            multicastTransport.SetNetworkConfiguration(configuration);
+        }
+
+        /**
+         * @brief Set a user-defined transport to be used the next time the worker thread is started.
+         * @param[in] transport The transport that replaces the multicast transport. If nullptr, the multicast transport is used.
+         * @details Must only be called while the worker thread is not running.
+         */
+        void SetTransport(std::shared_ptr<udptouchpad::Transport> transport){
+            customTransport = transport;
+        }
+
+        /**
+         * @brief Check whether a user-defined transport is set.
+         * @return True if a user-defined transport is set, false if the multicast transport is used.
+         */
+        bool HasCustomTransport(void){ return static_cast<bool>(customTransport); }
+
+        /**
+         * @brief Get the network configuration that is applied when the worker thread starts.
+         * @return The network configuration.
          */
-        virtual void ProcessErrorMessage(const std::string& msg) = 0;
+        const udptouchpad::NetworkConfiguration& GetNetworkConfiguration(void){ return networkConfiguration; }
 
         /**
-         * @brief Process a received touch message.
-         * @param[in] source The source address from where the message was sent.
-         * @param[in] msg The touch message that has been received.
+         * @brief Check whether the worker thread is running or not.
+         * @return True if the worker thread is running, false otherwise.
          */
-        virtual void ProcessTouchMessage(const uint32_t source, const udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg) = 0;
+        bool IsWorkerThreadRunning(void){ return workerThread.joinable(); }
 
     private:
-        std::atomic<bool> terminate;                         // Flag that indicates, whether the worker thread should be terminated or not.
-        std::thread workerThread;                            // Thread object for the worker thread.
-        udptouchpad::detail::MulticastSocket udpSocket;      // Multicast UDP socket.
-        udptouchpad::detail::ConditionVariable retryTimer;   // A timer to wait before retrying to open a UDP socket in case of errors.
+        std::atomic<bool> terminate;                                      // Flag that indicates, whether the worker thread should be terminated or not.
+        std::thread workerThread;                                         // Thread object for the worker thread.
+        udptouchpad::detail::MulticastTransport multicastTransport;       // The default transport that receives via multicast UDP.
+        std::shared_ptr<udptouchpad::Transport> customTransport;          // A user-defined transport that replaces the multicast transport or nullptr.
+        udptouchpad::detail::ConditionVariable retryTimer;                // A timer to wait before retrying to open the transport in case of errors.
+        udptouchpad::NetworkConfiguration networkConfiguration;           // Network configuration that is applied when the worker thread starts.
+
+        /**
+         * @brief Get the transport from which the worker thread receives.
+         * @return The user-defined transport if set, the multicast transport otherwise.
+         */
+        udptouchpad::Transport& GetTransport(void){
+            return customTransport ? *customTransport : static_cast<udptouchpad::Transport&>(multicastTransport);
+        }
 
         /**
          * @brief The worker thread function.
+         * @details The transport is opened, received from until it returns and closed again. Errors are reported once and the
+         * transport is re-opened after the retry time of the network configuration. If the transport is finished, the worker
+         * thread waits until it is stopped.
          */
         void ThreadFunction(void){
-            // local buffer where to store received messages
-            constexpr size_t rxBufferSize = 65507;
-            uint8_t* rxBuffer = new uint8_t[rxBufferSize];
-
+            UDP_TOUCHPAD_TRACE_THREAD_NAME("udptouchpad receive");
+            udptouchpad::Transport& transport = GetTransport();
             std::string previousErrorString;
             while(!terminate){
-                // (re)-open socket
-                if(!udpSocket.Open()){
-                    std::string errorString = udpSocket.GetErrorString();
+                udptouchpad::TransportStatus status = udptouchpad::transport_status_error;
+                if(transport.Open()){
+                    status = terminate ? udptouchpad::transport_status_stopped : transport.Receive(*this);
+                    transport.Close();
+                }
+                if(terminate){
+                    break;
+                }
+                if(udptouchpad::transport_status_error == status){
+                    std::string errorString = transport.GetErrorString();
                     if(errorString.compare(previousErrorString)){
                         previousErrorString = errorString;
                         ProcessErrorMessage(errorString);
                     }
-                    retryTimer.WaitFor(UDP_TOUCHPAD_REOPEN_SOCKET_RETRY_TIME_MS);
-                    continue;
+                    retryTimer.WaitFor(networkConfiguration.retryTimeMs);
                 }
-
-                // receive and unpack
-                while(!terminate && udpSocket.IsOpen()){
-                    uint32_t source;
-                    auto [rx, errorCode] = udpSocket.ReceiveFrom(source, &rxBuffer[0], rxBufferSize);
-                    if(!udpSocket.IsOpen() || terminate){
-                        break;
-                    }
-                    if(rx < 0){
-                        #ifdef _WIN32
-                        if(WSAEMSGSIZE == errorCode){
-                            continue;
-                        }
-                        #endif
-                        retryTimer.WaitFor(UDP_TOUCHPAD_REOPEN_SOCKET_RETRY_TIME_MS);
-                        break;
-                    }
-                    UnpackMessage(source, &rxBuffer[0], rx);
-                    std::this_thread::yield();
+                else if(udptouchpad::transport_status_finished == status){
+                    retryTimer.Wait();
                 }
-
-                // terminate the socket
-                udpSocket.Close();
             }
-            delete[] rxBuffer;
+        }
+
+        /**
+         * @brief Process a datagram that has been received by the transport.
+         * @param[in] source The source address from where the datagram was sent.
+         * @param[in] endpoint Index of the network endpoint on which the datagram has been received.
+         * @param[in] bytes The bytes of the datagram.
+         * @param[in] length The number of bytes.
+         * @param[in] timestamp Time when the datagram has been received.
+         */
+        void ProcessDatagram(const uint32_t source, const uint16_t endpoint, uint8_t* bytes, const int32_t length, const std::chrono::time_point<std::chrono::steady_clock> timestamp){
+            UnpackMessage(source, endpoint, bytes, length, timestamp);
+        }
+
+        /**
+         * @brief Process an error of the transport that does not stop receiving.
+         * @param[in] msg The error message.
+         */
+        void ProcessTransportError(const std::string& msg){
+            ProcessErrorMessage(msg);
+        }
+
+        /**
+         * @brief Process datagrams that have been dropped before the transport could receive them.
+         * @param[in] endpoint Index of the network endpoint on which the datagrams have been dropped.
+         * @param[in] numDropped Number of datagrams that have been dropped, because the receive buffer was full.
+         * @param[in] numRejected Number of datagrams that have been rejected by a filter.
+         */
+        void ProcessDroppedDatagrams(const uint16_t endpoint, const uint64_t numDropped, const uint64_t numRejected){
+            ProcessDroppedMessages(endpoint, numDropped, numRejected);
         }
 
         /**
          * @brief Process a received UDP message.
          * @param[in] source The source from which the message was sent.
+         * @param[in] endpoint Index of the network endpoint on which the message has been received.
          * @param[in] bytes The bytes containing the message.
          * @param[in] length The length of the received UDP message.
+         * @param[in] timestamp Time when the message has been received.
+         * @details Single touchpad messages (header 0x42) and batched touchpad messages (header 0x43) are supported. The
+         * samples of a batched message are processed in the order of transmission, where the receive time of each sample
+         * is reconstructed from its timestamp.
          */
-        void UnpackMessage(uint32_t source, uint8_t* bytes, int32_t length){
-            if(length == sizeof(udptouchpad::detail::SerializationTouchpadMessageUnion)){
+        void UnpackMessage(uint32_t source, uint16_t endpoint, uint8_t* bytes, int32_t length, const std::chrono::time_point<std::chrono::steady_clock> timestamp){
+            if(length < 1){
+                return;
+            }
+            UDP_TOUCHPAD_TRACE_SCOPE("UnpackMessage", length);
+            if((0x42 == bytes[0]) && (length == sizeof(udptouchpad::detail::SerializationTouchpadMessageUnion))){
                 udptouchpad::detail::SerializationTouchpadMessageUnion* msg = reinterpret_cast<udptouchpad::detail::SerializationTouchpadMessageUnion*>(bytes);
-                if(0x42 == msg->data.header){
-                    udptouchpad::detail::NetworkToNativeByteOrder(*msg);
-                    ProcessTouchMessage(source, msg->data);
-                }
+                udptouchpad::detail::NetworkToNativeByteOrder(*msg);
+                ProcessTouchMessage(source, endpoint, msg->data, timestamp);
+            }
+            else if(0x43 == bytes[0]){
+                udptouchpad::detail::DecodeBatchMessage(bytes, static_cast<size_t>(length), [this, source, endpoint, timestamp](const udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg, uint32_t age){
+                    ProcessTouchMessage(source, endpoint, msg, timestamp - std::chrono::microseconds(age));
+                });
             }
         }
 };
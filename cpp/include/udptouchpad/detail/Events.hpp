@@ -87,20 +87,24 @@ class ErrorEvent: udptouchpad::detail::EventBase {
  */
 class DeviceConnectionEvent: udptouchpad::detail::EventBase {
     public:
-        uint32_t deviceID;   // The device ID, which is equal to the IPv4 address.
-        bool connected;      // True if this device has been connected (incomming data), false if it is disconnected (timeout).
+        uint32_t deviceID;                                              // The device ID, which is equal to the IPv4 address.
+        uint16_t endpoint;                                              // Index of the network endpoint on which the messages of the device are received, see @ref NetworkConfiguration::endpoints.
+        bool connected;                                                 // True if this device has been connected (incomming data), false if it is disconnected (timeout).
+        std::chrono::time_point<std::chrono::steady_clock> timestamp;   // Timepoint when the first message has been received (connected) or when the timeout has been detected (disconnected).
 
         /**
          * @brief Construct a new device connection event.
          */
-        DeviceConnectionEvent(): udptouchpad::detail::EventBase(udptouchpad::detail::EventType::event_type_connection), deviceID(0), connected(false) {}
+        DeviceConnectionEvent(): udptouchpad::detail::EventBase(udptouchpad::detail::EventType::event_type_connection), deviceID(0), endpoint(0), connected(false) {}
 
         /**
          * @brief Construct a new device connection event.
          * @param[in] deviceID The device ID, which is equal to the IPv4 address.
          * @param[in] connected True if this device has been connected (incomming data), false if it is disconnected (timeout).
+         * @param[in] timestamp Timepoint when the first message has been received (connected) or when the timeout has been detected (disconnected).
+         * @param[in] endpoint Index of the network endpoint on which the messages of the device are received.
          */
-        DeviceConnectionEvent(uint32_t deviceID, bool connected): udptouchpad::detail::EventBase(udptouchpad::detail::EventType::event_type_connection), deviceID(deviceID), connected(connected){}
+        DeviceConnectionEvent(uint32_t deviceID, bool connected, std::chrono::time_point<std::chrono::steady_clock> timestamp = std::chrono::steady_clock::now(), uint16_t endpoint = 0): udptouchpad::detail::EventBase(udptouchpad::detail::EventType::event_type_connection), deviceID(deviceID), endpoint(endpoint), connected(connected), timestamp(timestamp){}
 
         /**
          * @brief Convert this event to a string.
@@ -119,14 +123,16 @@ class DeviceConnectionEvent: udptouchpad::detail::EventBase {
  */
 class TouchpadPointerEvent: udptouchpad::detail::EventBase {
     public:
-        uint32_t deviceID;                         // The device ID, which is equal to the IPv4 address.
-        double aspectRatio;                        // Aspect ratio of the touch screen, given as width/height.
-        std::array<TouchpadPointer, 10> pointer;   // List of touch pointers.
+        uint32_t deviceID;                                              // The device ID, which is equal to the IPv4 address.
+        uint16_t endpoint;                                              // Index of the network endpoint on which the messages of the device are received, see @ref NetworkConfiguration::endpoints.
+        std::chrono::time_point<std::chrono::steady_clock> timestamp;   // Timepoint when the underlying message has been received.
+        double aspectRatio;                                             // Aspect ratio of the touch screen, given as width/height.
+        std::array<TouchpadPointer, 10> pointer;                        // List of touch pointers.
 
         /**
          * @brief Construct a new touchpad pointer event.
          */
-        TouchpadPointerEvent(): udptouchpad::detail::EventBase(udptouchpad::detail::event_type_touchpad_pointer), deviceID(0), aspectRatio(0.0) {}
+        TouchpadPointerEvent(): udptouchpad::detail::EventBase(udptouchpad::detail::event_type_touchpad_pointer), deviceID(0), endpoint(0), aspectRatio(0.0) {}
 
         /**
          * @brief Convert this event to a string.
@@ -156,7 +162,7 @@ class TouchpadPointerEvent: udptouchpad::detail::EventBase {
          * @return True is e is equal to this, false otherwise.
          */
         bool IsEqual(const TouchpadPointerEvent& e) const {
-            bool result = (deviceID == e.deviceID) && (aspectRatio == e.aspectRatio);
+            bool result = (deviceID == e.deviceID) && (endpoint == e.endpoint) && (aspectRatio == e.aspectRatio);
             for(size_t i = 0; i < pointer.size(); ++i){
                 result &= pointer[i].IsEqual(e.pointer[i]);
             }
@@ -170,15 +176,17 @@ class TouchpadPointerEvent: udptouchpad::detail::EventBase {
  */
 class MotionSensorEvent: udptouchpad::detail::EventBase {
     public:
-        uint32_t deviceID;                    // The device ID, which is equal to the IPv4 address.
-        std::array<float,3> rotationVector;   // Latest 3D rotation vector sensor data from an onboard motion sensor. If no motion sensor is available, all three values are NaN.
-        std::array<float,3> acceleration;     // Latest 3D accelerometer sensor data from an onboard motion sensor in m/s^2. If no motion sensor is available, all three values are NaN.
-        std::array<float,3> angularRate;      // Latest 3D gyroscope sensor data from an onboard motion sensor in rad/s. If no motion sensor is available, all three values are NaN.
+        uint32_t deviceID;                                              // The device ID, which is equal to the IPv4 address.
+        uint16_t endpoint;                                              // Index of the network endpoint on which the messages of the device are received, see @ref NetworkConfiguration::endpoints.
+        std::chrono::time_point<std::chrono::steady_clock> timestamp;   // Timepoint when the underlying message has been received.
+        std::array<float,3> rotationVector;                             // Latest 3D rotation vector sensor data from an onboard motion sensor. If no motion sensor is available, all three values are NaN.
+        std::array<float,3> acceleration;                               // Latest 3D accelerometer sensor data from an onboard motion sensor in m/s^2. If no motion sensor is available, all three values are NaN.
+        std::array<float,3> angularRate;                                // Latest 3D gyroscope sensor data from an onboard motion sensor in rad/s. If no motion sensor is available, all three values are NaN.
 
         /**
          * @brief Construct a new motion sensor event.
          */
-        MotionSensorEvent(): udptouchpad::detail::EventBase(udptouchpad::detail::event_type_motion_sensor), deviceID(0) {
+        MotionSensorEvent(): udptouchpad::detail::EventBase(udptouchpad::detail::event_type_motion_sensor), deviceID(0), endpoint(0) {
             rotationVector.fill(std::numeric_limits<float>::quiet_NaN());
             acceleration.fill(std::numeric_limits<float>::quiet_NaN());
             angularRate.fill(std::numeric_limits<float>::quiet_NaN());
@@ -203,7 +211,7 @@ class MotionSensorEvent: udptouchpad::detail::EventBase {
          * @return True is e is equal to this, false otherwise.
          */
         bool IsEqual(const MotionSensorEvent& e) const {
-            return (deviceID == e.deviceID) &&
+            return (deviceID == e.deviceID) && (endpoint == e.endpoint) &&
                    (rotationVector[0] == e.rotationVector[0]) && (rotationVector[1] == e.rotationVector[1]) && (rotationVector[2] == e.rotationVector[2]) &&
                    (acceleration[0] == e.acceleration[0]) && (acceleration[1] == e.acceleration[1]) && (acceleration[2] == e.acceleration[2]) &&
                    (angularRate[0] == e.angularRate[0]) && (angularRate[1] == e.angularRate[1]) && (angularRate[2] == e.angularRate[2]);
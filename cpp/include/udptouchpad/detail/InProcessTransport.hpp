@@ -0,0 +1,250 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/Transport.hpp>
+#include <udptouchpad/detail/LockFreeRingBuffer.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief A datagram that is passed through an @ref InProcessTransport.
+ */
+struct InProcessDatagram {
+    uint32_t source;                                                      // The source address, which is used as device ID.
+    uint16_t endpoint;                                                    // Index of the network endpoint.
+    int32_t length;                                                       // Number of valid bytes.
+    std::chrono::time_point<std::chrono::steady_clock> timestamp;         // Time when the datagram has been received.
+    std::array<uint8_t, UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE> bytes;       // The bytes of the datagram in network byte order.
+};
+
+
+} /* namespace: detail */
+
+
+/**
+ * @brief A lock-free channel that passes datagrams from any thread of the same process to an event system. No sockets are
+ * involved and the receive thread never sleeps while datagrams are pending, which allows tests and benchmarks to drive the
+ * complete decode and event pipeline deterministically and at maximum speed.
+ * @details Datagrams are sent as they would arrive on the network, that is single touchpad messages (header 0x42) and batched
+ * touchpad messages (header 0x43) in network byte order. The channel holds @ref UDP_TOUCHPAD_IN_PROCESS_TRANSPORT_CAPACITY
+ * datagrams. Waiting is done via atomic wait and notify.
+ */
+class InProcessTransport: public udptouchpad::Transport {
+    public:
+        /**
+         * @brief Construct a new in-process transport.
+         */
+        InProcessTransport(): signal(0), numSent(0), numProcessed(0), senders(0), wakeRequested(false), finished(false){
+            queue = std::make_unique<udptouchpad::detail::LockFreeRingBuffer<udptouchpad::detail::InProcessDatagram, UDP_TOUCHPAD_IN_PROCESS_TRANSPORT_CAPACITY>>();
+        }
+
+        /**
+         * @brief Send a datagram and wait while the channel is full.
+         * @param[in] source The source address, which is used as device ID.
+         * @param[in] endpoint Index of the network endpoint on which the datagram is to be received.
+         * @param[in] bytes The bytes of the datagram in network byte order.
+         * @param[in] length The number of bytes, at most @ref UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE.
+         * @param[in] timestamp Time when the datagram is to be received, the current time by default.
+         * @return True if success, false if the datagram is too large or @ref Finish has been called.
+         * @details This call is thread-safe. If the channel is full, this call waits until the event system has processed
+         * datagrams. It must therefore not be called while the event system is stopped.
+         */
+        bool Send(const uint32_t source, const uint16_t endpoint, const uint8_t* bytes, const size_t length, const std::chrono::time_point<std::chrono::steady_clock> timestamp = std::chrono::steady_clock::now()){
+            udptouchpad::detail::InProcessDatagram d;
+            if(!PrepareDatagram(d, source, endpoint, bytes, length, timestamp) || !BeginSend()){
+                return false;
+            }
+            for(;;){
+                uint64_t processed = numProcessed.load(std::memory_order_acquire);
+                if(queue->TryPush(d)){
+                    break;
+                }
+                numProcessed.wait(processed, std::memory_order_acquire);
+            }
+            NotifyReceiver();
+            EndSend();
+            return true;
+        }
+
+        /**
+         * @brief Try to send a datagram without waiting.
+         * @param[in] source The source address, which is used as device ID.
+         * @param[in] endpoint Index of the network endpoint on which the datagram is to be received.
+         * @param[in] bytes The bytes of the datagram in network byte order.
+         * @param[in] length The number of bytes, at most @ref UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE.
+         * @param[in] timestamp Time when the datagram is to be received, the current time by default.
+         * @return True if success, false if the channel is full, the datagram is too large or @ref Finish has been called.
+         * @details This call is thread-safe and lock-free.
+         */
+        bool TrySend(const uint32_t source, const uint16_t endpoint, const uint8_t* bytes, const size_t length, const std::chrono::time_point<std::chrono::steady_clock> timestamp = std::chrono::steady_clock::now()){
+            udptouchpad::detail::InProcessDatagram d;
+            if(!PrepareDatagram(d, source, endpoint, bytes, length, timestamp) || !BeginSend()){
+                return false;
+            }
+            bool success = queue->TryPush(d);
+            if(success){
+                NotifyReceiver();
+            }
+            EndSend();
+            return success;
+        }
+
+        /**
+         * @brief Wait until all datagrams that have been sent so far have been passed to the event system. Events of these
+         * datagrams can be polled as soon as this call returns.
+         * @details Must not be called while the event system is stopped.
+         */
+        void Flush(void){
+            uint64_t target = numSent.load(std::memory_order_acquire);
+            uint64_t processed;
+            while((processed = numProcessed.load(std::memory_order_acquire)) < target){
+                numProcessed.wait(processed, std::memory_order_acquire);
+            }
+        }
+
+        /**
+         * @brief Indicate that no more datagrams are sent. The event system processes all pending datagrams and then stops
+         * receiving, while already received events can still be polled.
+         * @details Datagrams that are sent after this call are rejected. This call waits for sends that are in progress, so
+         * that their datagrams are processed before the event system stops receiving.
+         */
+        void Finish(void){
+            uint64_t s = senders.fetch_or(closedBit, std::memory_order_acq_rel) | closedBit;
+            while(closedBit != s){
+                senders.wait(s, std::memory_order_acquire);
+                s = senders.load(std::memory_order_acquire);
+            }
+            finished = true;
+            signal.fetch_add(1, std::memory_order_release);
+            signal.notify_one();
+        }
+
+        /**
+         * @brief Open the transport. Pending wake-up requests are cleared.
+         * @return Always true.
+         */
+        bool Open(void){
+            wakeRequested = false;
+            return true;
+        }
+
+        /**
+         * @brief Close the transport. Pending datagrams are kept.
+         */
+        void Close(void){}
+
+        /**
+         * @brief Pass all datagrams to a sink until @ref WakeUp or @ref Finish is called.
+         * @param[in] sink The sink to which all datagrams are passed.
+         * @return The reason why receiving has returned.
+         */
+        udptouchpad::TransportStatus Receive(udptouchpad::DatagramSink& sink){
+            while(!wakeRequested){
+                uint32_t expected = signal.load(std::memory_order_acquire);
+                bool done = finished;
+                uint64_t count = 0;
+                while((count < UDP_TOUCHPAD_IN_PROCESS_TRANSPORT_CAPACITY) && queue->TryPop(datagram)){
+                    sink.ProcessDatagram(datagram.source, datagram.endpoint, &datagram.bytes[0], datagram.length, datagram.timestamp);
+                    count++;
+                }
+                if(count){
+                    numProcessed.fetch_add(count, std::memory_order_release);
+                    numProcessed.notify_all();
+                    continue;
+                }
+                if(done){
+                    return udptouchpad::transport_status_finished;
+                }
+                signal.wait(expected, std::memory_order_acquire);
+            }
+            return udptouchpad::transport_status_stopped;
+        }
+
+        /**
+         * @brief Make @ref Receive return as soon as possible. This member function can be called from any thread.
+         */
+        void WakeUp(void){
+            wakeRequested = true;
+            signal.fetch_add(1, std::memory_order_release);
+            signal.notify_one();
+        }
+
+        /**
+         * @brief Get the last error string. The in-process transport never fails.
+         * @return An empty string.
+         */
+        std::string GetErrorString(void){ return std::string(); }
+
+    private:
+        static constexpr uint64_t closedBit = uint64_t(1) << 63;                                                                                              // Bit of @ref senders that rejects new sends.
+        std::unique_ptr<udptouchpad::detail::LockFreeRingBuffer<udptouchpad::detail::InProcessDatagram, UDP_TOUCHPAD_IN_PROCESS_TRANSPORT_CAPACITY>> queue;   // Lock-free channel of datagrams.
+        std::atomic<uint32_t> signal;                                                                                                                         // Incremented whenever the receiver is to be woken up.
+        std::atomic<uint64_t> numSent;                                                                                                                        // Number of datagrams that have been sent.
+        std::atomic<uint64_t> numProcessed;                                                                                                                   // Number of datagrams that have been passed to the sink.
+        std::atomic<uint64_t> senders;                                                                                                                        // Number of sends in progress, @ref closedBit is set as soon as @ref Finish has been called.
+        std::atomic<bool> wakeRequested;                                                                                                                      // True if @ref WakeUp has been called since the transport has been opened.
+        std::atomic<bool> finished;                                                                                                                           // True if @ref Finish has been called and no send is in progress.
+        udptouchpad::detail::InProcessDatagram datagram;                                                                                                      // Datagram that is currently processed by the receiver.
+
+        /**
+         * @brief Copy the bytes and properties of a datagram.
+         * @param[out] d The datagram to be prepared.
+         * @param[in] source The source address.
+         * @param[in] endpoint Index of the network endpoint.
+         * @param[in] bytes The bytes of the datagram.
+         * @param[in] length The number of bytes.
+         * @param[in] timestamp Time when the datagram is to be received.
+         * @return True if success, false if the datagram is too large.
+         */
+        bool PrepareDatagram(udptouchpad::detail::InProcessDatagram& d, const uint32_t source, const uint16_t endpoint, const uint8_t* bytes, const size_t length, const std::chrono::time_point<std::chrono::steady_clock> timestamp){
+            if(length > UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE){
+                return false;
+            }
+            d.source = source;
+            d.endpoint = endpoint;
+            d.length = static_cast<int32_t>(length);
+            d.timestamp = timestamp;
+            std::memcpy(&d.bytes[0], bytes, length);
+            return true;
+        }
+
+        /**
+         * @brief Register a send that is in progress.
+         * @return True if success, false if @ref Finish has been called. @ref EndSend must be called if true is returned.
+         */
+        bool BeginSend(void){
+            if(senders.fetch_add(1, std::memory_order_acq_rel) & closedBit){
+                EndSend();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Unregister a send that has been registered by @ref BeginSend and wake up a waiting @ref Finish.
+         */
+        void EndSend(void){
+            if(senders.fetch_sub(1, std::memory_order_acq_rel) & closedBit){
+                senders.notify_all();
+            }
+        }
+
+        /**
+         * @brief Count a sent datagram and wake up the receiver.
+         */
+        void NotifyReceiver(void){
+            numSent.fetch_add(1, std::memory_order_release);
+            signal.fetch_add(1, std::memory_order_release);
+            signal.notify_one();
+        }
+};
+
+
+} /* namespace: udptouchpad */
+
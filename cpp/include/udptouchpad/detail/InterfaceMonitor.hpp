@@ -0,0 +1,175 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+#ifdef __linux__
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#endif
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+#ifdef __linux__
+
+
+/**
+ * @brief Monitors network interfaces via rtnetlink. The netlink socket is subscribed to link and IPv4 address changes, so
+ * that the multicast membership can be updated as soon as an interface appears, disappears or obtains a new address.
+ */
+class InterfaceMonitor: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Construct a new interface monitor.
+         */
+        InterfaceMonitor(): fd(-1) {}
+
+        /**
+         * @brief Destroy the interface monitor.
+         */
+        ~InterfaceMonitor(){ Close(); }
+
+        /**
+         * @brief Open the netlink socket and subscribe to link and IPv4 address changes.
+         * @return True if success or already open, false otherwise.
+         */
+        bool Open(void){
+            if(fd >= 0){
+                return true;
+            }
+            fd = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+            if(fd < 0){
+                return false;
+            }
+            sockaddr_nl addr{};
+            addr.nl_family = AF_NETLINK;
+            addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR;
+            if(bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0){
+                Close();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Close the netlink socket.
+         */
+        void Close(void){
+            if(fd >= 0){
+                (void) close(fd);
+            }
+            fd = -1;
+        }
+
+        /**
+         * @brief Check whether the monitor is open or not.
+         * @return True if open, false otherwise.
+         */
+        bool IsOpen(void){ return fd >= 0; }
+
+        /**
+         * @brief Get the descriptor of the netlink socket, which becomes readable if interfaces changed.
+         * @return The descriptor or -1 if the monitor is not open.
+         */
+        int GetDescriptor(void){ return fd; }
+
+        /**
+         * @brief Read all pending netlink messages without blocking.
+         * @param[out] refreshedInterfaces Indices of interfaces that obtained a new IPv4 address (e.g. after a reconnect). The container is
+         * cleared first. Multicast memberships on these interfaces should be renewed, so that routers learn about them again.
+         * @return True if any interface changed or if notifications have been lost, false otherwise.
+         */
+        bool ReadChanges(std::vector<uint32_t>& refreshedInterfaces){
+            refreshedInterfaces.clear();
+            bool changed = false;
+            while(fd >= 0){
+                ssize_t rx = recv(fd, &buffer[0], buffer.size(), MSG_DONTWAIT);
+                if(rx < 0){
+                    if(EINTR == errno){
+                        continue;
+                    }
+                    changed |= (ENOBUFS == errno); // notifications have been lost, so the state must be resynchronized
+                    break;
+                }
+                int length = static_cast<int>(rx);
+                for(const nlmsghdr* h = reinterpret_cast<const nlmsghdr*>(&buffer[0]); NLMSG_OK(h, static_cast<uint32_t>(length)); h = NLMSG_NEXT(h, length)){
+                    switch(h->nlmsg_type){
+                        case RTM_NEWADDR:
+                            refreshedInterfaces.push_back(reinterpret_cast<const ifaddrmsg*>(NLMSG_DATA(h))->ifa_index);
+                            changed = true;
+                            break;
+                        case RTM_NEWLINK: // wireless drivers report link messages frequently, so memberships are not renewed
+                        case RTM_DELLINK:
+                        case RTM_DELADDR:
+                            changed = true;
+                            break;
+                    }
+                }
+            }
+            return changed;
+        }
+
+    private:
+        int fd;                               // The netlink socket.
+        std::array<uint8_t, 8192> buffer;     // Receive buffer for netlink messages.
+};
+
+
+#else
+
+
+/**
+ * @brief Placeholder for operating systems without rtnetlink. @ref Open always fails, so that interface changes are only
+ * detected by re-opening the socket.
+ */
+class InterfaceMonitor: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Open the monitor.
+         * @return Always false.
+         */
+        bool Open(void){ return false; }
+
+        /**
+         * @brief Close the monitor.
+         */
+        void Close(void){}
+
+        /**
+         * @brief Check whether the monitor is open or not.
+         * @return Always false.
+         */
+        bool IsOpen(void){ return false; }
+
+        /**
+         * @brief Get the descriptor of the monitor.
+         * @return Always -1.
+         */
+        int GetDescriptor(void){ return -1; }
+
+        /**
+         * @brief Read all pending changes.
+         * @param[out] refreshedInterfaces Cleared.
+         * @return Always false.
+         */
+        bool ReadChanges(std::vector<uint32_t>& refreshedInterfaces){
+            refreshedInterfaces.clear();
+            return false;
+        }
+};
+
+
+#endif
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
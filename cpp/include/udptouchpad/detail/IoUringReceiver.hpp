@@ -0,0 +1,513 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+#include <udptouchpad/detail/TouchpadMessage.hpp>
+#if defined(__linux__) && defined(UDP_TOUCHPAD_ENABLE_IO_URING)
+#include <cstddef>
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#endif
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+#if defined(__linux__) && defined(UDP_TOUCHPAD_ENABLE_IO_URING)
+
+
+/**
+ * @brief Receives UDP messages from a socket via io_uring. A single multishot recvmsg request delivers all datagrams into a
+ * ring of provided buffers, so that one io_uring_enter syscall can complete many messages and no per-message syscall is made.
+ * @details The io_uring interface is accessed via raw syscalls, no liburing is required. If io_uring is not supported by the
+ * kernel, @ref Open fails and the caller should fall back to @ref MulticastSocket::ReceiveFrom.
+ */
+class IoUringReceiver: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Construct a new io_uring receiver.
+         */
+        IoUringReceiver(): ringFD(-1), socketFD(-1), monitorFD(-1), sqRing(nullptr), sqRingSize(0), cqRing(nullptr), cqRingSize(0), sqes(nullptr), sqesSize(0), bufferRing(nullptr), bufferRingTail(nullptr), bufferMemory(nullptr), bufferMemorySize(0), bufferTail(0), armed(false), wakeUpPending(false), monitorPending(false), dropCounter(0) {
+            wakeFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        }
+
+        /**
+         * @brief Destroy the io_uring receiver.
+         */
+        ~IoUringReceiver(){
+            Close();
+            if(bufferMemory){
+                (void) munmap(bufferMemory, bufferMemorySize);
+            }
+            if(wakeFD >= 0){
+                (void) close(wakeFD);
+            }
+        }
+
+        /**
+         * @brief Create the io_uring instance, register the provided buffer ring and arm the multishot receive request.
+         * @param[in] socket The socket descriptor from which to receive.
+         * @param[in] monitor Optional descriptor of an interface monitor that is polled along with the socket or -1 if not used.
+         * @return True if success, false otherwise.
+         * @details If this member function fails, use @ref GetErrorString to obtain error information.
+         */
+        bool Open(int socket, int monitor = -1){
+            Close();
+            socketFD = socket;
+            monitorFD = monitor;
+
+            // create the ring
+            io_uring_params params{};
+            params.flags = IORING_SETUP_CQSIZE;
+            params.cq_entries = 2 * numBuffers;
+            ringFD = static_cast<int>(syscall(__NR_io_uring_setup, 4, &params));
+            if(ringFD < 0){
+                return Fail("Failed to set up io_uring!");
+            }
+
+            // map submission queue, completion queue and submission queue entries
+            sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+            cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            if(params.features & IORING_FEAT_SINGLE_MMAP){
+                sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+            }
+            sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_SQ_RING);
+            if(MAP_FAILED == sqRing){
+                sqRing = nullptr;
+                return Fail("Failed to map io_uring submission queue!");
+            }
+            if(params.features & IORING_FEAT_SINGLE_MMAP){
+                cqRing = sqRing;
+            }
+            else{
+                cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_CQ_RING);
+                if(MAP_FAILED == cqRing){
+                    cqRing = nullptr;
+                    return Fail("Failed to map io_uring completion queue!");
+                }
+            }
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = reinterpret_cast<io_uring_sqe*>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_SQES));
+            if(MAP_FAILED == sqes){
+                sqes = nullptr;
+                return Fail("Failed to map io_uring submission queue entries!");
+            }
+            uint8_t* sq = reinterpret_cast<uint8_t*>(sqRing);
+            uint8_t* cq = reinterpret_cast<uint8_t*>(cqRing);
+            sqTail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+            sqMask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+            sqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+            cqHead = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+            cqMask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            // allocate the provided buffer ring, followed by the buffers themselves, only once and register it with the new ring
+            if(!bufferMemory){
+                bufferMemorySize = numBuffers * sizeof(io_uring_buf) + numBuffers * bufferSize;
+                bufferMemory = mmap(nullptr, bufferMemorySize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+                if(MAP_FAILED == bufferMemory){
+                    bufferMemory = nullptr;
+                    return Fail("Failed to allocate io_uring buffers!");
+                }
+            }
+            // the ring is accessed as array of io_uring_buf, where the tail overlays the reserved field of the first entry: the
+            // flexible array member of io_uring_buf_ring is not placed at offset zero by all C++ compilers
+            bufferRing = reinterpret_cast<io_uring_buf*>(bufferMemory);
+            bufferRingTail = reinterpret_cast<uint16_t*>(reinterpret_cast<uint8_t*>(bufferMemory) + offsetof(io_uring_buf, resv));
+            io_uring_buf_reg reg{};
+            reg.ring_addr = reinterpret_cast<uint64_t>(bufferRing);
+            reg.ring_entries = numBuffers;
+            reg.bgid = bufferGroup;
+            if(syscall(__NR_io_uring_register, ringFD, IORING_REGISTER_PBUF_RING, &reg, 1) < 0){
+                return Fail("Failed to register io_uring buffer ring!");
+            }
+            for(uint16_t i = 0; i < numBuffers; ++i){
+                ProvideBuffer(i, i);
+            }
+            bufferTail = numBuffers;
+            std::atomic_ref<uint16_t>(*bufferRingTail).store(bufferTail, std::memory_order_release);
+
+            // arm the multishot receive request and the wake-up poll request
+            if(!Arm()){
+                return Fail("Failed to submit io_uring receive request!");
+            }
+            if(!ArmWakeUp()){
+                return Fail("Failed to submit io_uring wake-up request!");
+            }
+            if((monitorFD >= 0) && !ArmMonitor()){
+                return Fail("Failed to submit io_uring interface monitor request!");
+            }
+            errorString.clear();
+            return true;
+        }
+
+        /**
+         * @brief Destroy the io_uring instance, which unregisters all buffers. The buffer memory is kept and reused by the next
+         * call to @ref Open.
+         */
+        void Close(void){
+            if(sqes){
+                (void) munmap(sqes, sqesSize);
+            }
+            if(cqRing && (cqRing != sqRing)){
+                (void) munmap(cqRing, cqRingSize);
+            }
+            if(sqRing){
+                (void) munmap(sqRing, sqRingSize);
+            }
+            if(ringFD >= 0){
+                (void) close(ringFD);
+            }
+            ringFD = -1;
+            socketFD = -1;
+            monitorFD = -1;
+            sqRing = cqRing = nullptr;
+            sqes = nullptr;
+            bufferRing = nullptr;
+            bufferRingTail = nullptr;
+            armed = false;
+            wakeUpPending = false;
+            monitorPending = false;
+        }
+
+        /**
+         * @brief Check whether the receiver is open or not.
+         * @return True if open, false otherwise.
+         */
+        bool IsOpen(void){ return ringFD >= 0; }
+
+        /**
+         * @brief Get the last error string that has been set by @ref Open.
+         * @return String giving information about the last error.
+         */
+        std::string GetErrorString(void){ return errorString; }
+
+        /**
+         * @brief Get the cumulative number of dropped datagrams that the kernel attached to the latest received message
+         * (SO_RXQ_OVFL), see @ref MulticastSocket::CountDroppedDatagrams.
+         * @return The cumulative drop counter of the socket.
+         */
+        uint32_t GetDropCounter(void){ return dropCounter; }
+
+        /**
+         * @brief Wake up a thread that is blocked in @ref Receive. This member function can be called from any thread.
+         */
+        void WakeUp(void){
+            if(wakeFD >= 0){
+                uint64_t value = 1;
+                (void) !write(wakeFD, &value, sizeof(value));
+            }
+        }
+
+        /**
+         * @brief Wait for at least one received message and process all completed messages.
+         * @param[in] callback Callback function with prototype void(uint32_t source, uint8_t* bytes, int32_t length) that is called for each message.
+         * @param[in] monitorCallback Callback function with prototype void(void) that is called if the interface monitor became readable.
+         * @return The number of completions that have been processed or a negative error code if receiving failed. If the socket has
+         * been shut down, -ESHUTDOWN is returned. If the kernel did not use any provided buffer, -ENOBUFS is returned and the caller
+         * should fall back to another receive path.
+         */
+        template<class Callback, class MonitorCallback> int32_t Receive(Callback&& callback, MonitorCallback&& monitorCallback){
+            if(syscall(__NR_io_uring_enter, ringFD, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0){
+                if(EINTR == errno){
+                    return 0;
+                }
+                return -static_cast<int32_t>(errno);
+            }
+            int32_t numProcessed = 0;
+            int32_t result = 0;
+            uint16_t numReturned = 0;
+            uint32_t head = *cqHead;
+            uint32_t tail = std::atomic_ref<uint32_t>(*cqTail).load(std::memory_order_acquire);
+            for(; head != tail; ++head){
+                const io_uring_cqe& cqe = cqes[head & cqMask];
+                numProcessed++;
+                if(wakeUpUserData == cqe.user_data){
+                    uint64_t value;
+                    (void) !read(wakeFD, &value, sizeof(value));
+                    wakeUpPending = true;
+                    continue;
+                }
+                if(monitorUserData == cqe.user_data){
+                    monitorPending = true;
+                    continue;
+                }
+                if(!(cqe.flags & IORING_CQE_F_MORE)){
+                    armed = false;
+                }
+                if(cqe.res <= 0){
+                    // all buffers are returned before waiting, so running out of buffers without having consumed any means
+                    // that the buffer ring is not usable, otherwise the request is simply re-armed
+                    if((-ENOBUFS == cqe.res) && !numReturned){
+                        result = -ENOBUFS;
+                    }
+                    else if(-ENOBUFS != cqe.res){
+                        result = cqe.res ? cqe.res : -ESHUTDOWN;
+                    }
+                    continue;
+                }
+                if(!(cqe.flags & IORING_CQE_F_BUFFER)){
+                    continue;
+                }
+                uint16_t bufferID = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                uint8_t* buffer = Buffer(bufferID);
+                const io_uring_recvmsg_out* out = reinterpret_cast<const io_uring_recvmsg_out*>(buffer);
+                if(!(out->flags & MSG_TRUNC) && (out->namelen >= sizeof(sockaddr_in))){
+                    const sockaddr_in* addr = reinterpret_cast<const sockaddr_in*>(buffer + sizeof(io_uring_recvmsg_out));
+                    uint8_t* payload = buffer + sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in) + controlSize;
+                    ReadDropCounter(buffer + sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in), out->controllen);
+                    callback(ntohl(addr->sin_addr.s_addr), payload, static_cast<int32_t>(out->payloadlen));
+                }
+                ProvideBuffer(bufferID, static_cast<uint16_t>(bufferTail + numReturned));
+                numReturned++;
+            }
+            std::atomic_ref<uint32_t>(*cqHead).store(head, std::memory_order_release);
+            if(numReturned){
+                bufferTail = static_cast<uint16_t>(bufferTail + numReturned);
+                std::atomic_ref<uint16_t>(*bufferRingTail).store(bufferTail, std::memory_order_release);
+            }
+            if(result < 0){
+                return result;
+            }
+            if(!armed && !Arm()){
+                return -static_cast<int32_t>(errno);
+            }
+            if(wakeUpPending && !ArmWakeUp()){
+                return -static_cast<int32_t>(errno);
+            }
+            if(monitorPending){
+                monitorCallback();
+                if(!ArmMonitor()){
+                    return -static_cast<int32_t>(errno);
+                }
+            }
+            return numProcessed;
+        }
+
+    private:
+        static constexpr uint16_t numBuffers = 256;      // Number of provided buffers, must be a power of two.
+        static constexpr uint64_t receiveUserData = 1;   // User data of the multishot receive request.
+        static constexpr uint64_t wakeUpUserData = 2;    // User data of the wake-up poll request.
+        static constexpr uint64_t monitorUserData = 3;   // User data of the interface monitor poll request.
+        static constexpr uint16_t bufferGroup = 0;       // ID of the provided buffer group.
+
+        static_assert(16 == sizeof(io_uring_buf), "Unexpected layout of io_uring_buf!");
+        static_assert(14 == offsetof(io_uring_buf, resv), "Unexpected layout of io_uring_buf!");
+
+        static constexpr uint32_t controlSize = CMSG_SPACE(sizeof(uint32_t));   // Size of the control section, large enough for the drop counter.
+        static constexpr uint32_t bufferSize = sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in) + controlSize + std::max<uint32_t>(sizeof(udptouchpad::detail::SerializationTouchpadMessageUnion), UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE);   // Size of one buffer, large enough for one single or batched touchpad message.
+
+        int wakeFD;                         // Event file descriptor to wake up a blocked @ref Receive.
+        int ringFD;                         // File descriptor of the io_uring instance.
+        int socketFD;                       // The socket from which to receive.
+        int monitorFD;                      // Descriptor of the interface monitor or -1 if not used.
+        void* sqRing;                       // Mapped submission queue ring.
+        size_t sqRingSize;                  // Size of the mapped submission queue ring.
+        void* cqRing;                       // Mapped completion queue ring.
+        size_t cqRingSize;                  // Size of the mapped completion queue ring.
+        io_uring_sqe* sqes;                 // Mapped submission queue entries.
+        size_t sqesSize;                    // Size of the mapped submission queue entries.
+        uint32_t* sqTail;                   // Tail of the submission queue.
+        uint32_t sqMask;                    // Index mask of the submission queue.
+        uint32_t* sqArray;                  // Index array of the submission queue.
+        uint32_t* cqHead;                   // Head of the completion queue.
+        uint32_t* cqTail;                   // Tail of the completion queue.
+        uint32_t cqMask;                    // Index mask of the completion queue.
+        io_uring_cqe* cqes;                 // Completion queue entries.
+        io_uring_buf* bufferRing;           // Entries of the provided buffer ring, followed by the buffers.
+        uint16_t* bufferRingTail;           // Tail of the provided buffer ring, which overlays the reserved field of the first entry.
+        void* bufferMemory;                 // Memory of the buffer ring and the buffers.
+        size_t bufferMemorySize;            // Size of the buffer memory.
+        uint16_t bufferTail;                // Local copy of the tail of the provided buffer ring.
+        bool armed;                         // True if the multishot receive request is active.
+        bool wakeUpPending;                 // True if the wake-up poll request has completed and must be submitted again.
+        bool monitorPending;                // True if the interface monitor poll request has completed and must be submitted again.
+        msghdr msgTemplate;                 // Message header template that tells the kernel the size of the name and control sections.
+        uint32_t dropCounter;               // The latest cumulative drop counter that has been attached to a received message.
+        std::string errorString;            // OS-specific error string, set if @ref Open fails.
+
+        /**
+         * @brief Get the address of a provided buffer.
+         * @param[in] bufferID The ID of the buffer.
+         * @return Pointer to the first byte of the buffer.
+         */
+        uint8_t* Buffer(uint16_t bufferID){
+            return reinterpret_cast<uint8_t*>(bufferMemory) + numBuffers * sizeof(io_uring_buf) + bufferID * bufferSize;
+        }
+
+        /**
+         * @brief Read the drop counter from the control section of a received message, if present.
+         * @param[in] control The control section.
+         * @param[in] length The number of valid bytes of the control section.
+         */
+        void ReadDropCounter(uint8_t* control, uint32_t length){
+            msghdr msg{};
+            msg.msg_control = control;
+            msg.msg_controllen = std::min(length, controlSize);
+            for(cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)){
+                if((SOL_SOCKET == cmsg->cmsg_level) && (SO_RXQ_OVFL == cmsg->cmsg_type)){
+                    std::memcpy(&dropCounter, CMSG_DATA(cmsg), sizeof(dropCounter));
+                }
+            }
+        }
+
+        /**
+         * @brief Put a buffer into the provided buffer ring. The buffer is visible to the kernel after the ring tail has been updated.
+         * @param[in] bufferID The ID of the buffer.
+         * @param[in] position The position in the ring (unmasked).
+         */
+        void ProvideBuffer(uint16_t bufferID, uint16_t position){
+            io_uring_buf& buf = bufferRing[position & (numBuffers - 1)];
+            buf.addr = reinterpret_cast<uint64_t>(Buffer(bufferID));
+            buf.len = bufferSize;
+            buf.bid = bufferID;
+        }
+
+        /**
+         * @brief Submit the multishot recvmsg request.
+         * @return True if success, false otherwise.
+         */
+        bool Arm(void){
+            std::memset(&msgTemplate, 0, sizeof(msgTemplate));
+            msgTemplate.msg_namelen = sizeof(sockaddr_in);
+            msgTemplate.msg_controllen = controlSize;
+            io_uring_sqe sqe;
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_RECVMSG;
+            sqe.fd = socketFD;
+            sqe.addr = reinterpret_cast<uint64_t>(&msgTemplate);
+            sqe.len = 1;
+            sqe.flags = IOSQE_BUFFER_SELECT;
+            sqe.buf_group = bufferGroup;
+            sqe.ioprio = IORING_RECV_MULTISHOT;
+            sqe.user_data = receiveUserData;
+            armed = Submit(sqe);
+            return armed;
+        }
+
+        /**
+         * @brief Submit the poll request for the wake-up event file descriptor.
+         * @return True if success, false otherwise.
+         */
+        bool ArmWakeUp(void){
+            io_uring_sqe sqe;
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_POLL_ADD;
+            sqe.fd = wakeFD;
+            sqe.poll32_events = POLLIN;
+            sqe.user_data = wakeUpUserData;
+            wakeUpPending = !Submit(sqe);
+            return !wakeUpPending;
+        }
+
+        /**
+         * @brief Submit the poll request for the interface monitor.
+         * @return True if success, false otherwise.
+         */
+        bool ArmMonitor(void){
+            io_uring_sqe sqe;
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_POLL_ADD;
+            sqe.fd = monitorFD;
+            sqe.poll32_events = POLLIN;
+            sqe.user_data = monitorUserData;
+            monitorPending = !Submit(sqe);
+            return !monitorPending;
+        }
+
+        /**
+         * @brief Submit a single submission queue entry.
+         * @param[in] entry The entry to be submitted.
+         * @return True if success, false otherwise.
+         */
+        bool Submit(const io_uring_sqe& entry){
+            uint32_t tail = *sqTail;
+            uint32_t index = tail & sqMask;
+            sqes[index] = entry;
+            sqArray[index] = index;
+            std::atomic_ref<uint32_t>(*sqTail).store(tail + 1, std::memory_order_release);
+            return syscall(__NR_io_uring_enter, ringFD, 1, 0, 0, nullptr, 0) >= 1;
+        }
+
+        /**
+         * @brief Set the error string, release all resources and indicate failure.
+         * @param[in] prestring Description of the failed step.
+         * @return Always false.
+         */
+        bool Fail(std::string prestring){
+            int err = static_cast<int>(errno);
+            errorString = prestring + std::string(" ") + std::string(strerror(err)) + std::string(" (") + std::to_string(err) + std::string(")");
+            Close();
+            return false;
+        }
+};
+
+
+#else
+
+
+/**
+ * @brief Placeholder if the io_uring backend is not enabled or not supported. @ref Open always fails, so that the caller falls
+ * back to @ref MulticastSocket::ReceiveFrom.
+ */
+class IoUringReceiver: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Open the receiver.
+         * @return Always false.
+         */
+        bool Open(int, int = -1){ return false; }
+
+        /**
+         * @brief Close the receiver.
+         */
+        void Close(void){}
+
+        /**
+         * @brief Check whether the receiver is open or not.
+         * @return Always false.
+         */
+        bool IsOpen(void){ return false; }
+
+        /**
+         * @brief Wake up a blocked receive call.
+         */
+        void WakeUp(void){}
+
+        /**
+         * @brief Get the error string.
+         * @return String indicating that io_uring is not enabled.
+         */
+        std::string GetErrorString(void){ return std::string("io_uring is not enabled!"); }
+
+        /**
+         * @brief Get the cumulative drop counter.
+         * @return Always zero.
+         */
+        uint32_t GetDropCounter(void){ return 0; }
+
+        /**
+         * @brief Receive messages.
+         * @return Always -1.
+         */
+        template<class Callback, class MonitorCallback> int32_t Receive(Callback&&, MonitorCallback&&){ return -1; }
+};
+
+
+#endif
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
@@ -0,0 +1,186 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Represents a bounded lock-free FIFO ring buffer that never allocates memory after construction.
+ * @tparam T Type of a buffer element. Must be default-constructible and move-assignable.
+ * @tparam N Fixed ring buffer size. Must be a power of two.
+ * @details Any number of producers and consumers may access the ring buffer concurrently, which makes it usable as SPSC
+ * as well as MPSC queue. Each slot carries a sequence number that tells producers and consumers whether the slot is ready
+ * to be written or read (bounded MPMC queue by D. Vyukov).
+ */
+template <class T, size_t N> class LockFreeRingBuffer: public NonCopyable {
+    static_assert((N >= 2) && !(N & (N - 1)), "Size of LockFreeRingBuffer must be a power of two!");
+
+    public:
+        /**
+         * @brief Construct a new lock-free ring buffer.
+         */
+        LockFreeRingBuffer(): enqueuePosition(0), dequeuePosition(0){
+            for(size_t n = 0; n < N; ++n){
+                slots[n].sequence.store(n, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Try to add a new value to the ring buffer.
+         * @param[in] value The value to be added.
+         * @return True if success, false if the ring buffer is full.
+         * @details This call is thread-safe and lock-free.
+         */
+        bool TryPush(const T& value){ return Push(value); }
+
+        /**
+         * @brief Try to add a new value to the ring buffer.
+         * @param[in] value The value to be moved into the ring buffer. The value is only moved if this call succeeds.
+         * @return True if success, false if the ring buffer is full.
+         * @details This call is thread-safe and lock-free.
+         */
+        bool TryPush(T&& value){ return Push(std::move(value)); }
+
+        /**
+         * @brief Add a new value to the ring buffer. If the ring buffer is full, the oldest values are dropped.
+         * @param[in] value The value to be added.
+         * @details This call is thread-safe and lock-free.
+         */
+        void PushOverwrite(const T& value){
+            while(!Push(value)){
+                T dropped;
+                (void) TryPop(dropped);
+            }
+        }
+
+        /**
+         * @brief Try to remove the oldest value from the ring buffer.
+         * @param[out] value The value that has been removed from the ring buffer.
+         * @return True if success, false if the ring buffer is empty.
+         * @details This call is thread-safe and lock-free.
+         */
+        bool TryPop(T& value){
+            size_t position = dequeuePosition.load(std::memory_order_relaxed);
+            for(;;){
+                Slot& slot = slots[position & (N - 1)];
+                size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+                if(!difference){
+                    if(dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+                        value = std::move(slot.value);
+                        slot.sequence.store(position + N, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if(difference < 0){
+                    return false;
+                }
+                else{
+                    position = dequeuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Remove values from the ring buffer and pass them to a visitor.
+         * @tparam Visitor Callable type with the prototype void(T&).
+         * @param[in] visitor The visitor to be called for each value in FIFO order. The value may be moved from.
+         * @return Number of values that have been visited.
+         * @details This call is thread-safe and lock-free. At most N values are visited, so that concurrent producers cannot keep the caller busy forever.
+         */
+        template <class Visitor> size_t Drain(Visitor&& visitor){
+            size_t count = 0;
+            T value;
+            while((count < N) && TryPop(value)){
+                visitor(value);
+                count++;
+            }
+            return count;
+        }
+
+        /**
+         * @brief Remove values from the ring buffer and move them into a caller-provided buffer.
+         * @param[out] destination The buffer where to store the values in FIFO order.
+         * @param[in] capacity The maximum number of values that can be stored in the destination buffer.
+         * @return Number of values that have been stored in the destination buffer.
+         * @details This call is thread-safe and lock-free.
+         */
+        size_t Drain(T* destination, size_t capacity){
+            size_t count = 0;
+            while((count < capacity) && TryPop(destination[count])){
+                count++;
+            }
+            return count;
+        }
+
+        /**
+         * @brief Clear the ring buffer.
+         * @details This call is thread-safe and lock-free.
+         */
+        void Clear(void){
+            (void) Drain([](T&){});
+        }
+
+        /**
+         * @brief Check whether the ring buffer is empty.
+         * @return True if empty, false otherwise. The result is only a snapshot if other threads access the ring buffer concurrently.
+         */
+        bool IsEmpty(void) const {
+            return enqueuePosition.load(std::memory_order_acquire) == dequeuePosition.load(std::memory_order_acquire);
+        }
+
+    private:
+        /**
+         * @brief Represents one slot of the ring buffer.
+         */
+        struct Slot {
+            std::atomic<size_t> sequence;   // Sequence number indicating whether the slot can be written (sequence == position) or read (sequence == position + 1).
+            T value;                        // The stored value.
+        };
+
+        alignas(64) std::atomic<size_t> enqueuePosition;   // Position of the next slot to be written by a producer.
+        alignas(64) std::atomic<size_t> dequeuePosition;   // Position of the next slot to be read by a consumer.
+        alignas(64) std::array<Slot,N> slots;              // Internal container of the ring buffer.
+
+        /**
+         * @brief Try to add a new value to the ring buffer.
+         * @tparam U Forwarding reference type of the value.
+         * @param[in] value The value to be added.
+         * @return True if success, false if the ring buffer is full.
+         */
+        template <class U> bool Push(U&& value){
+            size_t position = enqueuePosition.load(std::memory_order_relaxed);
+            for(;;){
+                Slot& slot = slots[position & (N - 1)];
+                size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if(!difference){
+                    if(enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+                        slot.value = std::forward<U>(value);
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if(difference < 0){
+                    return false;
+                }
+                else{
+                    position = enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
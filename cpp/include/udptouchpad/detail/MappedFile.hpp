@@ -0,0 +1,185 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Represents a file that is mapped read-only into the address space of this process.
+ */
+class MappedFile: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Construct a new mapped file object.
+         */
+        MappedFile(): address(nullptr), size(0) {
+            #ifdef _WIN32
+            fileHandle = INVALID_HANDLE_VALUE;
+            mappingHandle = NULL;
+            #endif
+        }
+
+        /**
+         * @brief Destroy the mapped file object and unmap the file.
+         */
+        ~MappedFile(){
+            Close();
+        }
+
+        /**
+         * @brief Open a file and map its whole content with read-only access.
+         * @param[in] filename The name of the file.
+         * @return True if success, false otherwise. An empty file is opened successfully, but nothing is mapped.
+         * @details If this member function fails, use @ref GetErrorString to obtain error information.
+         */
+        bool Open(const std::string& filename){
+            Close();
+            errorString.clear();
+
+            #ifdef _WIN32
+            fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+            if(INVALID_HANDLE_VALUE == fileHandle){
+                errorString = GenerateErrorString("Failed to open file \"" + filename + "\"!");
+                return false;
+            }
+            LARGE_INTEGER fileSize;
+            if(!GetFileSizeEx(fileHandle, &fileSize)){
+                errorString = GenerateErrorString("Failed to get size of file \"" + filename + "\"!");
+                Close();
+                return false;
+            }
+            if(!fileSize.QuadPart){
+                return true;
+            }
+            mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+            if(!mappingHandle){
+                errorString = GenerateErrorString("Failed to map file \"" + filename + "\"!");
+                Close();
+                return false;
+            }
+            address = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+            if(!address){
+                errorString = GenerateErrorString("Failed to map file \"" + filename + "\"!");
+                Close();
+                return false;
+            }
+            size = static_cast<size_t>(fileSize.QuadPart);
+            #elif __linux__
+            errno = 0;
+            int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+            if(fd < 0){
+                errorString = GenerateErrorString("Failed to open file \"" + filename + "\"!");
+                return false;
+            }
+            struct stat info;
+            if(fstat(fd, &info) < 0){
+                errorString = GenerateErrorString("Failed to get size of file \"" + filename + "\"!");
+                (void) close(fd);
+                return false;
+            }
+            if(!info.st_size){
+                (void) close(fd);
+                return true;
+            }
+            void* p = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            (void) close(fd);
+            if(MAP_FAILED == p){
+                errorString = GenerateErrorString("Failed to map file \"" + filename + "\"!");
+                return false;
+            }
+            (void) madvise(p, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+            address = p;
+            size = static_cast<size_t>(info.st_size);
+            #else
+            #error "Platform is not supported!"
+            #endif
+
+            return true;
+        }
+
+        /**
+         * @brief Unmap and close the file.
+         */
+        void Close(void){
+            if(address){
+                #ifdef _WIN32
+                (void) UnmapViewOfFile(address);
+                #elif __linux__
+                (void) munmap(address, size);
+                #else
+                #error "Platform is not supported!"
+                #endif
+            }
+            #ifdef _WIN32
+            if(mappingHandle){
+                (void) CloseHandle(mappingHandle);
+                mappingHandle = NULL;
+            }
+            if(INVALID_HANDLE_VALUE != fileHandle){
+                (void) CloseHandle(fileHandle);
+                fileHandle = INVALID_HANDLE_VALUE;
+            }
+            #endif
+            address = nullptr;
+            size = 0;
+        }
+
+        /**
+         * @brief Get the address of the mapped file content.
+         * @return Address of the content or nullptr if nothing is mapped.
+         */
+        const uint8_t* GetData(void) const { return static_cast<const uint8_t*>(address); }
+
+        /**
+         * @brief Get the size of the mapped file content.
+         * @return Size of the content in bytes.
+         */
+        size_t GetSize(void) const { return size; }
+
+        /**
+         * @brief Get the last error string that has been set by @ref Open.
+         * @return String giving information about the last error.
+         */
+        std::string GetErrorString(void){ return errorString; }
+
+    private:
+        void* address;             // Address of the mapped file content.
+        size_t size;               // Size of the mapped file content in bytes.
+        std::string errorString;   // OS-specific error string, set if mapping fails.
+        #ifdef _WIN32
+        HANDLE fileHandle;         // Handle of the file.
+        HANDLE mappingHandle;      // Handle of the file mapping object.
+        #endif
+
+        /**
+         * @brief Get the last error value.
+         * @return String representing the last error code.
+         */
+        std::string GenerateErrorString(std::string prestring){
+            #ifdef _WIN32
+            int err = static_cast<int>(GetLastError());
+            std::string errStr("");
+            #elif __linux__
+            int err = static_cast<int>(errno);
+            std::string errStr = std::string(strerror(err)) + std::string(" ");
+            #else
+            #error "Platform is not supported!"
+            #endif
+
+            return prestring + std::string(" ") + errStr + std::string("(") + std::to_string(err) + std::string(")");
+        }
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
@@ -0,0 +1,186 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+#include <udptouchpad/detail/TouchpadMessage.hpp>
+#include <udptouchpad/detail/MappedFile.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Magic number that identifies a recording file of the UDP touchpad library.
+ */
+constexpr uint32_t recordingMagic = 0x55545052;
+
+
+/**
+ * @brief Version of the recording file layout. Must be incremented whenever the layout changes.
+ */
+constexpr uint32_t recordingLayoutVersion = 1;
+
+
+/**
+ * @brief Header at the beginning of a recording file. All fields are stored in native byte order.
+ */
+#pragma pack(push, 1)
+struct RecordingFileHeader {
+    uint32_t magic;           // Set to @ref recordingMagic.
+    uint32_t layoutVersion;   // Set to @ref recordingLayoutVersion.
+    uint32_t recordSize;      // Size of one @ref RecordedMessage in bytes.
+    uint32_t reserved;        // Reserved, set to zero.
+};
+#pragma pack(pop)
+
+
+/**
+ * @brief One received touchpad message of a recording file. The records follow the @ref RecordingFileHeader without any gap.
+ * The message is stored as received, that is in network byte order, all other fields are stored in native byte order.
+ */
+#pragma pack(push, 1)
+struct RecordedMessage {
+    int64_t timestamp;                                                // Time when the message has been received in nanoseconds since the epoch of the steady clock.
+    uint32_t deviceID;                                                // The device ID, which is equal to the IPv4 address.
+    uint16_t endpoint;                                                // Index of the network endpoint on which the message has been received.
+    uint16_t reserved;                                                // Reserved, set to zero.
+    udptouchpad::detail::SerializationTouchpadMessageUnion message;   // The message in network byte order.
+};
+#pragma pack(pop)
+
+
+/**
+ * @brief Map a recording file into memory and check its header.
+ * @param[out] file The file to be mapped. The records remain valid until the file is closed.
+ * @param[in] filename The name of the recording file.
+ * @param[out] records Pointer to the first record of the file.
+ * @param[out] numRecords Number of complete records in the file.
+ * @param[out] errorString Error string, set if this function fails.
+ * @return True if success, false if the file could not be mapped or is not a recording file of the current layout.
+ */
+inline bool OpenRecordingFile(udptouchpad::detail::MappedFile& file, const std::string& filename, const udptouchpad::detail::RecordedMessage*& records, size_t& numRecords, std::string& errorString){
+    if(!file.Open(filename)){
+        errorString = file.GetErrorString();
+        return false;
+    }
+    udptouchpad::detail::RecordingFileHeader header;
+    if(file.GetSize() < sizeof(header)){
+        errorString = "File \"" + filename + "\" is not a recording file!";
+        return false;
+    }
+    std::memcpy(&header, file.GetData(), sizeof(header));
+    if((udptouchpad::detail::recordingMagic != header.magic) || (udptouchpad::detail::recordingLayoutVersion != header.layoutVersion) || (sizeof(udptouchpad::detail::RecordedMessage) != header.recordSize)){
+        errorString = "File \"" + filename + "\" is not a recording file or has an incompatible layout!";
+        return false;
+    }
+    numRecords = (file.GetSize() - sizeof(header)) / sizeof(udptouchpad::detail::RecordedMessage);
+    records = reinterpret_cast<const udptouchpad::detail::RecordedMessage*>(file.GetData() + sizeof(header));
+    return true;
+}
+
+
+} /* namespace: detail */
+
+
+/**
+ * @brief Appends received touchpad messages to a recording file, which can be processed offline by the @ref RecordingAnalyzer.
+ * A file may contain the messages of one device or of many devices.
+ */
+class MessageRecorder: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Construct a new message recorder.
+         */
+        MessageRecorder(): file(nullptr) {}
+
+        /**
+         * @brief Destroy the message recorder and close the recording file.
+         */
+        ~MessageRecorder(){
+            Close();
+        }
+
+        /**
+         * @brief Create a new recording file. An existing file is overwritten.
+         * @param[in] filename The name of the recording file.
+         * @return True if success, false otherwise.
+         * @details If this member function fails, use @ref GetErrorString to obtain error information.
+         */
+        bool Open(const std::string& filename){
+            Close();
+            errorString.clear();
+            file = std::fopen(filename.c_str(), "wb");
+            if(!file){
+                errorString = "Failed to create recording file \"" + filename + "\"!";
+                return false;
+            }
+            udptouchpad::detail::RecordingFileHeader header;
+            header.magic = udptouchpad::detail::recordingMagic;
+            header.layoutVersion = udptouchpad::detail::recordingLayoutVersion;
+            header.recordSize = static_cast<uint32_t>(sizeof(udptouchpad::detail::RecordedMessage));
+            header.reserved = 0;
+            if(1 != std::fwrite(&header, sizeof(header), 1, file)){
+                errorString = "Failed to write header of recording file \"" + filename + "\"!";
+                Close();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Flush and close the recording file.
+         */
+        void Close(void){
+            if(file){
+                (void) std::fclose(file);
+                file = nullptr;
+            }
+        }
+
+        /**
+         * @brief Check whether a recording file is open.
+         * @return True if a recording file is open, false otherwise.
+         */
+        bool IsOpen(void){ return (nullptr != file); }
+
+        /**
+         * @brief Append a received message to the recording file.
+         * @param[in] deviceID The device ID, which is equal to the IPv4 address.
+         * @param[in] endpoint Index of the network endpoint on which the message has been received.
+         * @param[in] bytes The bytes of the message as received, that is in network byte order.
+         * @param[in] length The number of bytes.
+         * @param[in] timestamp Time when the message has been received.
+         * @return True if the message has been recorded, false if no file is open, writing failed or the bytes do not form a
+         * single touchpad message (header 0x42). Batched messages are not recorded.
+         */
+        bool Record(const uint32_t deviceID, const uint16_t endpoint, const uint8_t* bytes, const size_t length, const std::chrono::time_point<std::chrono::steady_clock> timestamp){
+            if(!file || (length != sizeof(udptouchpad::detail::SerializationTouchpadMessageUnion)) || (0x42 != bytes[0])){
+                return false;
+            }
+            record.timestamp = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count());
+            record.deviceID = deviceID;
+            record.endpoint = endpoint;
+            record.reserved = 0;
+            std::memcpy(&record.message.bytes[0], bytes, length);
+            return (1 == std::fwrite(&record, sizeof(record), 1, file));
+        }
+
+        /**
+         * @brief Get the last error string that has been set by @ref Open.
+         * @return String giving information about the last error.
+         */
+        std::string GetErrorString(void){ return errorString; }
+
+    private:
+        std::FILE* file;                               // The recording file or nullptr if no file is open.
+        udptouchpad::detail::RecordedMessage record;   // Scratch record used to write messages.
+        std::string errorString;                       // Error string, set if opening fails.
+};
+
+
+} /* namespace: udptouchpad */
+
@@ -0,0 +1,54 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/TouchpadMessage.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Interface for all objects that process unpacked messages, e.g. an event system that receives messages on its own or
+ * via a @ref ReceiverHub.
+ */
+class MessageSink {
+    public:
+        /**
+         * @brief Destroy the message sink.
+         */
+        virtual ~MessageSink(){}
+
+        /**
+         * @brief Process an error message.
+         * @param[in] msg The error message to be handled.
+         */
+        virtual void ProcessErrorMessage(const std::string& msg) = 0;
+
+        /**
+         * @brief Process messages that have been dropped by the kernel before they could be received.
+         * @param[in] endpoint Index of the network endpoint on which the messages have been dropped.
+         * @param[in] numDropped Number of messages that have been dropped, because the receive buffer was full.
+         * @param[in] numRejected Number of messages that have been rejected by the kernel filter.
+         */
+        virtual void ProcessDroppedMessages(const uint16_t endpoint, const uint64_t numDropped, const uint64_t numRejected) = 0;
+
+        /**
+         * @brief Process a received touch message.
+         * @param[in] source The source address from where the message was sent.
+         * @param[in] endpoint Index of the network endpoint on which the message has been received.
+         * @param[in] msg The touch message that has been received.
+         * @param[in] timestamp Time when the message has been received. For batched messages, this is the time of the sample.
+         */
+        virtual void ProcessTouchMessage(const uint32_t source, const uint16_t endpoint, const udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg, const std::chrono::time_point<std::chrono::steady_clock> timestamp) = 0;
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
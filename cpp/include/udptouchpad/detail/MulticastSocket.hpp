@@ -2,6 +2,17 @@
 
 
 #include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/InterfaceMonitor.hpp>
+#include <udptouchpad/detail/NetworkConfiguration.hpp>
+#include <udptouchpad/detail/TouchpadMessage.hpp>
+#include <udptouchpad/detail/BatchMessage.hpp>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <netinet/udp.h>
+#include <linux/filter.h>
+#include <linux/sock_diag.h>
+#endif
 
 
 namespace udptouchpad {
@@ -18,12 +29,16 @@ class MulticastSocket {
         /**
          * @brief Construct a new multicast socket object.
          */
-        MulticastSocket(): _socket(-1) {
+        MulticastSocket(): _socket(-1), wakeFD(-1), receiveOffloadEnabled(false), kernelFilterAttached(false), receiveBufferSize(0), maxReceiveBufferSize(0), dropCounter(0), numDropped(0), numRejected(0), queueDrained(true), queueFilled(false) {
             // on windows, WSAStartup has to be called to allow the use of network sockets
             // multiple calls are possible and we never call WSACleanup
             #ifdef _WIN32
             WSADATA wsadata;
             (void) WSAStartup(MAKEWORD(2, 2), &wsadata);
+            #elif __linux__
+            wakeFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            #else
+            #error "Platform is not supported!"
             #endif
         }
 
@@ -32,27 +47,60 @@ class MulticastSocket {
          */
         ~MulticastSocket(){
             Close();
+            #ifdef __linux__
+            if(wakeFD >= 0){
+                (void) close(wakeFD);
+            }
+            #endif
         }
 
         /**
          * @brief Open the multicast socket to receive messages from the UDP touchpad app.
+         * @param[in] endpoint The network endpoint that specifies the multicast group, the port and optionally the interface.
+         * @param[in] configuration The network configuration that specifies the socket options, e.g. the kernel filter.
          * @return True if success or already open, false otherwise.
-         * @details If this member function fails, use @ref GetErrorString to obtain error information.
+         * @details If this member function fails, use @ref GetErrorString to obtain error information. If network interfaces
+         * can be monitored (Linux only), interfaces on which the group cannot be joined are skipped and retried as soon as
+         * the interface monitor reports a change, see @ref UpdateMulticastMembership. On Linux, only datagrams of the group
+         * that has been joined by this socket are received, even if other sockets bound to the same port joined other groups.
+         * If the kernel filter cannot be attached, all datagrams are received and have to be checked in user space. On Linux,
+         * the kernel reports the number of dropped datagrams with each received datagram, see @ref TakeDroppedDatagrams. If UDP
+         * GRO is enabled, @ref ReceiveFrom may return several coalesced datagrams at once.
          */
-        bool Open(void){
+        bool Open(const udptouchpad::NetworkEndpoint& endpoint, const udptouchpad::NetworkConfiguration& configuration){
+            const std::lock_guard<std::mutex> lock(membershipMutex);
             if(-1 == _socket){
+                groupAddress = endpoint.groupAddress;
+                interfaceFilter = endpoint.interfaceName;
                 if(!OpenSocket()){
                     CloseSocket();
                     return false;
                 }
                 ReusePort();
-                if(!BindPort(UDP_TOUCHPAD_MULTICAST_DESTINATION_PORT)){
+                ReceiveJoinedGroupsOnly();
+                receiveOffloadEnabled = configuration.receiveOffload && EnableReceiveOffload();
+                kernelFilterAttached = configuration.kernelFilter && AttachKernelFilter(configuration.allowedSources);
+                receiveBufferSize = configuration.receiveBufferSize;
+                maxReceiveBufferSize = configuration.maxReceiveBufferSize;
+                if(receiveBufferSize){
+                    (void) SetReceiveBufferSize(receiveBufferSize);
+                }
+                EnableDropCounter();
+                if(!BindPort(endpoint.port)){
                     CloseSocket();
                     return false;
                 }
-                interfaceNames = GetAllInterfaceNames();
-                if(!JoinMulticastGroupOnAllInterfaces(UDP_TOUCHPAD_MULTICAST_GROUP_ADDRESS, interfaceNames)){
-                    LeaveMulticastGroupOnAllInterfaces(UDP_TOUCHPAD_MULTICAST_GROUP_ADDRESS, interfaceNames);
+                interfaceNames = GetSelectedInterfaceNames();
+                if(interfaceMonitor.Open() && (!interfaceNames.empty() || !interfaceFilter.empty())){
+                    std::erase_if(interfaceNames, [this](const std::string& interfaceName){ return !JoinMulticastGroupOnInterface(groupAddress.c_str(), interfaceName); });
+                }
+                else if(!interfaceFilter.empty() && interfaceNames.empty()){
+                    errorString = "Network interface \"" + interfaceFilter + "\" does not exist!";
+                    CloseSocket();
+                    return false;
+                }
+                else if(!JoinMulticastGroupOnAllInterfaces(groupAddress.c_str(), interfaceNames)){
+                    LeaveMulticastGroupOnAllInterfaces(groupAddress.c_str(), interfaceNames);
                     CloseSocket();
                     return false;
                 }
@@ -65,24 +113,100 @@ class MulticastSocket {
          * @brief Close the multicast socket.
          */
         void Close(void){
-            LeaveMulticastGroupOnAllInterfaces(UDP_TOUCHPAD_MULTICAST_GROUP_ADDRESS, interfaceNames);
+            const std::lock_guard<std::mutex> lock(membershipMutex);
+            LeaveMulticastGroupOnAllInterfaces(groupAddress.c_str(), interfaceNames);
             CloseSocket();
         }
 
+        /**
+         * @brief Wake up a thread that is blocked in @ref ReceiveFrom, which then returns an error code indicating an
+         * interrupted call. This member function can be called from any thread.
+         * @details On Linux, an event file descriptor is signaled, so that the socket is closed by the receiving thread
+         * itself. On other operating systems, the socket is closed by the calling thread to unblock the receive call.
+         */
+        void WakeUp(void){
+            #ifdef __linux__
+            if(wakeFD >= 0){
+                uint64_t value = 1;
+                (void) !write(wakeFD, &value, sizeof(value));
+                return;
+            }
+            #endif
+            Close();
+        }
+
         /**
          * @brief Check whether the socket is open or not.
          * @return True if open, false otherwise.
          */
         bool IsOpen(void){ return -1 != _socket; }
 
+        /**
+         * @brief Get the native socket descriptor, e.g. to receive via another backend.
+         * @return The socket descriptor or -1 if the socket is not open.
+         */
+        int32_t GetDescriptor(void){ return _socket; }
+
+        /**
+         * @brief Get the descriptor of the interface monitor, which becomes readable if network interfaces changed.
+         * @return The descriptor or -1 if network interfaces are not monitored.
+         */
+        int GetInterfaceMonitorDescriptor(void){ return interfaceMonitor.GetDescriptor(); }
+
+        /**
+         * @brief Read pending changes from the interface monitor and update the multicast membership of the open socket
+         * incrementally. The group is joined on new interfaces, removed interfaces are forgotten and the membership on
+         * interfaces that obtained a new address is renewed. Must be called from the thread that receives messages.
+         */
+        void UpdateMulticastMembership(void){
+            if(!interfaceMonitor.ReadChanges(refreshedInterfaces)){
+                return;
+            }
+            const std::lock_guard<std::mutex> lock(membershipMutex);
+            if(-1 == _socket){
+                return;
+            }
+
+            // memberships on removed interfaces are released by the kernel, leaving by name is not possible anymore
+            std::vector<std::string> currentNames = GetSelectedInterfaceNames();
+            std::erase_if(interfaceNames, [&currentNames](const std::string& interfaceName){ return std::find(currentNames.begin(), currentNames.end(), interfaceName) == currentNames.end(); });
+            for(auto&& interfaceName : currentNames){
+                bool joined = std::find(interfaceNames.begin(), interfaceNames.end(), interfaceName) != interfaceNames.end();
+                bool refreshed = std::find(refreshedInterfaces.begin(), refreshedInterfaces.end(), if_nametoindex(interfaceName.c_str())) != refreshedInterfaces.end();
+                if(joined && refreshed){
+                    LeaveMulticastGroupOnInterface(groupAddress.c_str(), interfaceName);
+                }
+                if(joined && !refreshed){
+                    continue;
+                }
+                if(JoinMulticastGroupOnInterface(groupAddress.c_str(), interfaceName)){
+                    if(!joined){
+                        interfaceNames.push_back(interfaceName);
+                    }
+                }
+                else if(joined){
+                    interfaceNames.erase(std::find(interfaceNames.begin(), interfaceNames.end(), interfaceName));
+                }
+            }
+            ResetLastError();
+        }
+
         /**
          * @brief Get bytes from the receive buffer of the operating system.
          * @param[out] sourceIP Source, where to store the sender IPv4 address, that sent the message.
+         * @param[out] segmentSize The size of each datagram if several datagrams have been coalesced by UDP GRO (Linux only),
+         * otherwise the number of bytes that have been received.
          * @param[out] bytes Pointer to data array, where received bytes should be stored.
          * @param[in] maxSize The maximum size of the data array.
+         * @param[in] wait True if the call should wait for a message, false if it should return immediately. On Windows, the
+         * call always blocks until a message is available, so that it should only be called if the socket is readable.
          * @return A tuple containing the number of bytes that have been received and an OS-specific error code.
+         * @details On Linux, interface changes are handled while waiting for a message. If the receive call is interrupted
+         * by @ref WakeUp, a negative value is returned together with the error code EINTR. If no message is available and
+         * waiting is disabled, a negative value is returned together with the error code EAGAIN. Coalesced datagrams are
+         * stored back to back, where only the last datagram may be shorter than the segment size.
          */
-        std::tuple<int32_t, int32_t> ReceiveFrom(uint32_t& sourceIP, uint8_t *bytes, int32_t maxSize){
+        std::tuple<int32_t, int32_t> ReceiveFrom(uint32_t& sourceIP, int32_t& segmentSize, uint8_t *bytes, int32_t maxSize, bool wait = true){
             sockaddr_in addr{};
 
             #ifdef _WIN32
@@ -101,7 +225,56 @@ class MulticastSocket {
             #error "Platform is not supported!"
             #endif
 
+            #ifdef _WIN32
             int rx = recvfrom(_socket, reinterpret_cast<char*>(bytes), maxSize, 0, reinterpret_cast<struct sockaddr*>(&addr), &address_size);
+            segmentSize = static_cast<int32_t>(rx);
+            #elif __linux__
+            int flags = ((wakeFD >= 0) || interfaceMonitor.IsOpen() || !wait) ? MSG_DONTWAIT : 0;
+            alignas(cmsghdr) uint8_t control[CMSG_SPACE(sizeof(uint32_t)) + CMSG_SPACE(sizeof(int))];
+            iovec iov;
+            iov.iov_base = bytes;
+            iov.iov_len = static_cast<size_t>(maxSize);
+            msghdr msg{};
+            msg.msg_name = &addr;
+            msg.msg_namelen = address_size;
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = &control[0];
+            msg.msg_controllen = sizeof(control);
+            int rx;
+            while(((rx = static_cast<int>(recvmsg(_socket, &msg, flags))) < 0) && ((EAGAIN == errno) || (EWOULDBLOCK == errno)) && wait && WaitForMessage()){
+                msg.msg_namelen = address_size;
+                msg.msg_controllen = sizeof(control);
+                queueDrained = true;
+                errno = 0;
+            }
+            segmentSize = static_cast<int32_t>(rx);
+            if(rx < 0){
+                queueDrained = queueDrained || (EAGAIN == errno) || (EWOULDBLOCK == errno);
+            }
+            else{
+                for(cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)){
+                    if((SOL_SOCKET == cmsg->cmsg_level) && (SO_RXQ_OVFL == cmsg->cmsg_type)){
+                        uint32_t counter;
+                        std::memcpy(&counter, CMSG_DATA(cmsg), sizeof(counter));
+                        CountDroppedDatagrams(counter);
+                    }
+                    else if((SOL_UDP == cmsg->cmsg_level) && (UDP_GRO == cmsg->cmsg_type)){
+                        int gsoSize;
+                        std::memcpy(&gsoSize, CMSG_DATA(cmsg), sizeof(gsoSize));
+                        if(gsoSize > 0){
+                            segmentSize = static_cast<int32_t>(gsoSize);
+                        }
+                    }
+                }
+                if(queueDrained){
+                    SampleReceiveQueue();
+                    queueDrained = false;
+                }
+            }
+            #else
+            #error "Platform is not supported!"
+            #endif
 
             #ifdef _WIN32
             int errorCode = static_cast<int>(WSAGetLastError());
@@ -122,6 +295,95 @@ class MulticastSocket {
             return std::make_tuple(static_cast<int32_t>(rx), static_cast<int32_t>(errorCode));
         }
 
+        /**
+         * @brief Update the number of dropped datagrams from the cumulative drop counter that the kernel attaches to received
+         * datagrams (SO_RXQ_OVFL, Linux only). This is done by @ref ReceiveFrom, other receive backends have to pass the counter.
+         * @param[in] counter The cumulative number of datagrams that have been dropped on this socket.
+         * @details The kernel counts datagrams that have been rejected by the kernel filter as dropped, too, and drops are only
+         * noticed with the next datagram that is queued. New drops are therefore only attributed to a full receive buffer if no
+         * kernel filter is attached or if the receive queue has been found at least half full since drops have been noticed the
+         * last time, see @ref SampleReceiveQueue. Otherwise they are attributed to the kernel filter. Rejected datagrams that
+         * arrive while the receive buffer overflows are counted as dropped.
+         */
+        void CountDroppedDatagrams(uint32_t counter){
+            uint32_t delta = counter - dropCounter;
+            dropCounter = counter;
+            if(delta){
+                if(!kernelFilterAttached || queueFilled || IsReceiveQueueHalfFull()){
+                    numDropped += delta;
+                }
+                else{
+                    numRejected += delta;
+                }
+                queueFilled = false;
+            }
+        }
+
+        /**
+         * @brief Remember whether the receive queue is at least half full, which is used by @ref CountDroppedDatagrams to tell
+         * drops due to a full receive buffer from datagrams that have been rejected by the kernel filter. This is done by
+         * @ref ReceiveFrom whenever a datagram is received after the queue has been empty, other receive backends have to call
+         * this member function after counting dropped datagrams whenever they have been woken up.
+         * @details The receive queue is only sampled if the kernel filter is attached.
+         */
+        void SampleReceiveQueue(void){
+            if(kernelFilterAttached && !queueFilled){
+                queueFilled = IsReceiveQueueHalfFull();
+            }
+        }
+
+        /**
+         * @brief Take the number of datagrams that have been dropped since the last call.
+         * @param[out] dropped Number of datagrams that have been dropped, because the receive buffer was full.
+         * @param[out] rejected Number of datagrams that have been rejected by the kernel filter.
+         * @return True if any datagram has been dropped or rejected, false otherwise.
+         */
+        bool TakeDroppedDatagrams(uint64_t& dropped, uint64_t& rejected){
+            dropped = numDropped;
+            rejected = numRejected;
+            numDropped = 0;
+            numRejected = 0;
+            return dropped || rejected;
+        }
+
+        /**
+         * @brief Double the size of the receive buffer, but not beyond the maximum size of the network configuration.
+         * @return True if the receive buffer has been grown, false if the maximum size has already been reached or if the
+         * operating system refused.
+         */
+        bool GrowReceiveBuffer(void){
+            if(!receiveBufferSize || (receiveBufferSize >= maxReceiveBufferSize)){
+                return false;
+            }
+            receiveBufferSize = static_cast<uint32_t>(std::min<uint64_t>(2 * static_cast<uint64_t>(receiveBufferSize), maxReceiveBufferSize));
+            return SetReceiveBufferSize(receiveBufferSize);
+        }
+
+        /**
+         * @brief Get the size of the receive buffer that is actually used by the operating system.
+         * @return The size in bytes or zero if the size is unknown.
+         * @details Linux doubles the requested size to make room for bookkeeping, the returned size is the requested part.
+         * Without CAP_NET_ADMIN, the size is limited by net.core.rmem_max.
+         */
+        uint32_t GetReceiveBufferSize(void){
+            int value = 0;
+            #ifdef _WIN32
+            int length = sizeof(value);
+            if(getsockopt(_socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<char*>(&value), &length) < 0){
+                return 0;
+            }
+            #elif __linux__
+            socklen_t length = sizeof(value);
+            if(getsockopt(_socket, SOL_SOCKET, SO_RCVBUF, &value, &length) < 0){
+                return 0;
+            }
+            value /= 2;
+            #else
+            #error "Platform is not supported!"
+            #endif
+            return static_cast<uint32_t>(std::max(value, 0));
+        }
+
         /**
          * @brief Get the last error string that has been set by @ref Open.
          * @return String giving information about the last error.
@@ -129,9 +391,55 @@ class MulticastSocket {
         std::string GetErrorString(void){ return errorString; }
 
     private:
-        std::atomic<int32_t> _socket;              // Socket object.
-        std::string errorString;                   // OS-specific error string, set if @ref Open fails.
-        std::vector<std::string> interfaceNames;   // List of all interface names to be used for joining multicast groups.
+        std::atomic<int32_t> _socket;                             // Socket object.
+        std::string errorString;                                  // OS-specific error string, set if @ref Open fails.
+        int wakeFD;                                               // Event file descriptor to wake up a blocked @ref ReceiveFrom (Linux only).
+        std::string groupAddress;                                 // The multicast group address that has been set by @ref Open.
+        std::string interfaceFilter;                              // Name of the only interface on which the group is joined or empty for all interfaces.
+        std::vector<std::string> interfaceNames;                  // List of all interface names on which the multicast group has been joined.
+        std::mutex membershipMutex;                               // Protects the socket and the interface names while memberships are changed.
+        udptouchpad::detail::InterfaceMonitor interfaceMonitor;   // Reports network interface changes, opened once and kept open until destruction.
+        std::vector<uint32_t> refreshedInterfaces;                // Interfaces reported by the interface monitor whose membership should be renewed.
+        bool receiveOffloadEnabled;                               // True if UDP GRO has been enabled, so that received buffers may contain coalesced datagrams.
+        bool kernelFilterAttached;                                // True if the kernel filter has been attached to the socket.
+        uint32_t receiveBufferSize;                               // The requested size of the receive buffer or zero if the default size is used.
+        uint32_t maxReceiveBufferSize;                            // The maximum size to which the receive buffer may be grown.
+        uint32_t dropCounter;                                     // The latest cumulative drop counter that has been reported by the kernel.
+        uint64_t numDropped;                                      // Number of datagrams that have been dropped due to a full receive buffer since @ref TakeDroppedDatagrams.
+        uint64_t numRejected;                                     // Number of datagrams that have been rejected by the kernel filter since @ref TakeDroppedDatagrams.
+        bool queueDrained;                                        // True if the receive queue has been found empty by the latest call to @ref ReceiveFrom.
+        bool queueFilled;                                         // True if the receive queue has been found at least half full since drops have been counted the last time.
+
+        #ifdef __linux__
+        /**
+         * @brief Wait until the socket, the interface monitor or the wake-up event becomes readable. Interface changes are
+         * handled immediately.
+         * @return True if receiving should be retried, false if waiting failed or if a wake-up has been signaled, in which case
+         * errno is set accordingly.
+         */
+        bool WaitForMessage(void){
+            pollfd fds[3];
+            fds[0].fd = _socket;
+            fds[0].events = POLLIN;
+            fds[1].fd = interfaceMonitor.GetDescriptor();
+            fds[1].events = POLLIN;
+            fds[2].fd = wakeFD;
+            fds[2].events = POLLIN;
+            if(poll(&fds[0], 3, -1) < 0){
+                return (EINTR == errno);
+            }
+            if(fds[2].revents & POLLIN){
+                uint64_t value;
+                (void) !read(wakeFD, &value, sizeof(value));
+                errno = EINTR;
+                return false;
+            }
+            if(fds[1].revents & POLLIN){
+                UpdateMulticastMembership();
+            }
+            return true;
+        }
+        #endif
 
         /**
          * @brief Open the actual socket and enable reuse port option.
@@ -207,6 +515,183 @@ class MulticastSocket {
             return true;
         }
 
+        /**
+         * @brief Do not receive datagrams of multicast groups that have been joined by other sockets on the same port (Linux only).
+         */
+        void ReceiveJoinedGroupsOnly(void){
+            #ifdef _WIN32
+            // windows only delivers datagrams of groups that have been joined by the socket itself
+            #elif __linux__
+            int multicastAll = 0;
+            (void) SetOption(IPPROTO_IP, IP_MULTICAST_ALL, (const void*)&multicastAll, sizeof(multicastAll));
+            #else
+            #error "Platform is not supported!"
+            #endif
+        }
+
+        /**
+         * @brief Attach a classic BPF program to the socket that drops malformed datagrams and datagrams from sources that are
+         * not allowed in the kernel, so that they neither wake up the receiving thread nor are copied to user space (Linux only).
+         * @param[in] allowedSources If not empty, only datagrams from these subnets are accepted.
+         * @return True if success, false otherwise.
+         * @details Accepted are single touchpad messages (header 0x42) of the exact message size and batched touchpad messages
+         * (header 0x43) with at least a batch header and at most @ref UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE bytes. The filter of a
+         * UDP socket sees the UDP header at offset zero and the IP header at SKF_NET_OFF. Source subnets are only checked in the
+         * kernel for up to 80 subnets, which is the limit of the 8-bit jump offsets of classic BPF. If UDP GRO is enabled, the
+         * filter sees coalesced datagrams as one buffer, where only the first header is visible. Single touchpad messages are
+         * then accepted if the length is a multiple of the message size and the maximum size of batched touchpad messages is
+         * enforced per datagram by the transport.
+         */
+        bool AttachKernelFilter(const std::vector<udptouchpad::SourceSubnet>& allowedSources){
+            #ifdef _WIN32
+            // windows does not support socket filters
+            (void) allowedSources;
+            return false;
+            #elif __linux__
+            constexpr uint32_t udpHeaderSize = 8;
+            constexpr uint32_t messageLength = udpHeaderSize + sizeof(udptouchpad::detail::SerializationTouchpadMessageUnion);
+            constexpr uint32_t minBatchLength = udpHeaderSize + sizeof(udptouchpad::detail::SerializationBatchHeader);
+            constexpr uint32_t maxBatchLength = udpHeaderSize + UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE;
+            constexpr size_t maxSubnets = 80;
+
+            // layout: 8 instructions for length and header, 3 instructions per subnet, then the final, accept and drop returns
+            const size_t numSubnets = (allowedSources.size() <= maxSubnets) ? allowedSources.size() : 0;
+            const size_t checkSource = 8;
+            const size_t accept = checkSource + 3 * numSubnets + 1;
+            const size_t drop = accept + 1;
+            std::vector<sock_filter> program;
+            auto jump = [&program](uint16_t condition, uint32_t k, size_t jumpTrue, size_t jumpFalse){
+                size_t next = program.size() + 1;
+                program.push_back(BPF_JUMP(BPF_JMP | condition | BPF_K, k, static_cast<uint8_t>(jumpTrue - next), static_cast<uint8_t>(jumpFalse - next)));
+            };
+            if(receiveOffloadEnabled){
+                program.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, udpHeaderSize));
+                jump(BPF_JEQ, 0x42, 2, 5);
+                program.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_LEN, 0));
+                program.push_back(BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, sizeof(udptouchpad::detail::SerializationTouchpadMessageUnion)));
+                jump(BPF_JEQ, udpHeaderSize, checkSource, drop);
+                jump(BPF_JEQ, 0x43, 6, drop);
+                program.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_LEN, 0));
+                jump(BPF_JGE, minBatchLength, checkSource, drop);
+            }
+            else{
+                program.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_LEN, 0));
+                jump(BPF_JEQ, messageLength, 2, 4);
+                program.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, udpHeaderSize));
+                jump(BPF_JEQ, 0x42, checkSource, drop);
+                jump(BPF_JGE, minBatchLength, 5, drop);
+                jump(BPF_JGT, maxBatchLength, drop, 6);
+                program.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, udpHeaderSize));
+                jump(BPF_JEQ, 0x43, checkSource, drop);
+            }
+            for(size_t i = 0; i < numSubnets; ++i){
+                program.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF + 12)));
+                program.push_back(BPF_STMT(BPF_ALU | BPF_AND | BPF_K, allowedSources[i].GetMask()));
+                jump(BPF_JEQ, allowedSources[i].address & allowedSources[i].GetMask(), accept, program.size() + 1);
+            }
+            program.push_back(BPF_STMT(BPF_RET | BPF_K, numSubnets ? 0 : 0xFFFFFFFF));
+            program.push_back(BPF_STMT(BPF_RET | BPF_K, 0xFFFFFFFF));
+            program.push_back(BPF_STMT(BPF_RET | BPF_K, 0));
+            sock_fprog filter;
+            filter.len = static_cast<unsigned short>(program.size());
+            filter.filter = program.data();
+            return (0 == SetOption(SOL_SOCKET, SO_ATTACH_FILTER, (const void*)&filter, sizeof(filter)));
+            #else
+            #error "Platform is not supported!"
+            #endif
+        }
+
+        /**
+         * @brief Let the kernel coalesce consecutive datagrams of the same flow into one buffer (UDP GRO, Linux only). This
+         * saves a system call and a wake-up per datagram if a device sends faster than the receiving thread is scheduled.
+         * @return True if success, false if the kernel does not support UDP GRO.
+         */
+        bool EnableReceiveOffload(void){
+            #ifdef _WIN32
+            // receive segment coalescing is not used on windows
+            return false;
+            #elif __linux__
+            int enable = 1;
+            return (0 == SetOption(SOL_UDP, UDP_GRO, (const void*)&enable, sizeof(enable)));
+            #else
+            #error "Platform is not supported!"
+            #endif
+        }
+
+        /**
+         * @brief Set the size of the receive buffer. On Linux, SO_RCVBUFFORCE is tried first, so that processes with CAP_NET_ADMIN
+         * are not limited by net.core.rmem_max.
+         * @param[in] size The size in bytes.
+         * @return True if success, false otherwise.
+         */
+        bool SetReceiveBufferSize(uint32_t size){
+            int value = static_cast<int>(std::min<uint32_t>(size, static_cast<uint32_t>(std::numeric_limits<int>::max())));
+            #ifdef _WIN32
+            return (0 == SetOption(SOL_SOCKET, SO_RCVBUF, (const void*)&value, sizeof(value)));
+            #elif __linux__
+            return (0 == SetOption(SOL_SOCKET, SO_RCVBUFFORCE, (const void*)&value, sizeof(value))) || (0 == SetOption(SOL_SOCKET, SO_RCVBUF, (const void*)&value, sizeof(value)));
+            #else
+            #error "Platform is not supported!"
+            #endif
+        }
+
+        /**
+         * @brief Let the kernel attach the cumulative number of dropped datagrams to each received datagram (Linux only).
+         */
+        void EnableDropCounter(void){
+            dropCounter = 0;
+            numDropped = 0;
+            numRejected = 0;
+            queueDrained = true;
+            queueFilled = false;
+            #ifdef _WIN32
+            // windows does not report dropped datagrams per socket
+            #elif __linux__
+            int enable = 1;
+            (void) SetOption(SOL_SOCKET, SO_RXQ_OVFL, (const void*)&enable, sizeof(enable));
+            #else
+            #error "Platform is not supported!"
+            #endif
+        }
+
+        /**
+         * @brief Check whether the receive queue of the socket is at least half full (Linux only).
+         * @return True if the receive queue is at least half full, false otherwise.
+         */
+        bool IsReceiveQueueHalfFull(void){
+            #ifdef _WIN32
+            return false;
+            #elif __linux__
+            uint32_t meminfo[SK_MEMINFO_VARS] = {};
+            socklen_t length = sizeof(meminfo);
+            if(getsockopt(_socket, SOL_SOCKET, SO_MEMINFO, &meminfo[0], &length) < 0){
+                return false;
+            }
+            return (2 * static_cast<uint64_t>(meminfo[SK_MEMINFO_RMEM_ALLOC])) >= static_cast<uint64_t>(meminfo[SK_MEMINFO_RCVBUF]);
+            #else
+            #error "Platform is not supported!"
+            #endif
+        }
+
+        /**
+         * @brief Get the names of all network interfaces on which the multicast group should be joined.
+         * @return All network interface names or only the interface selected by the endpoint. On windows, interfaces are not
+         * enumerated and the selected interface is returned as is.
+         */
+        std::vector<std::string> GetSelectedInterfaceNames(void){
+            std::vector<std::string> result = GetAllInterfaceNames();
+            if(!interfaceFilter.empty()){
+                #ifdef _WIN32
+                result = {interfaceFilter};
+                #elif __linux__
+                std::erase_if(result, [this](const std::string& interfaceName){ return interfaceName != interfaceFilter; });
+                #else
+                #error "Platform is not supported!"
+                #endif
+            }
+            return result;
+        }
+
         /**
          * @brief Get all network interface names.
          * @return List of all network interface names. On windows, only the default interface ("0.0.0.0") is returned.
@@ -261,25 +746,7 @@ class MulticastSocket {
             }
             else{
                 for(auto&& interfaceName : interfaceNames){
-                    #ifdef _WIN32
-                    uint8_t index = static_cast<uint8_t>(if_nametoindex(interfaceName.c_str()));
-                    char strInterface[16];
-                    sprintf(&strInterface[0], "0.0.0.%u", index);
-                    struct ip_mreq mreq;
-                    mreq.imr_multiaddr.s_addr = inet_addr(strGroupAddress);
-                    mreq.imr_interface.s_addr = inet_addr(strInterface);
-                    #elif __linux__
-                    struct ip_mreqn mreq;
-                    mreq.imr_multiaddr.s_addr = inet_addr(strGroupAddress);
-                    mreq.imr_address.s_addr = htonl(INADDR_ANY);
-                    mreq.imr_ifindex = if_nametoindex(interfaceName.c_str());
-                    #else
-                    #error "Platform is not supported!"
-                    #endif
-
-                    ResetLastError();
-                    if(SetOption(IPPROTO_IP, IP_ADD_MEMBERSHIP, (const void*) &mreq, sizeof(mreq)) < 0){
-                        errorString = GenerateErrorString("Failed to join multicast group on interface \"" + interfaceName + "\"!");
+                    if(!JoinMulticastGroupOnInterface(strGroupAddress, interfaceName)){
                         return false;
                     }
                 }
@@ -287,6 +754,37 @@ class MulticastSocket {
             return true;
         }
 
+        /**
+         * @brief Join a multicast group on a single network interface.
+         * @param[in] strGroupAddress The group address to be joined.
+         * @param[in] interfaceName The network interface on which to join.
+         * @return True if success, false otherwise.
+         */
+        bool JoinMulticastGroupOnInterface(const char* strGroupAddress, const std::string& interfaceName){
+            #ifdef _WIN32
+            uint8_t index = static_cast<uint8_t>(if_nametoindex(interfaceName.c_str()));
+            char strInterface[16];
+            sprintf(&strInterface[0], "0.0.0.%u", index);
+            struct ip_mreq mreq;
+            mreq.imr_multiaddr.s_addr = inet_addr(strGroupAddress);
+            mreq.imr_interface.s_addr = inet_addr(strInterface);
+            #elif __linux__
+            struct ip_mreqn mreq;
+            mreq.imr_multiaddr.s_addr = inet_addr(strGroupAddress);
+            mreq.imr_address.s_addr = htonl(INADDR_ANY);
+            mreq.imr_ifindex = if_nametoindex(interfaceName.c_str());
+            #else
+            #error "Platform is not supported!"
+            #endif
+
+            ResetLastError();
+            if(SetOption(IPPROTO_IP, IP_ADD_MEMBERSHIP, (const void*) &mreq, sizeof(mreq)) < 0){
+                errorString = GenerateErrorString("Failed to join multicast group on interface \"" + interfaceName + "\"!");
+                return false;
+            }
+            return true;
+        }
+
         /**
          * @brief Leave a multicast group on a given list of network interfaces.
          * @param[in] strGroupAddress The group address to be left.
@@ -311,27 +809,36 @@ class MulticastSocket {
             }
             else{
                 for(auto&& interfaceName : interfaceNames){
-                    #ifdef _WIN32
-                    uint8_t index = static_cast<uint8_t>(if_nametoindex(interfaceName.c_str()));
-                    char strInterface[16];
-                    sprintf(&strInterface[0], "0.0.0.%u", index);
-                    struct ip_mreq mreq;
-                    mreq.imr_multiaddr.s_addr = inet_addr(strGroupAddress);
-                    mreq.imr_interface.s_addr = inet_addr(strInterface);
-                    #elif __linux__
-                    struct ip_mreqn mreq;
-                    mreq.imr_multiaddr.s_addr = inet_addr(strGroupAddress);
-                    mreq.imr_address.s_addr = htonl(INADDR_ANY);
-                    mreq.imr_ifindex = if_nametoindex(interfaceName.c_str());
-                    #else
-                    #error "Platform is not supported!"
-                    #endif
-
-                    (void) SetOption(IPPROTO_IP, IP_DROP_MEMBERSHIP, (const void*) &mreq, sizeof(mreq));
+                    LeaveMulticastGroupOnInterface(strGroupAddress, interfaceName);
                 }
             }
         }
 
+        /**
+         * @brief Leave a multicast group on a single network interface.
+         * @param[in] strGroupAddress The group address to be left.
+         * @param[in] interfaceName The network interface on which to leave.
+         */
+        void LeaveMulticastGroupOnInterface(const char* strGroupAddress, const std::string& interfaceName){
+            #ifdef _WIN32
+            uint8_t index = static_cast<uint8_t>(if_nametoindex(interfaceName.c_str()));
+            char strInterface[16];
+            sprintf(&strInterface[0], "0.0.0.%u", index);
+            struct ip_mreq mreq;
+            mreq.imr_multiaddr.s_addr = inet_addr(strGroupAddress);
+            mreq.imr_interface.s_addr = inet_addr(strInterface);
+            #elif __linux__
+            struct ip_mreqn mreq;
+            mreq.imr_multiaddr.s_addr = inet_addr(strGroupAddress);
+            mreq.imr_address.s_addr = htonl(INADDR_ANY);
+            mreq.imr_ifindex = if_nametoindex(interfaceName.c_str());
+            #else
+            #error "Platform is not supported!"
+            #endif
+
+            (void) SetOption(IPPROTO_IP, IP_DROP_MEMBERSHIP, (const void*) &mreq, sizeof(mreq));
+        }
+
         /**
          * @brief Set socket options using the setsockopt() function.
          * @param[in] level The level at which the option is defined (for example, SOL_SOCKET).
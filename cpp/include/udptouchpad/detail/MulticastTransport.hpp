@@ -0,0 +1,378 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/Transport.hpp>
+#include <udptouchpad/detail/MulticastSocket.hpp>
+#include <udptouchpad/detail/IoUringReceiver.hpp>
+#include <udptouchpad/detail/SocketPoller.hpp>
+#include <udptouchpad/detail/NetworkConfiguration.hpp>
+#include <udptouchpad/detail/Trace.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Receives datagrams via multicast UDP on all endpoints of a network configuration. This is the default transport of
+ * an event system.
+ */
+class MulticastTransport: public udptouchpad::Transport {
+    public:
+        /**
+         * @brief Construct a new multicast transport with the default network configuration.
+         */
+        MulticastTransport(): wakeRequested(false), useIoUring(true) {}
+
+        /**
+         * @brief Destroy the multicast transport.
+         */
+        ~MulticastTransport(){
+            Close();
+        }
+
+        /**
+         * @brief Set the network configuration to be used the next time the transport is opened.
+         * @param[in] configuration The new network configuration.
+         */
+        void SetNetworkConfiguration(const udptouchpad::NetworkConfiguration& configuration){
+            networkConfiguration = configuration;
+            endpoints = configuration.GetEndpoints();
+        }
+
+        /**
+         * @brief Open one socket per endpoint. For multiple endpoints, all sockets are registered at a poller.
+         * @return True if success, false otherwise.
+         * @details The receive buffer is allocated once and reused whenever the transport is opened again. UDP GRO is not
+         * enabled on a socket that is received via io_uring, because the provided buffers only hold a single datagram.
+         */
+        bool Open(void){
+            wakeRequested = false;
+            rxBuffer.resize(rxBufferSize);
+            dropReports.resize(endpoints.size());
+            if(1 == endpoints.size()){
+                udptouchpad::NetworkConfiguration configuration = networkConfiguration;
+                #ifdef UDP_TOUCHPAD_ENABLE_IO_URING
+                configuration.receiveOffload = configuration.receiveOffload && !useIoUring;
+                #endif
+                if(!udpSocket.Open(endpoints[0], configuration)){
+                    errorString = udpSocket.GetErrorString();
+                    return false;
+                }
+                return true;
+            }
+
+            // (re)-open all sockets and register them together with their interface monitors
+            bool success = poller.Open();
+            errorString = poller.GetErrorString();
+            endpointSockets.resize(endpoints.size());
+            for(size_t i = 0; success && (i < endpoints.size()); ++i){
+                if(!endpointSockets[i]){
+                    endpointSockets[i] = std::make_unique<udptouchpad::detail::MulticastSocket>();
+                }
+                if(!endpointSockets[i]->Open(endpoints[i], networkConfiguration)){
+                    errorString = endpointSockets[i]->GetErrorString();
+                    success = false;
+                    break;
+                }
+                int monitor = endpointSockets[i]->GetInterfaceMonitorDescriptor();
+                success = poller.Add(endpointSockets[i]->GetDescriptor(), static_cast<uint32_t>(2 * i)) && ((monitor < 0) || poller.Add(monitor, static_cast<uint32_t>(2 * i + 1)));
+                errorString = poller.GetErrorString();
+            }
+            if(!success){
+                Close();
+            }
+            return success;
+        }
+
+        /**
+         * @brief Close all sockets.
+         */
+        void Close(void){
+            udpSocket.Close();
+            poller.Close();
+            for(auto&& endpointSocket : endpointSockets){
+                endpointSocket->Close();
+            }
+        }
+
+        /**
+         * @brief Receive datagrams until @ref WakeUp is called or an error occurs.
+         * @param[in] sink The sink to which all datagrams are passed.
+         * @return The reason why receiving has returned.
+         * @details For a single endpoint, io_uring is used if UDP_TOUCHPAD_ENABLE_IO_URING is defined. If io_uring is not
+         * available, an error is passed to the sink and the transport falls back to recvfrom. Datagrams from sources that are
+         * not allowed by the network configuration are also dropped here, in case the kernel filter is not available.
+         */
+        udptouchpad::TransportStatus Receive(udptouchpad::DatagramSink& sink){
+            if(endpoints.size() > 1){
+                return ReceiveFromEndpoints(sink);
+            }
+
+            // receive via io_uring, fall back to recvfrom if io_uring is not available
+            #ifdef UDP_TOUCHPAD_ENABLE_IO_URING
+            if(useIoUring){
+                if(ioUring.Open(udpSocket.GetDescriptor(), udpSocket.GetInterfaceMonitorDescriptor())){
+                    int32_t result = ReceiveViaIoUring(sink);
+                    ioUring.Close();
+                    if(-ENOBUFS != result){
+                        return (result < 0) ? udptouchpad::transport_status_error : udptouchpad::transport_status_stopped;
+                    }
+                    sink.ProcessTransportError("The io_uring provided buffer ring is not usable! Falling back to recvfrom.");
+                }
+                else{
+                    sink.ProcessTransportError(ioUring.GetErrorString() + " Falling back to recvfrom.");
+                }
+                useIoUring = false;
+            }
+            #endif
+
+            // receive via recvfrom
+            while(!wakeRequested && udpSocket.IsOpen()){
+                uint32_t source;
+                int32_t rx, errorCode, segmentSize;
+                {
+                    UDP_TOUCHPAD_TRACE_SCOPE("ReceiveFrom", 0);
+                    std::tie(rx, errorCode) = udpSocket.ReceiveFrom(source, segmentSize, &rxBuffer[0], rxBufferSize);
+                }
+                if(!udpSocket.IsOpen() || wakeRequested){
+                    break;
+                }
+                if(rx < 0){
+                    #ifdef _WIN32
+                    if(WSAEMSGSIZE == errorCode){
+                        continue;
+                    }
+                    #elif __linux__
+                    if(EINTR == errorCode){
+                        continue;
+                    }
+                    #else
+                    #error "Platform is not supported!"
+                    #endif
+                    errorString = "Failed to receive a message! Error code (" + std::to_string(errorCode) + ")";
+                    return udptouchpad::transport_status_error;
+                }
+                if(networkConfiguration.IsAllowedSource(source)){
+                    ProcessSegments(source, 0, rx, segmentSize, sink);
+                }
+                ReportDroppedDatagrams(udpSocket, 0, sink);
+                std::this_thread::yield();
+            }
+            return udptouchpad::transport_status_stopped;
+        }
+
+        /**
+         * @brief Wake up the thread that is blocked in @ref Receive. This member function can be called from any thread.
+         * @details On Linux, the socket is woken up via an event file descriptor and closed by the receiving thread itself, so
+         * that no descriptor is closed while another thread still waits on it. On other operating systems, the socket is
+         * closed to unblock the receiving thread.
+         */
+        void WakeUp(void){
+            wakeRequested = true;
+            udpSocket.WakeUp();
+            ioUring.WakeUp();
+            poller.WakeUp();
+        }
+
+        /**
+         * @brief Get the last error string.
+         * @return String giving information about the last error.
+         */
+        std::string GetErrorString(void){ return errorString; }
+
+    private:
+        /**
+         * @brief Datagrams that have been dropped on a socket, but have not yet been reported as error.
+         */
+        struct DropReport {
+            uint64_t numUnreported = 0;                                            // Number of dropped datagrams that have not been reported yet.
+            std::chrono::time_point<std::chrono::steady_clock> timeOfLastReport;   // Time when dropped datagrams have been reported the last time.
+        };
+
+        static constexpr size_t rxBufferSize = 65507;                                         // Size of the receive buffer, large enough for any UDP datagram and for datagrams that have been coalesced by UDP GRO.
+        static constexpr size_t maxMessagesPerWakeUp = 64;                                    // Maximum number of messages that are received from one endpoint socket per wake-up.
+        std::atomic<bool> wakeRequested;                                                      // True if @ref WakeUp has been called since the transport has been opened.
+        bool useIoUring;                                                                      // False if io_uring turned out to be unavailable, so that recvfrom is used from then on.
+        udptouchpad::NetworkConfiguration networkConfiguration;                               // Network configuration that is applied when the transport is opened.
+        std::vector<udptouchpad::NetworkEndpoint> endpoints;                                  // All endpoints on which messages are received.
+        udptouchpad::detail::MulticastSocket udpSocket;                                       // Multicast UDP socket for a single endpoint.
+        udptouchpad::detail::IoUringReceiver ioUring;                                         // Optional io_uring receive backend, only used if UDP_TOUCHPAD_ENABLE_IO_URING is defined.
+        std::vector<std::unique_ptr<udptouchpad::detail::MulticastSocket>> endpointSockets;   // One socket per endpoint if more than one endpoint is configured.
+        udptouchpad::detail::SocketPoller poller;                                             // Waits for all endpoint sockets if more than one endpoint is configured.
+        std::vector<uint32_t> readyTags;                                                      // Tags of the readable endpoint sockets, reused whenever the poller is woken up.
+        std::vector<uint8_t> rxBuffer;                                                        // Buffer where to store received messages, reused whenever the transport is opened.
+        std::vector<DropReport> dropReports;                                                  // Dropped datagrams of each endpoint that have not yet been reported as error.
+        std::string errorString;                                                              // Error string, set if opening or receiving fails.
+
+        /**
+         * @brief Pass the datagrams of a receive buffer to a sink.
+         * @param[in] source The source address from where the datagrams were sent.
+         * @param[in] endpoint Index of the endpoint on which the datagrams have been received.
+         * @param[in] length The number of bytes in the receive buffer.
+         * @param[in] segmentSize The size of each datagram if the kernel coalesced several datagrams of the same source (UDP GRO).
+         * @param[in] sink The sink to which the datagrams are passed.
+         * @details All datagrams of a coalesced buffer share the same timestamp, which is the time when the buffer has been
+         * received. Only the last datagram may be shorter. Datagrams longer than @ref UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE are
+         * skipped, because the kernel filter only sees the length of the whole buffer if datagrams have been coalesced.
+         */
+        void ProcessSegments(uint32_t source, size_t endpoint, int32_t length, int32_t segmentSize, udptouchpad::DatagramSink& sink){
+            auto timestamp = std::chrono::steady_clock::now();
+            segmentSize = (segmentSize > 0) ? segmentSize : length;
+            for(int32_t offset = 0; offset < length; offset += segmentSize){
+                int32_t datagramLength = std::min(segmentSize, length - offset);
+                if(datagramLength <= UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE){
+                    sink.ProcessDatagram(source, static_cast<uint16_t>(endpoint), &rxBuffer[offset], datagramLength, timestamp);
+                }
+            }
+        }
+
+        /**
+         * @brief Pass the datagrams that have been dropped by the kernel on a socket to the sink. If datagrams have been dropped,
+         * because the receive buffer was full, the receive buffer is grown and an error is reported.
+         * @param[in] socket The socket on which the datagrams have been dropped.
+         * @param[in] endpoint Index of the endpoint.
+         * @param[in] sink The sink to which the dropped datagrams are reported.
+         * @details Errors are reported whenever the receive buffer has been grown and otherwise at most once per second and
+         * endpoint, so that a burst of drops does not flood the error events.
+         */
+        void ReportDroppedDatagrams(udptouchpad::detail::MulticastSocket& socket, size_t endpoint, udptouchpad::DatagramSink& sink){
+            uint64_t numDropped, numRejected;
+            if(!socket.TakeDroppedDatagrams(numDropped, numRejected)){
+                return;
+            }
+            sink.ProcessDroppedDatagrams(static_cast<uint16_t>(endpoint), numDropped, numRejected);
+            if(!numDropped){
+                return;
+            }
+            DropReport& report = dropReports[endpoint];
+            report.numUnreported += numDropped;
+            bool grown = socket.GrowReceiveBuffer();
+            auto timeNow = std::chrono::steady_clock::now();
+            if(grown || ((timeNow - report.timeOfLastReport) >= std::chrono::seconds(1))){
+                std::string msg = "The kernel dropped " + std::to_string(report.numUnreported) + " datagrams on endpoint " + std::to_string(endpoint) + ", because the receive buffer was full!";
+                if(grown){
+                    msg += " The receive buffer has been grown to " + std::to_string(socket.GetReceiveBufferSize()) + " bytes.";
+                }
+                sink.ProcessTransportError(msg);
+                report.numUnreported = 0;
+                report.timeOfLastReport = timeNow;
+            }
+        }
+
+        /**
+         * @brief Receive messages via io_uring until the socket is closed or an error occurs.
+         * @param[in] sink The sink to which all datagrams are passed.
+         * @return Zero if the socket has been closed or the transport has been woken up, a negative error code otherwise.
+         */
+        int32_t ReceiveViaIoUring(udptouchpad::DatagramSink& sink){
+            while(!wakeRequested && udpSocket.IsOpen()){
+                UDP_TOUCHPAD_TRACE_SCOPE("IoUringReceive", 0);
+                int32_t result = ioUring.Receive([this, &sink](uint32_t source, uint8_t* bytes, int32_t length){
+                    if(networkConfiguration.IsAllowedSource(source)){
+                        sink.ProcessDatagram(source, 0, bytes, length, std::chrono::steady_clock::now());
+                    }
+                }, [this](){
+                    udpSocket.UpdateMulticastMembership();
+                });
+                udpSocket.CountDroppedDatagrams(ioUring.GetDropCounter());
+                udpSocket.SampleReceiveQueue();
+                ReportDroppedDatagrams(udpSocket, 0, sink);
+                if(!udpSocket.IsOpen() || wakeRequested){
+                    break;
+                }
+                if(-ENOBUFS == result){
+                    return result;
+                }
+                if(result < 0){
+                    errorString = ioUring.GetErrorString();
+                    return result;
+                }
+            }
+            return 0;
+        }
+
+        /**
+         * @brief Receive messages from all endpoint sockets until an error occurs or the transport has been woken up.
+         * @param[in] sink The sink to which all datagrams are passed.
+         * @return The reason why receiving has returned.
+         * @details The io_uring receive backend is not used for multiple endpoints.
+         */
+        udptouchpad::TransportStatus ReceiveFromEndpoints(udptouchpad::DatagramSink& sink){
+            // wait for readable sockets, even tags belong to sockets and odd tags to interface monitors
+            while(!wakeRequested){
+                int32_t numReady;
+                {
+                    UDP_TOUCHPAD_TRACE_SCOPE("EndpointWait", 0);
+                    numReady = poller.Wait(readyTags);
+                }
+                if(wakeRequested){
+                    break;
+                }
+                if(numReady < 0){
+                    errorString = poller.GetErrorString();
+                    return udptouchpad::transport_status_error;
+                }
+                for(uint32_t tag : readyTags){
+                    size_t i = static_cast<size_t>(tag / 2);
+                    if(tag & 1){
+                        endpointSockets[i]->UpdateMulticastMembership();
+                    }
+                    else if(!ReceiveFromEndpoint(i, sink)){
+                        return udptouchpad::transport_status_error;
+                    }
+                }
+            }
+            return udptouchpad::transport_status_stopped;
+        }
+
+        /**
+         * @brief Receive the messages that are pending on a readable endpoint socket.
+         * @param[in] endpoint Index of the endpoint.
+         * @param[in] sink The sink to which all datagrams are passed.
+         * @return True if success, false if receiving failed.
+         * @details At most @ref maxMessagesPerWakeUp messages are received, so that a busy endpoint cannot starve the others.
+         * On Windows, only one message is received, because the socket would block if no more messages are pending.
+         */
+        bool ReceiveFromEndpoint(size_t endpoint, udptouchpad::DatagramSink& sink){
+            for(size_t n = 0; n < maxMessagesPerWakeUp; ++n){
+                uint32_t source;
+                int32_t rx, errorCode, segmentSize;
+                {
+                    UDP_TOUCHPAD_TRACE_SCOPE("ReceiveFrom", endpoint);
+                    std::tie(rx, errorCode) = endpointSockets[endpoint]->ReceiveFrom(source, segmentSize, &rxBuffer[0], rxBufferSize, false);
+                }
+                if(rx < 0){
+                    #ifdef _WIN32
+                    bool success = (WSAEMSGSIZE == errorCode);
+                    #elif __linux__
+                    bool success = (EAGAIN == errorCode) || (EWOULDBLOCK == errorCode) || (EINTR == errorCode);
+                    #else
+                    #error "Platform is not supported!"
+                    #endif
+                    if(!success){
+                        errorString = "Failed to receive a message on endpoint " + std::to_string(endpoint) + "! Error code (" + std::to_string(errorCode) + ")";
+                    }
+                    return success;
+                }
+                if(networkConfiguration.IsAllowedSource(source)){
+                    ProcessSegments(source, endpoint, rx, segmentSize, sink);
+                }
+                ReportDroppedDatagrams(*endpointSockets[endpoint], endpoint, sink);
+                #ifdef _WIN32
+                break;
+                #endif
+            }
+            return true;
+        }
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
@@ -0,0 +1,155 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief A multicast group and port on which messages are received, optionally restricted to one network interface.
+ */
+class NetworkEndpoint {
+    public:
+        std::string groupAddress;    // IPv4 multicast group address to which the UDP touchpad apps send their messages.
+        uint16_t port;               // Destination port of the messages.
+        std::string interfaceName;   // Name of the network interface on which the group is joined or empty to join the group on all interfaces.
+
+        /**
+         * @brief Construct a new network endpoint with the default group address and port of the UDP touchpad app on all interfaces.
+         */
+        NetworkEndpoint(): groupAddress(UDP_TOUCHPAD_MULTICAST_GROUP_ADDRESS), port(UDP_TOUCHPAD_MULTICAST_DESTINATION_PORT) {}
+
+        /**
+         * @brief Construct a new network endpoint.
+         * @param[in] groupAddress IPv4 multicast group address.
+         * @param[in] port Destination port of the messages.
+         * @param[in] interfaceName Name of the network interface or empty to join the group on all interfaces.
+         */
+        NetworkEndpoint(const std::string& groupAddress, uint16_t port, const std::string& interfaceName = ""): groupAddress(groupAddress), port(port), interfaceName(interfaceName) {}
+
+        /**
+         * @brief Check whether this endpoint is equal to another endpoint.
+         * @param[in] e The endpoint with which to compare equality.
+         * @return True if e is equal to this, false otherwise.
+         */
+        bool IsEqual(const NetworkEndpoint& e) const {
+            return (groupAddress == e.groupAddress) && (port == e.port) && (interfaceName == e.interfaceName);
+        }
+};
+
+
+/**
+ * @brief An IPv4 subnet from which messages are accepted.
+ */
+class SourceSubnet {
+    public:
+        uint32_t address;        // The IPv4 address of the subnet in host byte order, which is equal to the device ID.
+        uint32_t prefixLength;   // Number of leading bits of the address that must match, 32 to accept a single device.
+
+        /**
+         * @brief Construct a new source subnet that accepts all addresses.
+         */
+        SourceSubnet(): address(0), prefixLength(0) {}
+
+        /**
+         * @brief Construct a new source subnet.
+         * @param[in] address The IPv4 address of the subnet in dotted notation, e.g. "192.168.1.0".
+         * @param[in] prefixLength Number of leading bits of the address that must match, e.g. 24. Values greater than 32 are treated as 32.
+         */
+        SourceSubnet(const std::string& address, uint32_t prefixLength): address(ntohl(inet_addr(address.c_str()))), prefixLength(std::min(prefixLength, uint32_t(32))) {}
+
+        /**
+         * @brief Get the mask of the subnet.
+         * @return The mask in host byte order.
+         */
+        uint32_t GetMask(void) const { return prefixLength ? (uint32_t(0xFFFFFFFF) << (32 - prefixLength)) : uint32_t(0); }
+
+        /**
+         * @brief Check whether an address belongs to this subnet.
+         * @param[in] source The IPv4 address in host byte order, which is equal to the device ID.
+         * @return True if the address belongs to this subnet, false otherwise.
+         */
+        bool Contains(uint32_t source) const { return ((source ^ address) & GetMask()) == 0; }
+
+        /**
+         * @brief Check whether this subnet is equal to another subnet.
+         * @param[in] s The subnet with which to compare equality.
+         * @return True if s is equal to this, false otherwise.
+         */
+        bool IsEqual(const SourceSubnet& s) const {
+            return (address == s.address) && (prefixLength == s.prefixLength);
+        }
+};
+
+
+/**
+ * @brief Network settings of an event system. The settings are applied whenever the event system is started, see
+ * @ref EventSystem::Start and @ref EventSystem::Restart.
+ */
+class NetworkConfiguration {
+    public:
+        std::string groupAddress;                                // IPv4 multicast group address to which the UDP touchpad apps send their messages.
+        uint16_t port;                                           // Destination port of the messages.
+        uint32_t retryTimeMs;                                    // Time in milliseconds to wait before the socket is re-opened in case of errors.
+        bool sharedReceiver;                                     // True if the socket and the receive thread should be shared with all other event systems of this process that use the same endpoints.
+        std::vector<udptouchpad::NetworkEndpoint> endpoints;     // If not empty, messages are received on all of these endpoints instead of @ref groupAddress and @ref port. Devices are tagged with the index of their endpoint.
+        std::vector<udptouchpad::SourceSubnet> allowedSources;   // If not empty, only messages from these subnets are processed, all other messages are dropped.
+        bool kernelFilter;                                       // True if a socket filter should drop malformed messages and messages from sources that are not allowed in the kernel (Linux only).
+        uint32_t receiveBufferSize;                              // Size of the socket receive buffer in bytes or zero to keep the default of the operating system.
+        uint32_t maxReceiveBufferSize;                           // If greater than @ref receiveBufferSize, the receive buffer is doubled up to this size whenever the kernel reports datagrams that have been dropped because the buffer was full (Linux only).
+        bool receiveOffload;                                     // True if the kernel may coalesce consecutive datagrams of the same device into one buffer (UDP GRO), which is split again in user space (Linux only, not used with io_uring).
+
+        /**
+         * @brief Construct a new network configuration with the default settings of the UDP touchpad app.
+         */
+        NetworkConfiguration(): groupAddress(UDP_TOUCHPAD_MULTICAST_GROUP_ADDRESS), port(UDP_TOUCHPAD_MULTICAST_DESTINATION_PORT), retryTimeMs(UDP_TOUCHPAD_REOPEN_SOCKET_RETRY_TIME_MS), sharedReceiver(false), kernelFilter(true), receiveBufferSize(UDP_TOUCHPAD_RECEIVE_BUFFER_SIZE), maxReceiveBufferSize(UDP_TOUCHPAD_MAX_RECEIVE_BUFFER_SIZE), receiveOffload(true) {}
+
+        /**
+         * @brief Get all endpoints on which messages are received.
+         * @return The @ref endpoints or, if empty, a single endpoint with @ref groupAddress and @ref port on all interfaces.
+         */
+        std::vector<udptouchpad::NetworkEndpoint> GetEndpoints(void) const {
+            if(endpoints.empty()){
+                return {udptouchpad::NetworkEndpoint(groupAddress, port)};
+            }
+            return endpoints;
+        }
+
+        /**
+         * @brief Check whether messages from a source are processed.
+         * @param[in] source The IPv4 address of the source in host byte order, which is equal to the device ID.
+         * @return True if @ref allowedSources is empty or if one of the subnets contains the source, false otherwise.
+         */
+        bool IsAllowedSource(uint32_t source) const {
+            return allowedSources.empty() || std::any_of(allowedSources.begin(), allowedSources.end(), [source](const udptouchpad::SourceSubnet& subnet){ return subnet.Contains(source); });
+        }
+
+        /**
+         * @brief Check whether this configuration receives on the same endpoints as another configuration.
+         * @param[in] c The configuration with which to compare the endpoints.
+         * @return True if both configurations receive on the same endpoints in the same order, false otherwise.
+         */
+        bool HasEqualEndpoints(const NetworkConfiguration& c) const {
+            std::vector<udptouchpad::NetworkEndpoint> a = GetEndpoints();
+            std::vector<udptouchpad::NetworkEndpoint> b = c.GetEndpoints();
+            return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const udptouchpad::NetworkEndpoint& x, const udptouchpad::NetworkEndpoint& y){ return x.IsEqual(y); });
+        }
+
+        /**
+         * @brief Check whether this configuration receives messages exactly like another configuration, that is on the same
+         * endpoints with the same sources, socket options and retry time.
+         * @param[in] c The configuration with which to compare the receive settings.
+         * @return True if all settings except @ref sharedReceiver are equal, false otherwise.
+         */
+        bool HasEqualReceiveSettings(const NetworkConfiguration& c) const {
+            bool equal = HasEqualEndpoints(c) && (retryTimeMs == c.retryTimeMs) && (kernelFilter == c.kernelFilter) && (receiveOffload == c.receiveOffload);
+            equal &= (receiveBufferSize == c.receiveBufferSize) && (maxReceiveBufferSize == c.maxReceiveBufferSize);
+            return equal && std::equal(allowedSources.begin(), allowedSources.end(), c.allowedSources.begin(), c.allowedSources.end(), [](const udptouchpad::SourceSubnet& x, const udptouchpad::SourceSubnet& y){ return x.IsEqual(y); });
+        }
+};
+
+
+} /* namespace: udptouchpad */
+
@@ -0,0 +1,61 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief Selects how the data of all messages within one rate limiting window is combined.
+ */
+enum RateLimitPolicy: uint8_t {
+    rate_limit_latest = 0,     // Only the latest data of the window is reported.
+    rate_limit_average = 1,    // The average of all data within the window is reported.
+    rate_limit_envelope = 2    // Two motion sensor events are reported per window, containing the component-wise minimum and maximum. Touchpad pointer events report the latest data.
+};
+
+
+/**
+ * @brief Limits the rate of touchpad pointer and motion sensor events of a device.
+ * @details Changes of the pressed state of touchpad pointers are never coalesced, so that no tap is lost.
+ */
+class RateLimit {
+    public:
+        double maxEventRate;                       // Maximum number of events per second for each event type, zero disables rate limiting.
+        udptouchpad::RateLimitPolicy policy;       // Selects how the data within one window is combined.
+
+        /**
+         * @brief Construct a new rate limit that is disabled.
+         */
+        RateLimit(): maxEventRate(0.0), policy(udptouchpad::rate_limit_latest) {}
+
+        /**
+         * @brief Construct a new rate limit.
+         * @param[in] maxEventRate Maximum number of events per second for each event type, zero disables rate limiting.
+         * @param[in] policy Selects how the data within one window is combined.
+         */
+        RateLimit(double maxEventRate, udptouchpad::RateLimitPolicy policy): maxEventRate(maxEventRate), policy(policy) {}
+
+        /**
+         * @brief Check whether rate limiting is enabled.
+         * @return True if enabled, false otherwise.
+         */
+        bool IsEnabled(void) const { return maxEventRate > 0.0; }
+
+        /**
+         * @brief Get the length of one rate limiting window.
+         * @return The window length or zero if rate limiting is disabled.
+         */
+        std::chrono::steady_clock::duration GetWindowLength(void) const {
+            if(!IsEnabled()){
+                return std::chrono::steady_clock::duration::zero();
+            }
+            return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / maxEventRate));
+        }
+};
+
+
+} /* namespace: udptouchpad */
+
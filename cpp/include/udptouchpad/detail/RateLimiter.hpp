@@ -0,0 +1,248 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/Events.hpp>
+#include <udptouchpad/detail/RateLimit.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Coalesces the touchpad pointer and motion sensor events of one device according to a @ref RateLimit. All state
+ * has a fixed size, so that no memory is allocated.
+ */
+class RateLimiter {
+    public:
+        /**
+         * @brief Construct a new rate limiter without pending data.
+         */
+        RateLimiter(): pointerSamples(0), pointerEmitted(false), motionSamples(0), motionEmitted(false) { pointerPressed.fill(false); }
+
+        /**
+         * @brief Add a touchpad pointer event to the current window.
+         * @param[in] e The touchpad pointer event.
+         * @param[in] limit The rate limit.
+         * @param[out] out Events to be emitted immediately.
+         * @param[out] numCoalesced Incremented by the number of events that have been coalesced into others.
+         * @return The number of events that have been written to out.
+         * @details If the pressed state of any pointer changes, the current window is emitted and the new event is emitted
+         * immediately as well, so that no tap is lost. If the window has already expired, the window including the new event
+         * is emitted immediately. Otherwise the window is emitted by @ref PopTouchpadPointer as soon as it expires.
+         */
+        size_t PushTouchpadPointer(const udptouchpad::TouchpadPointerEvent& e, const udptouchpad::RateLimit& limit, std::array<udptouchpad::TouchpadPointerEvent,2>& out, uint64_t& numCoalesced){
+            size_t n = 0;
+            bool pressedChanged = false;
+            for(size_t i = 0; i < e.pointer.size(); ++i){
+                pressedChanged |= (e.pointer[i].pressed != pointerPressed[i]);
+                pointerPressed[i] = e.pointer[i].pressed;
+            }
+            if(pressedChanged && pointerSamples){
+                out[n++] = EmitTouchpadPointer(e.timestamp, limit, numCoalesced);
+            }
+            AccumulateTouchpadPointer(e);
+            if(pressedChanged || !pointerEmitted || ((e.timestamp - pointerLastEmit) >= limit.GetWindowLength())){
+                out[n++] = EmitTouchpadPointer(e.timestamp, limit, numCoalesced);
+            }
+            return n;
+        }
+
+        /**
+         * @brief Take the touchpad pointer event of the current window if the window has expired.
+         * @param[in] now The current time.
+         * @param[in] limit The rate limit.
+         * @param[out] out The event to be emitted.
+         * @param[out] numCoalesced Incremented by the number of events that have been coalesced into others.
+         * @return True if an event has been written to out, false otherwise.
+         */
+        bool PopTouchpadPointer(const std::chrono::time_point<std::chrono::steady_clock> now, const udptouchpad::RateLimit& limit, udptouchpad::TouchpadPointerEvent& out, uint64_t& numCoalesced){
+            if(!pointerSamples || ((now - pointerLastEmit) < limit.GetWindowLength())){
+                return false;
+            }
+            out = EmitTouchpadPointer(now, limit, numCoalesced);
+            return true;
+        }
+
+        /**
+         * @brief Add a motion sensor event to the current window.
+         * @param[in] e The motion sensor event.
+         */
+        void PushMotionSensor(const udptouchpad::MotionSensorEvent& e){
+            if(!motionSamples){
+                motionSum.fill(0.0);
+                motionMin.fill(std::numeric_limits<float>::infinity());
+                motionMax.fill(-std::numeric_limits<float>::infinity());
+                if(!motionEmitted){
+                    motionLastEmit = e.timestamp - std::chrono::hours(1);
+                }
+            }
+            motionLatest = e;
+            for(size_t i = 0; i < 3; ++i){
+                AccumulateMotionSensor(i, e.rotationVector[i]);
+                AccumulateMotionSensor(3 + i, e.acceleration[i]);
+                AccumulateMotionSensor(6 + i, e.angularRate[i]);
+            }
+            motionSamples++;
+        }
+
+        /**
+         * @brief Take the motion sensor events that are to be emitted.
+         * @param[in] now The current time.
+         * @param[in] limit The rate limit.
+         * @param[out] out Events to be emitted.
+         * @param[out] numCoalesced Incremented by the number of events that have been coalesced into others.
+         * @return The number of events that have been written to out.
+         */
+        size_t PopMotionSensor(const std::chrono::time_point<std::chrono::steady_clock> now, const udptouchpad::RateLimit& limit, std::array<udptouchpad::MotionSensorEvent,2>& out, uint64_t& numCoalesced){
+            if(!motionSamples || ((now - motionLastEmit) < limit.GetWindowLength())){
+                return 0;
+            }
+            size_t n = 0;
+            if((udptouchpad::rate_limit_envelope == limit.policy) && (motionSamples > 1)){
+                out[n] = motionLatest;
+                Fill(out[n++], motionMin);
+                out[n] = motionLatest;
+                Fill(out[n++], motionMax);
+                numCoalesced += motionSamples - 2;
+            }
+            else if(udptouchpad::rate_limit_average == limit.policy){
+                out[n] = motionLatest;
+                std::array<double,9> average;
+                for(size_t i = 0; i < average.size(); ++i){
+                    average[i] = motionSum[i] / static_cast<double>(motionSamples);
+                }
+                Fill(out[n++], average);
+                numCoalesced += motionSamples - 1;
+            }
+            else{
+                out[n++] = motionLatest;
+                numCoalesced += motionSamples - 1;
+            }
+            motionSamples = 0;
+            motionLastEmit = now;
+            motionEmitted = true;
+            return n;
+        }
+
+        /**
+         * @brief Get the time when the earliest window that contains events expires.
+         * @param[in] limit The rate limit.
+         * @param[out] expiry The time when the earliest window expires.
+         * @return True if any window contains events, false otherwise.
+         */
+        bool GetExpiry(const udptouchpad::RateLimit& limit, std::chrono::time_point<std::chrono::steady_clock>& expiry) const {
+            if(!pointerSamples && !motionSamples){
+                return false;
+            }
+            const std::chrono::steady_clock::duration windowLength = limit.GetWindowLength();
+            if(pointerSamples){
+                expiry = pointerLastEmit + windowLength;
+            }
+            if(motionSamples){
+                expiry = pointerSamples ? std::min(expiry, motionLastEmit + windowLength) : (motionLastEmit + windowLength);
+            }
+            return true;
+        }
+
+    private:
+        /* touchpad pointer window */
+        uint32_t pointerSamples;                                               // Number of touchpad pointer events in the current window.
+        udptouchpad::TouchpadPointerEvent pointerLatest;                       // Latest touchpad pointer event of the current window.
+        double aspectRatioSum;                                                 // Sum of aspect ratios of the current window.
+        std::array<std::array<double,2>,10> positionSum;                       // Sum of pointer positions of the current window.
+        std::array<bool,10> pointerPressed;                                    // Pressed state of all pointers of the latest touchpad pointer event.
+        std::chrono::time_point<std::chrono::steady_clock> pointerLastEmit;    // Time when the last touchpad pointer event has been emitted.
+        bool pointerEmitted;                                                   // True if at least one touchpad pointer event has been emitted.
+
+        /* motion sensor window */
+        uint32_t motionSamples;                                                // Number of motion sensor events in the current window.
+        udptouchpad::MotionSensorEvent motionLatest;                           // Latest motion sensor event of the current window.
+        std::array<double,9> motionSum;                                        // Component-wise sum of rotation vector, acceleration and angular rate.
+        std::array<double,9> motionMin;                                        // Component-wise minimum of rotation vector, acceleration and angular rate.
+        std::array<double,9> motionMax;                                        // Component-wise maximum of rotation vector, acceleration and angular rate.
+        std::chrono::time_point<std::chrono::steady_clock> motionLastEmit;     // Time when the last motion sensor event has been emitted.
+        bool motionEmitted;                                                    // True if at least one motion sensor event has been emitted.
+
+        /**
+         * @brief Add a touchpad pointer event to the sums of the current window.
+         * @param[in] e The touchpad pointer event.
+         */
+        void AccumulateTouchpadPointer(const udptouchpad::TouchpadPointerEvent& e){
+            if(!pointerSamples){
+                aspectRatioSum = 0.0;
+                for(auto&& p : positionSum){
+                    p.fill(0.0);
+                }
+            }
+            pointerLatest = e;
+            aspectRatioSum += e.aspectRatio;
+            for(size_t i = 0; i < e.pointer.size(); ++i){
+                positionSum[i][0] += e.pointer[i].position[0];
+                positionSum[i][1] += e.pointer[i].position[1];
+            }
+            pointerSamples++;
+        }
+
+        /**
+         * @brief Close the current touchpad pointer window.
+         * @param[in] now The current time.
+         * @param[in] limit The rate limit.
+         * @param[out] numCoalesced Incremented by the number of events that have been coalesced into the returned event.
+         * @return The event to be emitted. For @ref rate_limit_average, aspect ratio and positions of pressed pointers are
+         * averaged, all other values are taken from the latest event. All events of a window have the same pressed state,
+         * because a change of the pressed state closes the window.
+         */
+        udptouchpad::TouchpadPointerEvent EmitTouchpadPointer(const std::chrono::time_point<std::chrono::steady_clock> now, const udptouchpad::RateLimit& limit, uint64_t& numCoalesced){
+            udptouchpad::TouchpadPointerEvent e = pointerLatest;
+            if(udptouchpad::rate_limit_average == limit.policy){
+                double n = static_cast<double>(pointerSamples);
+                e.aspectRatio = aspectRatioSum / n;
+                for(size_t i = 0; i < e.pointer.size(); ++i){
+                    if(e.pointer[i].pressed){
+                        e.pointer[i].position[0] = positionSum[i][0] / n;
+                        e.pointer[i].position[1] = positionSum[i][1] / n;
+                    }
+                }
+            }
+            numCoalesced += pointerSamples - 1;
+            pointerSamples = 0;
+            pointerLastEmit = now;
+            pointerEmitted = true;
+            return e;
+        }
+
+        /**
+         * @brief Add a value to the sum, minimum and maximum of a motion sensor component.
+         * @param[in] index The component index.
+         * @param[in] value The value to be added.
+         */
+        void AccumulateMotionSensor(size_t index, float value){
+            motionSum[index] += static_cast<double>(value);
+            motionMin[index] = std::min(motionMin[index], static_cast<double>(value));
+            motionMax[index] = std::max(motionMax[index], static_cast<double>(value));
+        }
+
+        /**
+         * @brief Set rotation vector, acceleration and angular rate of a motion sensor event.
+         * @param[out] e The event to be set.
+         * @param[in] values Component-wise values of rotation vector, acceleration and angular rate.
+         */
+        static void Fill(udptouchpad::MotionSensorEvent& e, const std::array<double,9>& values){
+            for(size_t i = 0; i < 3; ++i){
+                e.rotationVector[i] = static_cast<float>(values[i]);
+                e.acceleration[i] = static_cast<float>(values[3 + i]);
+                e.angularRate[i] = static_cast<float>(values[6 + i]);
+            }
+        }
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
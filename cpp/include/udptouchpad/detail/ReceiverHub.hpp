@@ -0,0 +1,132 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/EventSystemNetworkBase.hpp>
+#include <udptouchpad/detail/MessageSink.hpp>
+#include <udptouchpad/detail/NetworkConfiguration.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Process-wide receiver that owns one socket and one worker thread for a set of receive settings. Every message is
+ * received and unpacked only once and then passed to all subscribed message sinks, e.g. event systems that have been started
+ * with @ref NetworkConfiguration::sharedReceiver. Each sink keeps its own event queues and filters.
+ */
+class ReceiverHub: public udptouchpad::detail::EventSystemNetworkBase {
+    public:
+        /**
+         * @brief Construct a new receiver hub. Use @ref Acquire to obtain the hub that is shared within the process.
+         * @param[in] configuration The network configuration of the hub.
+         */
+        explicit ReceiverHub(const udptouchpad::NetworkConfiguration& configuration){
+            SetNetworkConfiguration(configuration);
+        }
+
+        /**
+         * @brief Destroy the receiver hub.
+         */
+        ~ReceiverHub(){
+            StopWorkerThread();
+        }
+
+        /**
+         * @brief Get the process-wide receiver hub for the receive settings of a network configuration. A new hub is created if
+         * there is no hub with equal receive settings yet.
+         * @param[in] configuration The network configuration. A hub is only shared if all receive settings are equal, see
+         * @ref NetworkConfiguration::HasEqualReceiveSettings. Configurations that receive on the same endpoints with different
+         * sources or socket options get a hub of their own, so that no subscriber silently loses its settings.
+         * @return The shared receiver hub. The hub is destroyed as soon as the last owner releases it.
+         */
+        static std::shared_ptr<udptouchpad::detail::ReceiverHub> Acquire(const udptouchpad::NetworkConfiguration& configuration){
+            static std::mutex registryMutex;
+            static std::vector<std::weak_ptr<udptouchpad::detail::ReceiverHub>> registry;
+            const std::lock_guard<std::mutex> lock(registryMutex);
+            std::erase_if(registry, [](const std::weak_ptr<udptouchpad::detail::ReceiverHub>& entry){ return entry.expired(); });
+            for(auto&& entry : registry){
+                std::shared_ptr<udptouchpad::detail::ReceiverHub> hub = entry.lock();
+                if(hub && hub->GetNetworkConfiguration().HasEqualReceiveSettings(configuration)){
+                    return hub;
+                }
+            }
+            std::shared_ptr<udptouchpad::detail::ReceiverHub> hub = std::make_shared<udptouchpad::detail::ReceiverHub>(configuration);
+            registry.push_back(hub);
+            return hub;
+        }
+
+        /**
+         * @brief Pass all messages that are received from now on to a message sink. The worker thread is started with the
+         * first subscription.
+         * @param[in] sink The message sink to be subscribed.
+         */
+        void Subscribe(udptouchpad::detail::MessageSink* sink){
+            const std::lock_guard<std::mutex> lock(sinkMutex);
+            sinks.push_back(sink);
+            StartWorkerThread();
+        }
+
+        /**
+         * @brief Stop passing messages to a message sink.
+         * @param[in] sink The message sink to be unsubscribed.
+         * @details When this member function returns, the sink is not called anymore and can safely be destroyed.
+         */
+        void Unsubscribe(udptouchpad::detail::MessageSink* sink){
+            const std::lock_guard<std::mutex> lock(sinkMutex);
+            std::erase(sinks, sink);
+        }
+
+    protected:
+        /**
+         * @brief Pass an error message to all subscribed message sinks.
+         * @param[in] msg The error message to be handled.
+         */
+        void ProcessErrorMessage(const std::string& msg){
+            const std::lock_guard<std::mutex> lock(sinkMutex);
+            for(auto&& sink : sinks){
+                sink->ProcessErrorMessage(msg);
+            }
+        }
+
+        /**
+         * @brief Pass the number of messages that have been dropped by the kernel to all subscribed message sinks.
+         * @param[in] endpoint Index of the network endpoint on which the messages have been dropped.
+         * @param[in] numDropped Number of messages that have been dropped, because the receive buffer was full.
+         * @param[in] numRejected Number of messages that have been rejected by the kernel filter.
+         */
+        void ProcessDroppedMessages(const uint16_t endpoint, const uint64_t numDropped, const uint64_t numRejected){
+            const std::lock_guard<std::mutex> lock(sinkMutex);
+            for(auto&& sink : sinks){
+                sink->ProcessDroppedMessages(endpoint, numDropped, numRejected);
+            }
+        }
+
+        /**
+         * @brief Pass a received touch message to all subscribed message sinks.
+         * @param[in] source The source address from where the message was sent.
+         * @param[in] endpoint Index of the network endpoint on which the message has been received.
+         * @param[in] msg The message that has been received.
+         * @param[in] timestamp Time when the message has been received.
+         */
+        void ProcessTouchMessage(const uint32_t source, const uint16_t endpoint, const udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct& msg, const std::chrono::time_point<std::chrono::steady_clock> timestamp){
+            const std::lock_guard<std::mutex> lock(sinkMutex);
+            for(auto&& sink : sinks){
+                sink->ProcessTouchMessage(source, endpoint, msg, timestamp);
+            }
+        }
+
+    private:
+        std::mutex sinkMutex;                                  // Protects the list of message sinks.
+        std::vector<udptouchpad::detail::MessageSink*> sinks;   // All subscribed message sinks.
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
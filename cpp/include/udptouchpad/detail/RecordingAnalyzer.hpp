@@ -0,0 +1,436 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/TouchpadMessage.hpp>
+#include <udptouchpad/detail/Events.hpp>
+#include <udptouchpad/detail/CompactEvents.hpp>
+#include <udptouchpad/detail/DeviceDatabase.hpp>
+#include <udptouchpad/detail/EventFilter.hpp>
+#include <udptouchpad/detail/ChangeThresholds.hpp>
+#include <udptouchpad/detail/RateLimit.hpp>
+#include <udptouchpad/detail/Statistics.hpp>
+#include <udptouchpad/detail/MessageRecording.hpp>
+#include <udptouchpad/detail/MappedFile.hpp>
+#include <udptouchpad/detail/EventBatch.hpp>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief Statistics of one device that have been derived from recorded messages by the @ref RecordingAnalyzer.
+ */
+class RecordedDeviceReport {
+    public:
+        uint32_t deviceID;                                                   // The device ID, which is equal to the IPv4 address.
+        uint16_t endpoint;                                                   // Index of the network endpoint on which the latest message has been received.
+        std::chrono::time_point<std::chrono::steady_clock> firstTimestamp;   // Time when the first message has been received.
+        std::chrono::time_point<std::chrono::steady_clock> lastTimestamp;    // Time when the last message has been received.
+        uint64_t numMessages;                                                // Number of recorded touchpad messages.
+        uint64_t numInvalidMessages;                                         // Number of recorded messages with an invalid header, which are ignored.
+        uint64_t numLostMessages;                                            // Number of messages that are missing according to gaps in the message counter, including messages that arrive too late.
+        uint64_t numOutOfOrderMessages;                                      // Number of messages that have been discarded, because their message counter is older than the one of the previous message.
+        double meanMessageInterval;                                          // Mean time between two consecutive messages in seconds, gaps that exceed the disconnect timeout are excluded.
+        double stdMessageInterval;                                           // Standard deviation of the time between two consecutive messages in seconds.
+        double maxMessageInterval;                                           // Maximum time between two consecutive messages in seconds, gaps that exceed the disconnect timeout are excluded.
+        uint64_t numConnections;                                             // Number of connection events.
+        uint64_t numDisconnections;                                          // Number of disconnection events, either due to a timeout within or at the end of the recording.
+        uint64_t numTouchpadPointerEvents;                                   // Number of generated touchpad pointer events.
+        uint64_t numMotionSensorEvents;                                      // Number of generated motion sensor events.
+        uint64_t numTouches;                                                 // Number of times any pointer has been pressed.
+        double touchDuration;                                                // Total time in seconds during which at least one pointer has been pressed.
+        udptouchpad::Statistics statistics;                                  // Statistics about suppressed and coalesced events.
+
+        /**
+         * @brief Construct a new report, where all counters are zero.
+         */
+        RecordedDeviceReport(): deviceID(0), endpoint(0), numMessages(0), numInvalidMessages(0), numLostMessages(0), numOutOfOrderMessages(0), meanMessageInterval(0.0), stdMessageInterval(0.0), maxMessageInterval(0.0), numConnections(0), numDisconnections(0), numTouchpadPointerEvents(0), numMotionSensorEvents(0), numTouches(0), touchDuration(0.0) {}
+
+        /**
+         * @brief Get the recorded duration.
+         * @return Time in seconds between the first and the last message.
+         */
+        double GetDuration(void) const {
+            return std::chrono::duration<double>(lastTimestamp - firstTimestamp).count();
+        }
+
+        /**
+         * @brief Get the ratio of lost messages.
+         * @return Number of lost messages divided by the number of sent messages, where sent messages are either received or lost.
+         */
+        double GetLossRatio(void) const {
+            uint64_t numSent = numMessages + numLostMessages;
+            return numSent ? (static_cast<double>(numLostMessages) / static_cast<double>(numSent)) : 0.0;
+        }
+};
+
+
+namespace detail {
+
+
+/**
+ * @brief All recorded messages of one device, which point into the mapped recording files.
+ */
+class RecordedDeviceMessages {
+    public:
+        uint32_t deviceID;                                                  // The device ID, which is equal to the IPv4 address.
+        int64_t lastTimestamp;                                              // Timestamp of the last record that has been added.
+        bool sorted;                                                        // True if the records are sorted by their timestamp.
+        std::vector<const udptouchpad::detail::RecordedMessage*> records;   // All records of the device.
+
+        /**
+         * @brief Construct the messages of a device without any records.
+         * @param[in] deviceID The device ID.
+         */
+        explicit RecordedDeviceMessages(const uint32_t deviceID): deviceID(deviceID), lastTimestamp(std::numeric_limits<int64_t>::min()), sorted(true) {}
+};
+
+
+/**
+ * @brief Replays the recorded messages of one device after another through its own @ref DeviceDatabase. Each worker thread of
+ * the @ref RecordingAnalyzer owns one replay, so that devices are processed in parallel with the same merge logic as in the
+ * event system.
+ */
+class RecordingReplay {
+    public:
+        /**
+         * @brief Construct a new replay.
+         * @param[in] filter The filter that selects the devices, event types and screen region to be processed.
+         * @param[in] thresholds The deadband thresholds for the change detection.
+         * @param[in] limit The rate limit for all devices without a device-specific rate limit.
+         * @param[in] deviceLimits Device-specific rate limits.
+         * @param[in] fDeviceConnectionBatch Batch callback for device connection events or nullptr.
+         * @param[in] fCompactTouchpadPointerBatch Batch callback for compact touchpad pointer events or nullptr.
+         * @param[in] fMotionSensorBatch Batch callback for motion sensor events or nullptr.
+         */
+        RecordingReplay(const udptouchpad::EventFilter& filter, const udptouchpad::ChangeThresholds& thresholds, const udptouchpad::RateLimit& limit, const std::unordered_map<uint32_t, udptouchpad::RateLimit>& deviceLimits, const std::function<void(std::span<const udptouchpad::DeviceConnectionEvent>)>& fDeviceConnectionBatch, const std::function<void(std::span<const udptouchpad::CompactTouchpadPointerEvent>)>& fCompactTouchpadPointerBatch, const std::function<void(std::span<const udptouchpad::MotionSensorEvent>)>& fMotionSensorBatch): report(nullptr), pressedMask(0), callbackDeviceConnectionBatch(fDeviceConnectionBatch), callbackCompactTouchpadPointerBatch(fCompactTouchpadPointerBatch), callbackMotionSensorBatch(fMotionSensorBatch){
+            database = std::make_unique<udptouchpad::detail::DeviceDatabase>();
+            database->SetFilter(filter);
+            database->SetChangeThresholds(thresholds);
+            database->SetRateLimit(limit);
+            for(auto&& [deviceID, deviceLimit] : deviceLimits){
+                database->SetDeviceRateLimit(deviceID, deviceLimit);
+            }
+            batchDeviceConnection.reserve(UDP_TOUCHPAD_PENDING_EVENTS_RESERVE);
+            batchCompactTouchpadPointer.reserve(UDP_TOUCHPAD_PENDING_EVENTS_RESERVE);
+            batchMotionSensor.reserve(UDP_TOUCHPAD_PENDING_EVENTS_RESERVE);
+            onDeviceConnection = [this](udptouchpad::DeviceConnectionEvent e){ OnDeviceConnection(e); };
+            onTouchpadPointer = [this](const udptouchpad::CompactTouchpadPointerEvent& e){ OnTouchpadPointer(e); };
+            onMotionSensor = [this](udptouchpad::MotionSensorEvent e){ OnMotionSensor(e); };
+        }
+
+        /**
+         * @brief Replay all recorded messages of one device.
+         * @param[inout] device The recorded messages of the device. The records are sorted by their timestamp if necessary.
+         * @param[out] deviceReport The report to be generated.
+         * @details Connection timeouts and rate limits are evaluated with the recorded timestamps. A device that is still
+         * connected at the end of its recording is disconnected after the disconnect timeout.
+         */
+        void Replay(udptouchpad::detail::RecordedDeviceMessages& device, udptouchpad::RecordedDeviceReport& deviceReport){
+            database->Clear();
+            deviceReport = udptouchpad::RecordedDeviceReport();
+            deviceReport.deviceID = device.deviceID;
+            report = &deviceReport;
+            pressedMask = 0;
+            if(!device.sorted){
+                std::stable_sort(device.records.begin(), device.records.end(), [](const udptouchpad::detail::RecordedMessage* a, const udptouchpad::detail::RecordedMessage* b){ return a->timestamp < b->timestamp; });
+            }
+
+            // replay all messages, a gap of more than the disconnect timeout disconnects the device before the next message is pushed
+            const auto timeout = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(UDP_TOUCHPAD_DEVICE_DISCONNECT_TIMEOUT_S)) + std::chrono::steady_clock::duration(1);
+            std::chrono::time_point<std::chrono::steady_clock> timestampPrevious, timestampAccepted;
+            bool connected = false;
+            uint8_t counter = 0;
+            uint64_t numIntervals = 0;
+            double sumIntervals = 0.0, sumSquaredIntervals = 0.0;
+            for(auto&& p : device.records){
+                std::memcpy(static_cast<void*>(&record), static_cast<const void*>(p), sizeof(record));
+                auto timestamp = std::chrono::time_point<std::chrono::steady_clock>(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(record.timestamp)));
+                if(0x42 != record.message.data.header){
+                    deviceReport.numInvalidMessages++;
+                    continue;
+                }
+                if(!deviceReport.numMessages){
+                    deviceReport.firstTimestamp = timestamp;
+                }
+                else if((timestamp - timestampPrevious) < timeout){
+                    double interval = std::chrono::duration<double>(timestamp - timestampPrevious).count();
+                    numIntervals++;
+                    sumIntervals += interval;
+                    sumSquaredIntervals += interval * interval;
+                    deviceReport.maxMessageInterval = std::max(deviceReport.maxMessageInterval, interval);
+                }
+                deviceReport.numMessages++;
+                deviceReport.lastTimestamp = timestamp;
+                deviceReport.endpoint = record.endpoint;
+                timestampPrevious = timestamp;
+                if(connected && ((timestamp - timestampAccepted) >= timeout)){
+                    database->FetchEvents(onDeviceConnection, onTouchpadPointer, onMotionSensor, timestampAccepted + timeout);
+                    connected = false;
+                }
+
+                // same counter check as the device database: lost messages are counted from gaps, old messages are discarded
+                uint8_t difference = static_cast<uint8_t>(record.message.data.counter - counter);
+                if(connected && ((0 == difference) || (difference >= 128))){
+                    deviceReport.numOutOfOrderMessages++;
+                    continue;
+                }
+                if(connected){
+                    deviceReport.numLostMessages += static_cast<uint64_t>(difference - 1);
+                }
+                connected = true;
+                counter = record.message.data.counter;
+                timestampAccepted = timestamp;
+                udptouchpad::detail::NetworkToNativeByteOrder(record.message);
+                database->PushNewMessage(device.deviceID, record.endpoint, record.message.data, timestamp);
+                database->FetchEvents(onDeviceConnection, onTouchpadPointer, onMotionSensor, timestamp);
+            }
+            if(connected){
+                database->FetchEvents(onDeviceConnection, onTouchpadPointer, onMotionSensor, timestampAccepted + timeout);
+            }
+
+            // finish the report and deliver the remaining events
+            if(numIntervals){
+                double n = static_cast<double>(numIntervals);
+                deviceReport.meanMessageInterval = sumIntervals / n;
+                deviceReport.stdMessageInterval = std::sqrt(std::max(0.0, sumSquaredIntervals / n - deviceReport.meanMessageInterval * deviceReport.meanMessageInterval));
+            }
+            deviceReport.statistics = database->GetStatistics();
+            udptouchpad::detail::DeliverBatch(callbackDeviceConnectionBatch, batchDeviceConnection);
+            udptouchpad::detail::DeliverBatch(callbackCompactTouchpadPointerBatch, batchCompactTouchpadPointer);
+            udptouchpad::detail::DeliverBatch(callbackMotionSensorBatch, batchMotionSensor);
+            report = nullptr;
+        }
+
+    private:
+        std::unique_ptr<udptouchpad::detail::DeviceDatabase> database;                                                        // Device database through which the messages are replayed.
+        udptouchpad::detail::RecordedMessage record;                                                                          // Scratch record, aligned copy of the mapped record.
+        udptouchpad::RecordedDeviceReport* report;                                                                            // The report of the device that is currently replayed.
+        uint16_t pressedMask;                                                                                                 // Pressed pointers of the latest touchpad pointer event.
+        std::chrono::time_point<std::chrono::steady_clock> timestampPressed;                                                  // Time when the first pointer has been pressed.
+        std::function<void(udptouchpad::DeviceConnectionEvent)> onDeviceConnection;                                          // Handler for device connection events.
+        std::function<void(const udptouchpad::CompactTouchpadPointerEvent&)> onTouchpadPointer;                               // Handler for touchpad pointer events.
+        std::function<void(udptouchpad::MotionSensorEvent)> onMotionSensor;                                                   // Handler for motion sensor events.
+        std::function<void(std::span<const udptouchpad::DeviceConnectionEvent>)> callbackDeviceConnectionBatch;               // Batch callback for device connection events.
+        std::function<void(std::span<const udptouchpad::CompactTouchpadPointerEvent>)> callbackCompactTouchpadPointerBatch;   // Batch callback for compact touchpad pointer events.
+        std::function<void(std::span<const udptouchpad::MotionSensorEvent>)> callbackMotionSensorBatch;                       // Batch callback for motion sensor events.
+        std::vector<udptouchpad::DeviceConnectionEvent> batchDeviceConnection;                                                // Batch of device connection events.
+        std::vector<udptouchpad::CompactTouchpadPointerEvent> batchCompactTouchpadPointer;                                    // Batch of compact touchpad pointer events.
+        std::vector<udptouchpad::MotionSensorEvent> batchMotionSensor;                                                        // Batch of motion sensor events.
+
+        /**
+         * @brief Count a device connection event and end a touch if the device has been disconnected.
+         * @param[in] e The device connection event.
+         */
+        void OnDeviceConnection(const udptouchpad::DeviceConnectionEvent& e){
+            if(e.connected){
+                report->numConnections++;
+            }
+            else{
+                report->numDisconnections++;
+                if(pressedMask){
+                    report->touchDuration += std::chrono::duration<double>(e.timestamp - timestampPressed).count();
+                }
+            }
+            pressedMask = 0;
+            udptouchpad::detail::AppendToBatch(callbackDeviceConnectionBatch, batchDeviceConnection, e);
+        }
+
+        /**
+         * @brief Count a touchpad pointer event, newly pressed pointers and the time during which pointers are pressed.
+         * @param[in] e The touchpad pointer event.
+         */
+        void OnTouchpadPointer(const udptouchpad::CompactTouchpadPointerEvent& e){
+            report->numTouchpadPointerEvents++;
+            report->numTouches += static_cast<uint64_t>(std::popcount(static_cast<uint16_t>(e.pressedMask & ~pressedMask)));
+            if(!pressedMask && e.pressedMask){
+                timestampPressed = e.timestamp;
+            }
+            else if(pressedMask && !e.pressedMask){
+                report->touchDuration += std::chrono::duration<double>(e.timestamp - timestampPressed).count();
+            }
+            pressedMask = e.pressedMask;
+            udptouchpad::detail::AppendToBatch(callbackCompactTouchpadPointerBatch, batchCompactTouchpadPointer, e);
+        }
+
+        /**
+         * @brief Count a motion sensor event.
+         * @param[in] e The motion sensor event.
+         */
+        void OnMotionSensor(const udptouchpad::MotionSensorEvent& e){
+            report->numMotionSensorEvents++;
+            udptouchpad::detail::AppendToBatch(callbackMotionSensorBatch, batchMotionSensor, e);
+        }
+};
+
+
+} /* namespace: detail */
+
+
+/**
+ * @brief Processes recorded touchpad messages offline, e.g. to generate latency, loss and usage reports from many hours of
+ * recorded data. Recording files are mapped into memory and the devices are processed in parallel on several threads, where
+ * each device is replayed through a device database with the same merge logic as in the @ref EventSystem.
+ */
+class RecordingAnalyzer {
+    public:
+        /**
+         * @brief Construct a new recording analyzer that uses one thread per hardware thread.
+         */
+        RecordingAnalyzer(): numThreads(0) {}
+
+        /**
+         * @brief Set the number of threads that process devices in parallel.
+         * @param[in] n The number of threads, zero uses one thread per hardware thread.
+         */
+        void SetNumberOfThreads(const uint32_t n){
+            numThreads = n;
+        }
+
+        /**
+         * @brief Set the filter that selects the devices, event types and screen region to be processed.
+         * @param[in] f The new filter.
+         */
+        void SetEventFilter(const udptouchpad::EventFilter& f){
+            filter = f;
+        }
+
+        /**
+         * @brief Set deadband thresholds for the change detection, see @ref EventSystem::SetChangeThresholds.
+         * @param[in] t The new thresholds.
+         */
+        void SetChangeThresholds(const udptouchpad::ChangeThresholds& t){
+            thresholds = t;
+        }
+
+        /**
+         * @brief Limit the rate of events of all devices that have no device-specific rate limit, see @ref EventSystem::SetRateLimit.
+         * @param[in] limit The new rate limit.
+         * @details Coalesced events are emitted whenever the next message of the same device is replayed.
+         */
+        void SetRateLimit(const udptouchpad::RateLimit& limit){
+            rateLimit = limit;
+        }
+
+        /**
+         * @brief Limit the rate of events of a specific device.
+         * @param[in] deviceID The ID of the device.
+         * @param[in] limit The new rate limit for this device, which overrides the rate limit set by @ref SetRateLimit.
+         */
+        void SetDeviceRateLimit(const uint32_t deviceID, const udptouchpad::RateLimit& limit){
+            deviceRateLimits[deviceID] = limit;
+        }
+
+        /**
+         * @brief Set a batch callback for device connection events.
+         * @param[in] f The batch callback function with prototype void(std::span<const udptouchpad::DeviceConnectionEvent>).
+         * @details Batch callbacks are called concurrently from all threads of @ref Analyze. All events of one batch belong to
+         * the same device and the batches of one device are delivered in order by the same thread.
+         */
+        void SetDeviceConnectionBatchCallback(std::function<void(std::span<const udptouchpad::DeviceConnectionEvent>)> f){
+            callbackDeviceConnectionBatch = f;
+        }
+
+        /**
+         * @brief Set a batch callback for compact touchpad pointer events.
+         * @param[in] f The batch callback function with prototype void(std::span<const udptouchpad::CompactTouchpadPointerEvent>).
+         * @details See @ref SetDeviceConnectionBatchCallback for the threads from which batch callbacks are called.
+         */
+        void SetCompactTouchpadPointerBatchCallback(std::function<void(std::span<const udptouchpad::CompactTouchpadPointerEvent>)> f){
+            callbackCompactTouchpadPointerBatch = f;
+        }
+
+        /**
+         * @brief Set a batch callback for motion sensor events.
+         * @param[in] f The batch callback function with prototype void(std::span<const udptouchpad::MotionSensorEvent>).
+         * @details See @ref SetDeviceConnectionBatchCallback for the threads from which batch callbacks are called.
+         */
+        void SetMotionSensorBatchCallback(std::function<void(std::span<const udptouchpad::MotionSensorEvent>)> f){
+            callbackMotionSensorBatch = f;
+        }
+
+        /**
+         * @brief Process recording files that have been written by a @ref MessageRecorder.
+         * @param[in] filenames The names of the recording files. Each file may contain the messages of one device or of many
+         * devices. The messages of a device that is recorded in several files are merged by their timestamp.
+         * @param[out] reports The reports of all recorded devices, sorted by the device ID.
+         * @return True if success, false if a file could not be read. In this case, no device is processed.
+         * @details If this member function fails, use @ref GetErrorString to obtain error information.
+         */
+        bool Analyze(const std::vector<std::string>& filenames, std::vector<udptouchpad::RecordedDeviceReport>& reports){
+            reports.clear();
+            errorString.clear();
+
+            // map all files and index the records of each device
+            std::vector<std::unique_ptr<udptouchpad::detail::MappedFile>> files;
+            std::vector<udptouchpad::detail::RecordedDeviceMessages> devices;
+            std::unordered_map<uint32_t, size_t> deviceIndices;
+            for(auto&& filename : filenames){
+                files.push_back(std::make_unique<udptouchpad::detail::MappedFile>());
+                const udptouchpad::detail::RecordedMessage* records;
+                size_t numRecords;
+                if(!udptouchpad::detail::OpenRecordingFile(*files.back(), filename, records, numRecords, errorString)){
+                    return false;
+                }
+                for(size_t i = 0; i < numRecords; ++i){
+                    auto [it, inserted] = deviceIndices.try_emplace(records[i].deviceID, devices.size());
+                    if(inserted){
+                        devices.emplace_back(records[i].deviceID);
+                    }
+                    udptouchpad::detail::RecordedDeviceMessages& device = devices[it->second];
+                    device.sorted &= (records[i].timestamp >= device.lastTimestamp);
+                    device.lastTimestamp = records[i].timestamp;
+                    device.records.push_back(&records[i]);
+                }
+            }
+
+            // process the devices with the most records first, so that all threads finish at about the same time
+            std::vector<size_t> order(devices.size());
+            for(size_t i = 0; i < order.size(); ++i){
+                order[i] = i;
+            }
+            std::sort(order.begin(), order.end(), [&devices](size_t a, size_t b){ return devices[a].records.size() > devices[b].records.size(); });
+            reports.resize(devices.size());
+            std::atomic<size_t> next(0);
+            auto work = [&](void){
+                udptouchpad::detail::RecordingReplay replay(filter, thresholds, rateLimit, deviceRateLimits, callbackDeviceConnectionBatch, callbackCompactTouchpadPointerBatch, callbackMotionSensorBatch);
+                for(size_t i = next++; i < order.size(); i = next++){
+                    replay.Replay(devices[order[i]], reports[order[i]]);
+                }
+            };
+            size_t n = numThreads ? static_cast<size_t>(numThreads) : static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency()));
+            n = std::max(static_cast<size_t>(1), std::min(n, devices.size()));
+            std::vector<std::thread> threads;
+            for(size_t i = 1; i < n; ++i){
+                threads.emplace_back(work);
+            }
+            work();
+            for(auto&& t : threads){
+                t.join();
+            }
+            std::sort(reports.begin(), reports.end(), [](const udptouchpad::RecordedDeviceReport& a, const udptouchpad::RecordedDeviceReport& b){ return a.deviceID < b.deviceID; });
+            return true;
+        }
+
+        /**
+         * @brief Get the last error string that has been set by @ref Analyze.
+         * @return String giving information about the last error.
+         */
+        std::string GetErrorString(void){ return errorString; }
+
+    private:
+        uint32_t numThreads;                                                                                                  // Number of threads, zero uses one thread per hardware thread.
+        udptouchpad::EventFilter filter;                                                                                      // Selects the devices, event types and screen region to be processed.
+        udptouchpad::ChangeThresholds thresholds;                                                                             // Deadband thresholds for the change detection.
+        udptouchpad::RateLimit rateLimit;                                                                                     // Rate limit for all devices without a device-specific rate limit.
+        std::unordered_map<uint32_t, udptouchpad::RateLimit> deviceRateLimits;                                                // Device-specific rate limits.
+        std::function<void(std::span<const udptouchpad::DeviceConnectionEvent>)> callbackDeviceConnectionBatch;               // Batch callback for device connection events.
+        std::function<void(std::span<const udptouchpad::CompactTouchpadPointerEvent>)> callbackCompactTouchpadPointerBatch;   // Batch callback for compact touchpad pointer events.
+        std::function<void(std::span<const udptouchpad::MotionSensorEvent>)> callbackMotionSensorBatch;                       // Batch callback for motion sensor events.
+        std::string errorString;                                                                                              // Error string, set if analyzing fails.
+};
+
+
+} /* namespace: udptouchpad */
+
@@ -0,0 +1,140 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/Transport.hpp>
+#include <udptouchpad/detail/MappedFile.hpp>
+#include <udptouchpad/detail/MessageRecording.hpp>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief Replays recording files that have been written by a @ref MessageRecorder as fast as possible. The messages of all
+ * files are merged by their timestamp and passed to the event system as if they had just been received.
+ * @details Timestamps are shifted so that the earliest recorded message is received at the time when the transport is opened,
+ * while the time between messages is kept. Whenever the event system is started, the recording is replayed from the beginning.
+ * Once all messages have been replayed, the event system stops receiving while the received events can still be polled.
+ */
+class ReplayTransport: public udptouchpad::Transport {
+    public:
+        /**
+         * @brief Construct a new replay transport.
+         * @param[in] filenames The names of the recording files to be replayed.
+         */
+        explicit ReplayTransport(const std::vector<std::string>& filenames): filenames(filenames), wakeRequested(false), numReplayed(0), offset(0) {}
+
+        /**
+         * @brief Destroy the replay transport.
+         */
+        ~ReplayTransport(){
+            Close();
+        }
+
+        /**
+         * @brief Map all recording files into memory.
+         * @return True if success, false if a file could not be mapped or is not a recording file.
+         */
+        bool Open(void){
+            wakeRequested = false;
+            files.clear();
+            cursors.clear();
+            int64_t earliest = std::numeric_limits<int64_t>::max();
+            for(auto&& filename : filenames){
+                files.push_back(std::make_unique<udptouchpad::detail::MappedFile>());
+                Cursor cursor;
+                if(!udptouchpad::detail::OpenRecordingFile(*files.back(), filename, cursor.next, cursor.numRemaining, errorString)){
+                    Close();
+                    return false;
+                }
+                if(cursor.numRemaining){
+                    earliest = std::min(earliest, cursor.next->timestamp);
+                    cursors.push_back(cursor);
+                }
+            }
+            offset = cursors.empty() ? 0 : (static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()) - earliest);
+            return true;
+        }
+
+        /**
+         * @brief Unmap all recording files.
+         */
+        void Close(void){
+            cursors.clear();
+            files.clear();
+        }
+
+        /**
+         * @brief Pass all recorded messages to a sink in the order of their timestamps.
+         * @param[in] sink The sink to which all messages are passed.
+         * @return The reason why receiving has returned.
+         */
+        udptouchpad::TransportStatus Receive(udptouchpad::DatagramSink& sink){
+            while(!cursors.empty()){
+                if(wakeRequested){
+                    return udptouchpad::transport_status_stopped;
+                }
+
+                // select the earliest message of all files, the number of files is expected to be small
+                size_t k = 0;
+                for(size_t i = 1; i < cursors.size(); ++i){
+                    if(cursors[i].next->timestamp < cursors[k].next->timestamp){
+                        k = i;
+                    }
+                }
+
+                // the sink may modify the bytes, but the mapped file is read-only
+                const udptouchpad::detail::RecordedMessage& record = *cursors[k].next;
+                std::memcpy(&message.bytes[0], &record.message.bytes[0], sizeof(message));
+                sink.ProcessDatagram(record.deviceID, record.endpoint, &message.bytes[0], static_cast<int32_t>(sizeof(message)), std::chrono::time_point<std::chrono::steady_clock>(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(record.timestamp + offset))));
+                numReplayed++;
+                cursors[k].next++;
+                if(!--cursors[k].numRemaining){
+                    cursors.erase(cursors.begin() + k);
+                }
+            }
+            return udptouchpad::transport_status_finished;
+        }
+
+        /**
+         * @brief Make @ref Receive return as soon as possible. This member function can be called from any thread.
+         */
+        void WakeUp(void){
+            wakeRequested = true;
+        }
+
+        /**
+         * @brief Get the last error string that has been set by @ref Open.
+         * @return String giving information about the last error.
+         */
+        std::string GetErrorString(void){ return errorString; }
+
+        /**
+         * @brief Get the number of messages that have been replayed since this transport has been constructed.
+         * @return Number of replayed messages.
+         */
+        uint64_t GetNumberOfReplayedMessages(void){ return numReplayed; }
+
+    private:
+        /**
+         * @brief The position of the next message to be replayed from a recording file.
+         */
+        struct Cursor {
+            const udptouchpad::detail::RecordedMessage* next;   // The next record to be replayed.
+            size_t numRemaining;                               // Number of records that remain to be replayed.
+        };
+
+        std::vector<std::string> filenames;                                       // The names of the recording files.
+        std::atomic<bool> wakeRequested;                                          // True if @ref WakeUp has been called since the transport has been opened.
+        std::atomic<uint64_t> numReplayed;                                        // Number of messages that have been replayed.
+        std::vector<std::unique_ptr<udptouchpad::detail::MappedFile>> files;      // All mapped recording files.
+        std::vector<Cursor> cursors;                                              // One cursor per file that has messages left.
+        int64_t offset;                                                           // Offset in nanoseconds that is added to all recorded timestamps.
+        udptouchpad::detail::SerializationTouchpadMessageUnion message;           // The message that is currently replayed.
+        std::string errorString;                                                  // Error string, set if opening fails.
+};
+
+
+} /* namespace: udptouchpad */
+
@@ -0,0 +1,77 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Represents a value that is protected by a sequence lock. One writer can update the value while any number of
+ * readers obtain consistent copies without ever blocking the writer.
+ * @tparam T Type of the protected value. Must be trivially copyable.
+ * @details The layout of this class does not contain any pointers, so it can also be placed in shared memory.
+ */
+template <class T> class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "Type of SeqLock must be trivially copyable!");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "SeqLock requires lock-free 32-bit atomics!");
+
+    public:
+        /**
+         * @brief Construct a new sequence lock with a default-constructed value.
+         */
+        SeqLock(): sequence(0), value(){}
+
+        /**
+         * @brief Store a new value.
+         * @param[in] v The value to be stored.
+         * @details Only one thread may call this member function at a time. Readers are never blocked.
+         */
+        void Store(const T& v){
+            uint32_t s = sequence.load(std::memory_order_relaxed);
+            sequence.store(s + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(static_cast<void*>(&value), static_cast<const void*>(&v), sizeof(T));
+            sequence.store(s + 2, std::memory_order_release);
+        }
+
+        /**
+         * @brief Try to load a consistent copy of the value.
+         * @param[out] v The copy of the value. Its content is undefined if this call fails.
+         * @return True if success, false if the writer modified the value during the copy.
+         */
+        bool TryLoad(T& v) const {
+            uint32_t s0 = sequence.load(std::memory_order_acquire);
+            if(s0 & 1){
+                return false;
+            }
+            std::memcpy(static_cast<void*>(&v), static_cast<const void*>(&value), sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return s0 == sequence.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Load a consistent copy of the value. Retries until the copy is not torn by a concurrent write.
+         * @param[out] v The copy of the value.
+         */
+        void Load(T& v) const {
+            while(!TryLoad(v)){
+                std::this_thread::yield();
+            }
+        }
+
+    private:
+        std::atomic<uint32_t> sequence;   // Sequence number, which is odd while the writer is modifying the value.
+        T value;                          // The protected value.
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
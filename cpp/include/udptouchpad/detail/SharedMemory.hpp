@@ -0,0 +1,186 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Represents a named shared memory segment that is mapped into the address space of this process.
+ */
+class SharedMemory: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Construct a new shared memory object.
+         */
+        SharedMemory(): address(nullptr), size(0) {
+            #ifdef _WIN32
+            handle = NULL;
+            #endif
+        }
+
+        /**
+         * @brief Destroy the shared memory object and unmap the segment.
+         */
+        ~SharedMemory(){
+            Close();
+        }
+
+        /**
+         * @brief Create a named shared memory segment or open an existing one with read and write access.
+         * @param[in] name The name of the shared memory segment.
+         * @param[in] numBytes Size of the shared memory segment in bytes.
+         * @return True if success, false otherwise.
+         * @details If this member function fails, use @ref GetErrorString to obtain error information.
+         */
+        bool Create(const std::string& name, size_t numBytes){
+            return Map(name, numBytes, true);
+        }
+
+        /**
+         * @brief Open an existing named shared memory segment with read-only access.
+         * @param[in] name The name of the shared memory segment.
+         * @param[in] numBytes Size of the shared memory segment in bytes.
+         * @return True if success, false otherwise.
+         * @details If this member function fails, use @ref GetErrorString to obtain error information.
+         */
+        bool OpenReadOnly(const std::string& name, size_t numBytes){
+            return Map(name, numBytes, false);
+        }
+
+        /**
+         * @brief Unmap the shared memory segment. The segment itself is not removed, so that readers can still access it.
+         */
+        void Close(void){
+            if(address){
+                #ifdef _WIN32
+                (void) UnmapViewOfFile(address);
+                #elif __linux__
+                (void) munmap(address, size);
+                #else
+                #error "Platform is not supported!"
+                #endif
+            }
+            #ifdef _WIN32
+            if(handle){
+                (void) CloseHandle(handle);
+                handle = NULL;
+            }
+            #endif
+            address = nullptr;
+            size = 0;
+        }
+
+        /**
+         * @brief Get the address of the mapped shared memory segment.
+         * @return Address of the segment or nullptr if no segment is mapped.
+         */
+        void* GetAddress(void){ return address; }
+
+        /**
+         * @brief Get the last error string that has been set by @ref Create or @ref OpenReadOnly.
+         * @return String giving information about the last error.
+         */
+        std::string GetErrorString(void){ return errorString; }
+
+    private:
+        void* address;             // Address of the mapped segment.
+        size_t size;               // Size of the mapped segment in bytes.
+        std::string errorString;   // OS-specific error string, set if mapping fails.
+        #ifdef _WIN32
+        HANDLE handle;             // Handle of the file mapping object.
+        #endif
+
+        /**
+         * @brief Open and map a named shared memory segment.
+         * @param[in] name The name of the shared memory segment.
+         * @param[in] numBytes Size of the shared memory segment in bytes.
+         * @param[in] writable True if the segment should be created (if necessary) and mapped with write access, false for read-only access.
+         * @return True if success, false otherwise.
+         */
+        bool Map(const std::string& name, size_t numBytes, bool writable){
+            Close();
+            errorString.clear();
+
+            #ifdef _WIN32
+            if(writable){
+                handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, static_cast<DWORD>(static_cast<uint64_t>(numBytes) >> 32), static_cast<DWORD>(numBytes & 0xFFFFFFFF), name.c_str());
+            }
+            else{
+                handle = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+            }
+            if(!handle){
+                errorString = GenerateErrorString("Failed to open shared memory \"" + name + "\"!");
+                return false;
+            }
+            address = MapViewOfFile(handle, writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, numBytes);
+            if(!address){
+                errorString = GenerateErrorString("Failed to map shared memory \"" + name + "\"!");
+                Close();
+                return false;
+            }
+            #elif __linux__
+            std::string shmName = (!name.empty() && ('/' == name.front())) ? name : ("/" + name);
+            errno = 0;
+            int fd = shm_open(shmName.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0666);
+            if(fd < 0){
+                errorString = GenerateErrorString("Failed to open shared memory \"" + name + "\"!");
+                return false;
+            }
+            struct stat info;
+            if(writable && (ftruncate(fd, static_cast<off_t>(numBytes)) < 0)){
+                errorString = GenerateErrorString("Failed to resize shared memory \"" + name + "\"!");
+                (void) close(fd);
+                return false;
+            }
+            if(!writable && ((fstat(fd, &info) < 0) || (static_cast<size_t>(info.st_size) < numBytes))){
+                errorString = "Shared memory \"" + name + "\" is too small!";
+                (void) close(fd);
+                return false;
+            }
+            void* p = mmap(nullptr, numBytes, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+            (void) close(fd);
+            if(MAP_FAILED == p){
+                errorString = GenerateErrorString("Failed to map shared memory \"" + name + "\"!");
+                return false;
+            }
+            address = p;
+            #else
+            #error "Platform is not supported!"
+            #endif
+
+            size = numBytes;
+            return true;
+        }
+
+        /**
+         * @brief Get the last error value.
+         * @return String representing the last error code.
+         */
+        std::string GenerateErrorString(std::string prestring){
+            #ifdef _WIN32
+            int err = static_cast<int>(GetLastError());
+            std::string errStr("");
+            #elif __linux__
+            int err = static_cast<int>(errno);
+            std::string errStr = std::string(strerror(err)) + std::string(" ");
+            #else
+            #error "Platform is not supported!"
+            #endif
+
+            return prestring + std::string(" ") + errStr + std::string("(") + std::to_string(err) + std::string(")");
+        }
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
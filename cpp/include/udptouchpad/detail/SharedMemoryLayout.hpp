@@ -0,0 +1,81 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/Events.hpp>
+#include <udptouchpad/detail/DeviceState.hpp>
+#include <udptouchpad/detail/DeviceStateTable.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Magic number that identifies a shared memory segment of the UDP touchpad library.
+ */
+constexpr uint32_t sharedMemoryMagic = 0x55545043;
+
+
+/**
+ * @brief Version of the shared memory layout. Must be incremented whenever the layout changes.
+ */
+constexpr uint32_t sharedMemoryLayoutVersion = 3;
+
+
+/**
+ * @brief Header of the shared memory segment.
+ */
+struct SharedMemoryHeader {
+    std::atomic<uint32_t> magic;        // Set to @ref sharedMemoryMagic after the segment has been initialized by the publisher.
+    uint32_t layoutVersion;             // Set to @ref sharedMemoryLayoutVersion.
+    uint32_t segmentSize;               // Size of the whole segment in bytes.
+    uint32_t maxDevices;                // Number of device slots.
+    uint32_t eventCapacity;             // Number of event slots.
+    std::atomic<uint32_t> generation;   // Incremented each time a publisher (re-)initializes the segment.
+};
+
+
+/**
+ * @brief One event in the event ring of the shared memory.
+ */
+struct SharedEventRecord {
+    udptouchpad::detail::EventType type;   // The type of the event, either connection, touchpad pointer or motion sensor.
+    bool connected;                        // Connection state for connection events.
+    udptouchpad::DeviceState state;        // Device state from which touchpad pointer and motion sensor events are built.
+};
+
+
+/**
+ * @brief One slot of the event ring of the shared memory.
+ */
+struct SharedEventSlot {
+    std::atomic<uint64_t> sequence;   // Equal to 2*index+1 while the event with the given index is written and 2*index+2 after it has been written.
+    SharedEventRecord record;         // The event record.
+};
+
+
+/**
+ * @brief The complete layout of the shared memory segment.
+ * @details The segment is written by exactly one publisher. Device slots are written by a @ref DeviceStateTable and the event ring
+ * uses per-slot sequence numbers, so that subscribers read without syscalls and without ever blocking the publisher.
+ */
+struct SharedMemorySegment {
+    SharedMemoryHeader header;                                                                                  // Header of the segment.
+    alignas(64) std::atomic<uint64_t> eventWriteIndex;                                                          // Total number of events written to the event ring.
+    alignas(64) udptouchpad::detail::DeviceStateTable<UDP_TOUCHPAD_SHARED_MEMORY_MAX_DEVICES>::Slots devices;   // Device slots.
+    alignas(64) std::array<SharedEventSlot, UDP_TOUCHPAD_SHARED_MEMORY_EVENT_CAPACITY> events;                  // Event ring.
+};
+
+
+static_assert(std::is_trivially_copyable_v<SharedEventRecord>, "SharedEventRecord must be trivially copyable!");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory requires lock-free 64-bit atomics!");
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
@@ -0,0 +1,191 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+#include <udptouchpad/detail/Events.hpp>
+#include <udptouchpad/detail/DeviceState.hpp>
+#include <udptouchpad/detail/SharedMemory.hpp>
+#include <udptouchpad/detail/SharedMemoryLayout.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Publishes the latest device states and all events to a shared memory segment, which can be read by any number of
+ * @ref udptouchpad::SharedMemorySubscriber objects in other processes.
+ * @details There must be exactly one publisher per shared memory segment. The device table and the event ring are written
+ * independently: @ref PublishDeviceState, @ref RemoveDevice and @ref RemoveAllDevices may run concurrently with @ref PublishEvent,
+ * but not with each other, and calls to @ref PublishEvent must not run concurrently with each other. @ref Open and @ref Close
+ * must not run concurrently with any other member function.
+ */
+class SharedMemoryPublisher: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Construct a new shared memory publisher.
+         */
+        SharedMemoryPublisher(): segment(nullptr) {}
+
+        /**
+         * @brief Create or open the shared memory segment and initialize its content.
+         * @param[in] name The name of the shared memory segment.
+         * @return True if success, false otherwise.
+         * @details If this member function fails, use @ref GetErrorString to obtain error information.
+         */
+        bool Open(const std::string& name){
+            Close();
+            if(!sharedMemory.Create(name, sizeof(udptouchpad::detail::SharedMemorySegment))){
+                errorString = sharedMemory.GetErrorString();
+                return false;
+            }
+            segment = reinterpret_cast<udptouchpad::detail::SharedMemorySegment*>(sharedMemory.GetAddress());
+
+            // continue the generation of a previous publisher, so that subscribers notice the re-initialization
+            uint32_t generation = 0;
+            if(SegmentIsCompatible()){
+                generation = segment->header.generation.load(std::memory_order_relaxed) + 1;
+            }
+            segment->header.magic.store(0, std::memory_order_release);
+            new (segment) udptouchpad::detail::SharedMemorySegment();
+            segment->header.layoutVersion = udptouchpad::detail::sharedMemoryLayoutVersion;
+            segment->header.segmentSize = static_cast<uint32_t>(sizeof(udptouchpad::detail::SharedMemorySegment));
+            segment->header.maxDevices = UDP_TOUCHPAD_SHARED_MEMORY_MAX_DEVICES;
+            segment->header.eventCapacity = UDP_TOUCHPAD_SHARED_MEMORY_EVENT_CAPACITY;
+            segment->header.generation.store(generation, std::memory_order_relaxed);
+            segment->eventWriteIndex.store(0, std::memory_order_relaxed);
+            segment->header.magic.store(udptouchpad::detail::sharedMemoryMagic, std::memory_order_release);
+            deviceStates.Attach(&segment->devices);
+            errorString.clear();
+            return true;
+        }
+
+        /**
+         * @brief Remove all devices from the shared memory and unmap the segment.
+         */
+        void Close(void){
+            if(segment){
+                deviceStates.RemoveAll();
+            }
+            deviceStates.Attach(nullptr);
+            sharedMemory.Close();
+            segment = nullptr;
+        }
+
+        /**
+         * @brief Get the last error string that has been set by @ref Open.
+         * @return String giving information about the last error.
+         */
+        std::string GetErrorString(void){ return errorString; }
+
+        /**
+         * @brief Publish the latest state of a device.
+         * @param[in] state The device state to be published. If no slot is available, the slot of the device with the oldest state is reused.
+         */
+        void PublishDeviceState(const udptouchpad::DeviceState& state){
+            deviceStates.Store(state);
+        }
+
+        /**
+         * @brief Remove a device from the shared memory.
+         * @param[in] deviceID The ID of the device to be removed.
+         * @param[in] endpoint Index of the endpoint on which the messages of the device are received.
+         */
+        void RemoveDevice(const uint32_t deviceID, const uint16_t endpoint){
+            deviceStates.Remove(deviceID, endpoint);
+        }
+
+        /**
+         * @brief Remove all devices from the shared memory.
+         */
+        void RemoveAllDevices(void){
+            deviceStates.RemoveAll();
+        }
+
+        /**
+         * @brief Publish a device connection event.
+         * @param[in] e The event to be published.
+         */
+        void PublishEvent(const udptouchpad::DeviceConnectionEvent& e){
+            eventRecord.type = udptouchpad::detail::event_type_connection;
+            eventRecord.connected = e.connected;
+            eventRecord.state = udptouchpad::DeviceState();
+            eventRecord.state.deviceID = e.deviceID;
+            eventRecord.state.endpoint = e.endpoint;
+            eventRecord.state.timestampReceive = e.timestamp;
+            WriteEventRecord();
+        }
+
+        /**
+         * @brief Publish a touchpad pointer event.
+         * @param[in] e The event to be published.
+         */
+        void PublishEvent(const udptouchpad::TouchpadPointerEvent& e){
+            eventRecord.type = udptouchpad::detail::event_type_touchpad_pointer;
+            eventRecord.connected = true;
+            eventRecord.state = udptouchpad::DeviceState();
+            eventRecord.state.deviceID = e.deviceID;
+            eventRecord.state.endpoint = e.endpoint;
+            eventRecord.state.timestampReceive = e.timestamp;
+            eventRecord.state.aspectRatio = e.aspectRatio;
+            eventRecord.state.pointer = e.pointer;
+            WriteEventRecord();
+        }
+
+        /**
+         * @brief Publish a motion sensor event.
+         * @param[in] e The event to be published.
+         */
+        void PublishEvent(const udptouchpad::MotionSensorEvent& e){
+            eventRecord.type = udptouchpad::detail::event_type_motion_sensor;
+            eventRecord.connected = true;
+            eventRecord.state = udptouchpad::DeviceState();
+            eventRecord.state.deviceID = e.deviceID;
+            eventRecord.state.endpoint = e.endpoint;
+            eventRecord.state.timestampReceive = e.timestamp;
+            eventRecord.state.rotationVector = e.rotationVector;
+            eventRecord.state.acceleration = e.acceleration;
+            eventRecord.state.angularRate = e.angularRate;
+            WriteEventRecord();
+        }
+
+    private:
+        udptouchpad::detail::SharedMemory sharedMemory;                                               // The shared memory object.
+        udptouchpad::detail::SharedMemorySegment* segment;                                            // Pointer to the mapped segment or nullptr if not open.
+        udptouchpad::detail::DeviceStateTable<UDP_TOUCHPAD_SHARED_MEMORY_MAX_DEVICES> deviceStates;   // Writes the device slots of the segment.
+        udptouchpad::detail::SharedEventRecord eventRecord;                                           // Scratch record used to write event slots.
+        std::string errorString;                                                                      // Error string, set if @ref Open fails.
+
+        /**
+         * @brief Check whether the mapped segment has already been initialized with a compatible layout.
+         * @return True if compatible, false otherwise.
+         */
+        bool SegmentIsCompatible(void){
+            return (udptouchpad::detail::sharedMemoryMagic == segment->header.magic.load(std::memory_order_acquire)) &&
+                   (udptouchpad::detail::sharedMemoryLayoutVersion == segment->header.layoutVersion) &&
+                   (sizeof(udptouchpad::detail::SharedMemorySegment) == segment->header.segmentSize);
+        }
+
+        /**
+         * @brief Write the @ref eventRecord to the next slot of the event ring.
+         */
+        void WriteEventRecord(void){
+            uint64_t index = segment->eventWriteIndex.load(std::memory_order_relaxed);
+            udptouchpad::detail::SharedEventSlot& slot = segment->events[index % UDP_TOUCHPAD_SHARED_MEMORY_EVENT_CAPACITY];
+            slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(static_cast<void*>(&slot.record), static_cast<const void*>(&eventRecord), sizeof(eventRecord));
+            slot.sequence.store(2 * index + 2, std::memory_order_release);
+            segment->eventWriteIndex.store(index + 1, std::memory_order_release);
+        }
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
@@ -0,0 +1,223 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+#include <udptouchpad/detail/Events.hpp>
+#include <udptouchpad/detail/DeviceState.hpp>
+#include <udptouchpad/detail/SharedMemory.hpp>
+#include <udptouchpad/detail/SharedMemoryLayout.hpp>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief Reads device states and events from a shared memory segment that is written by an @ref EventSystem in another
+ * process (see @ref EventSystem::EnableSharedMemoryPublisher). Apart from opening the segment, no syscalls are made.
+ */
+class SharedMemorySubscriber: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Construct a new shared memory subscriber.
+         */
+        SharedMemorySubscriber(): segment(nullptr), generation(0), readIndex(0) {}
+
+        /**
+         * @brief Open the shared memory segment of a publisher with read-only access.
+         * @param[in] name The name of the shared memory segment.
+         * @return True if success, false otherwise.
+         * @details If this member function fails, use @ref GetErrorString to obtain error information. Only events that are
+         * published after this call are polled.
+         */
+        bool Open(const std::string& name){
+            Close();
+            if(!sharedMemory.OpenReadOnly(name, sizeof(udptouchpad::detail::SharedMemorySegment))){
+                errorString = sharedMemory.GetErrorString();
+                return false;
+            }
+            segment = reinterpret_cast<const udptouchpad::detail::SharedMemorySegment*>(sharedMemory.GetAddress());
+            if((udptouchpad::detail::sharedMemoryMagic != segment->header.magic.load(std::memory_order_acquire)) ||
+               (udptouchpad::detail::sharedMemoryLayoutVersion != segment->header.layoutVersion) ||
+               (sizeof(udptouchpad::detail::SharedMemorySegment) != segment->header.segmentSize)){
+                errorString = "Shared memory \"" + name + "\" has not been initialized by a compatible publisher!";
+                Close();
+                return false;
+            }
+            generation = segment->header.generation.load(std::memory_order_acquire);
+            readIndex = segment->eventWriteIndex.load(std::memory_order_acquire);
+            errorString.clear();
+            return true;
+        }
+
+        /**
+         * @brief Unmap the shared memory segment.
+         */
+        void Close(void){
+            sharedMemory.Close();
+            segment = nullptr;
+        }
+
+        /**
+         * @brief Check whether the subscriber is open or not.
+         * @return True if open, false otherwise.
+         */
+        bool IsOpen(void){ return nullptr != segment; }
+
+        /**
+         * @brief Get the last error string that has been set by @ref Open.
+         * @return String giving information about the last error.
+         */
+        std::string GetErrorString(void){ return errorString; }
+
+        /**
+         * @brief Get the latest state of a connected device.
+         * @param[in] deviceID The ID of the device.
+         * @param[out] state The latest state of the device. If the device sends on several endpoints, this is the state of any of them.
+         * @return True if the device is connected, false otherwise.
+         */
+        bool GetDeviceState(const uint32_t deviceID, udptouchpad::DeviceState& state){
+            return segment && udptouchpad::detail::DeviceStateTable<UDP_TOUCHPAD_SHARED_MEMORY_MAX_DEVICES>::Load(segment->devices, deviceID, state);
+        }
+
+        /**
+         * @brief Get the latest state of a connected device on a specific endpoint.
+         * @param[in] deviceID The ID of the device.
+         * @param[in] endpoint Index of the endpoint on which the messages of the device are received.
+         * @param[out] state The latest state of the device.
+         * @return True if the device is connected on the endpoint, false otherwise.
+         */
+        bool GetDeviceState(const uint32_t deviceID, const uint16_t endpoint, udptouchpad::DeviceState& state){
+            return segment && udptouchpad::detail::DeviceStateTable<UDP_TOUCHPAD_SHARED_MEMORY_MAX_DEVICES>::Load(segment->devices, deviceID, endpoint, state);
+        }
+
+        /**
+         * @brief Get the latest states of all connected devices.
+         * @param[out] states Container where to store the device states. The container is cleared first, its capacity is reused.
+         */
+        void GetAllDeviceStates(std::vector<udptouchpad::DeviceState>& states){
+            states.clear();
+            if(segment){
+                udptouchpad::detail::DeviceStateTable<UDP_TOUCHPAD_SHARED_MEMORY_MAX_DEVICES>::LoadAll(segment->devices, states);
+            }
+        }
+
+        /**
+         * @brief Set callback function for error events, e.g. if events have been lost because the subscriber did not poll fast enough.
+         * @param[in] f The callback function with prototype void(udptouchpad::ErrorEvent).
+         */
+        void SetErrorCallback(std::function<void(udptouchpad::ErrorEvent)> f){
+            callbackError = f;
+        }
+
+        /**
+         * @brief Set callback function for device connection events.
+         * @param[in] f The callback function with prototype void(udptouchpad::DeviceConnectionEvent).
+         */
+        void SetDeviceConnectionCallback(std::function<void(udptouchpad::DeviceConnectionEvent)> f){
+            callbackDeviceConnection = f;
+        }
+
+        /**
+         * @brief Set callback function for touchpad pointer events.
+         * @param[in] f The callback function with prototype void(udptouchpad::TouchpadPointerEvent).
+         */
+        void SetTouchpadPointerCallback(std::function<void(udptouchpad::TouchpadPointerEvent)> f){
+            callbackTouchpadPointer = f;
+        }
+
+        /**
+         * @brief Set callback function for motion sensor events.
+         * @param[in] f The callback function with prototype void(udptouchpad::MotionSensorEvent).
+         */
+        void SetMotionSensorCallback(std::function<void(udptouchpad::MotionSensorEvent)> f){
+            callbackMotionSensor = f;
+        }
+
+        /**
+         * @brief Poll all events that have been published since the last poll and run user-defined callback functions.
+         */
+        void PollEvents(void){
+            if(!segment){
+                return;
+            }
+
+            // resynchronize if the publisher re-initialized the segment
+            uint32_t currentGeneration = segment->header.generation.load(std::memory_order_acquire);
+            if(currentGeneration != generation){
+                generation = currentGeneration;
+                readIndex = segment->eventWriteIndex.load(std::memory_order_acquire);
+                ReportError("Shared memory publisher has been restarted!");
+                return;
+            }
+
+            // skip events that have already been overwritten
+            uint64_t writeIndex = segment->eventWriteIndex.load(std::memory_order_acquire);
+            uint64_t numLost = 0;
+            if((writeIndex - readIndex) > UDP_TOUCHPAD_SHARED_MEMORY_EVENT_CAPACITY){
+                numLost = writeIndex - readIndex - UDP_TOUCHPAD_SHARED_MEMORY_EVENT_CAPACITY;
+                readIndex = writeIndex - UDP_TOUCHPAD_SHARED_MEMORY_EVENT_CAPACITY;
+            }
+
+            // read and fire events
+            for(; readIndex < writeIndex; ++readIndex){
+                const udptouchpad::detail::SharedEventSlot& slot = segment->events[readIndex % UDP_TOUCHPAD_SHARED_MEMORY_EVENT_CAPACITY];
+                uint64_t s0 = slot.sequence.load(std::memory_order_acquire);
+                std::memcpy(static_cast<void*>(&eventRecord), static_cast<const void*>(&slot.record), sizeof(eventRecord));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                uint64_t s1 = slot.sequence.load(std::memory_order_relaxed);
+                if((s0 != (2 * readIndex + 2)) || (s0 != s1)){
+                    numLost++;
+                    continue;
+                }
+                switch(eventRecord.type){
+                    case udptouchpad::detail::event_type_connection:
+                        if(callbackDeviceConnection){
+                            callbackDeviceConnection(udptouchpad::DeviceConnectionEvent(eventRecord.state.deviceID, eventRecord.connected, eventRecord.state.timestampReceive, eventRecord.state.endpoint));
+                        }
+                        break;
+                    case udptouchpad::detail::event_type_touchpad_pointer:
+                        if(callbackTouchpadPointer){
+                            callbackTouchpadPointer(eventRecord.state.ToTouchpadPointerEvent());
+                        }
+                        break;
+                    case udptouchpad::detail::event_type_motion_sensor:
+                        if(callbackMotionSensor){
+                            callbackMotionSensor(eventRecord.state.ToMotionSensorEvent());
+                        }
+                        break;
+                    case udptouchpad::detail::event_type_error:
+                        break;
+                }
+            }
+            if(numLost){
+                ReportError("Shared memory subscriber lost " + std::to_string(numLost) + " events!");
+            }
+        }
+
+    private:
+        udptouchpad::detail::SharedMemory sharedMemory;                                     // The shared memory object.
+        const udptouchpad::detail::SharedMemorySegment* segment;                            // Pointer to the mapped segment or nullptr if not open.
+        uint32_t generation;                                                                // Generation of the publisher at the time of the latest synchronization.
+        uint64_t readIndex;                                                                 // Index of the next event to be read from the event ring.
+        udptouchpad::detail::SharedEventRecord eventRecord;                                 // Scratch record used to read event slots.
+        std::string errorString;                                                            // Error string, set if @ref Open fails.
+        std::function<void(udptouchpad::ErrorEvent)> callbackError;                         // Callback for error messages.
+        std::function<void(udptouchpad::DeviceConnectionEvent)> callbackDeviceConnection;   // Callback for device connection events.
+        std::function<void(udptouchpad::TouchpadPointerEvent)> callbackTouchpadPointer;     // Callback for touchpad pointer events.
+        std::function<void(udptouchpad::MotionSensorEvent)> callbackMotionSensor;           // Callback for motion sensor events.
+
+        /**
+         * @brief Report an error via the error callback.
+         * @param[in] msg The error message.
+         */
+        void ReportError(const std::string& msg){
+            if(callbackError){
+                callbackError(udptouchpad::ErrorEvent(msg));
+            }
+        }
+};
+
+
+} /* namespace: udptouchpad */
+
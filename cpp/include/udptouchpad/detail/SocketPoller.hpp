@@ -0,0 +1,227 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief Waits until one of several descriptors becomes readable, so that one thread can receive from multiple sockets. Each
+ * descriptor is registered with a tag that is reported when the descriptor is readable. Uses epoll on Linux and WSAPoll on
+ * Windows.
+ */
+class SocketPoller: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Construct a new socket poller.
+         */
+        SocketPoller(): epollFD(-1), wakeFD(-1), wakeRequested(false) {
+            #ifdef __linux__
+            wakeFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            #endif
+        }
+
+        /**
+         * @brief Destroy the socket poller.
+         */
+        ~SocketPoller(){
+            Close();
+            #ifdef __linux__
+            if(wakeFD >= 0){
+                (void) close(wakeFD);
+            }
+            #endif
+        }
+
+        /**
+         * @brief Open the poller without any registered descriptors.
+         * @return True if success or already open, false otherwise.
+         */
+        bool Open(void){
+            #ifdef _WIN32
+            descriptors.clear();
+            tags.clear();
+            return true;
+            #elif __linux__
+            if(epollFD >= 0){
+                return true;
+            }
+            epollFD = epoll_create1(EPOLL_CLOEXEC);
+            if(epollFD < 0){
+                errorString = GenerateErrorString("Failed to create epoll instance!");
+                return false;
+            }
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u32 = wakeTag;
+            if((wakeFD >= 0) && (epoll_ctl(epollFD, EPOLL_CTL_ADD, wakeFD, &ev) < 0)){
+                errorString = GenerateErrorString("Failed to add wake-up event to epoll instance!");
+                Close();
+                return false;
+            }
+            return true;
+            #else
+            #error "Platform is not supported!"
+            #endif
+        }
+
+        /**
+         * @brief Close the poller. Registered descriptors are not closed.
+         */
+        void Close(void){
+            #ifdef _WIN32
+            descriptors.clear();
+            tags.clear();
+            #elif __linux__
+            if(epollFD >= 0){
+                (void) close(epollFD);
+            }
+            epollFD = -1;
+            #else
+            #error "Platform is not supported!"
+            #endif
+        }
+
+        /**
+         * @brief Register a descriptor.
+         * @param[in] descriptor The descriptor to be watched for readability.
+         * @param[in] tag The tag to be reported by @ref Wait if the descriptor is readable.
+         * @return True if success, false otherwise.
+         */
+        bool Add(int32_t descriptor, uint32_t tag){
+            #ifdef _WIN32
+            WSAPOLLFD fd{};
+            fd.fd = static_cast<SOCKET>(descriptor);
+            fd.events = POLLRDNORM;
+            descriptors.push_back(fd);
+            tags.push_back(tag);
+            return true;
+            #elif __linux__
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u32 = tag;
+            if(epoll_ctl(epollFD, EPOLL_CTL_ADD, descriptor, &ev) < 0){
+                errorString = GenerateErrorString("Failed to add socket to epoll instance!");
+                return false;
+            }
+            return true;
+            #else
+            #error "Platform is not supported!"
+            #endif
+        }
+
+        /**
+         * @brief Wait until at least one registered descriptor is readable or until @ref WakeUp is called.
+         * @param[out] readyTags The tags of all readable descriptors. The container is cleared first, its capacity is reused.
+         * @return The number of readable descriptors, zero if woken up or a negative value if waiting failed.
+         */
+        int32_t Wait(std::vector<uint32_t>& readyTags){
+            readyTags.clear();
+            #ifdef _WIN32
+            // WSAPoll cannot be interrupted, so the wake-up flag is checked periodically
+            while(!wakeRequested.exchange(false)){
+                int n = WSAPoll(descriptors.data(), static_cast<ULONG>(descriptors.size()), 100);
+                if(n < 0){
+                    errorString = GenerateErrorString("Failed to wait for sockets!");
+                    return -1;
+                }
+                for(size_t i = 0; (n > 0) && (i < descriptors.size()); ++i){
+                    if(descriptors[i].revents){
+                        readyTags.push_back(tags[i]);
+                    }
+                }
+                if(!readyTags.empty()){
+                    return static_cast<int32_t>(readyTags.size());
+                }
+            }
+            return 0;
+            #elif __linux__
+            std::array<epoll_event, 64> events;
+            int n;
+            while(((n = epoll_wait(epollFD, events.data(), static_cast<int>(events.size()), -1)) < 0) && (EINTR == errno)){}
+            if(n < 0){
+                errorString = GenerateErrorString("Failed to wait for sockets!");
+                return -1;
+            }
+            for(int i = 0; i < n; ++i){
+                if(wakeTag == events[i].data.u32){
+                    uint64_t value;
+                    (void) !read(wakeFD, &value, sizeof(value));
+                    readyTags.clear();
+                    return 0;
+                }
+                readyTags.push_back(events[i].data.u32);
+            }
+            return static_cast<int32_t>(readyTags.size());
+            #else
+            #error "Platform is not supported!"
+            #endif
+        }
+
+        /**
+         * @brief Wake up a thread that is blocked in @ref Wait. This member function can be called from any thread.
+         */
+        void WakeUp(void){
+            #ifdef _WIN32
+            wakeRequested = true;
+            #elif __linux__
+            if(wakeFD >= 0){
+                uint64_t value = 1;
+                (void) !write(wakeFD, &value, sizeof(value));
+            }
+            #else
+            #error "Platform is not supported!"
+            #endif
+        }
+
+        /**
+         * @brief Get the last error string.
+         * @return String giving information about the last error.
+         */
+        std::string GetErrorString(void){ return errorString; }
+
+    private:
+        static constexpr uint32_t wakeTag = 0xFFFFFFFF;   // Tag of the wake-up event, must not be used for registered descriptors.
+        int epollFD;                                      // The epoll instance (Linux only).
+        int wakeFD;                                       // Event file descriptor to wake up a blocked @ref Wait (Linux only).
+        std::atomic<bool> wakeRequested;                  // True if @ref WakeUp has been called (Windows only).
+        std::string errorString;                          // Error string, set if an operation fails.
+        #ifdef _WIN32
+        std::vector<WSAPOLLFD> descriptors;               // All registered sockets.
+        std::vector<uint32_t> tags;                       // Tags of all registered sockets.
+        #endif
+
+        /**
+         * @brief Generate an error string from the last OS-specific error.
+         * @param[in] prestring Description of the failed step.
+         * @return The error string.
+         */
+        std::string GenerateErrorString(std::string prestring){
+            #ifdef _WIN32
+            int err = static_cast<int>(WSAGetLastError());
+            return prestring + std::string(" WSA error (") + std::to_string(err) + std::string(")");
+            #elif __linux__
+            int err = static_cast<int>(errno);
+            return prestring + std::string(" ") + std::string(strerror(err)) + std::string(" (") + std::to_string(err) + std::string(")");
+            #else
+            #error "Platform is not supported!"
+            #endif
+        }
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
@@ -0,0 +1,31 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief Counters that give information about the processing of received messages.
+ */
+class Statistics {
+    public:
+        uint64_t suppressedTouchpadPointerEvents;   // Number of messages whose touchpad pointer data differs from the previous message only within the deadband of the @ref ChangeThresholds.
+        uint64_t suppressedMotionSensorEvents;      // Number of messages whose motion sensor data differs from the previous message only within the deadband of the @ref ChangeThresholds.
+        uint64_t coalescedTouchpadPointerEvents;    // Number of touchpad pointer events that have been coalesced into other events due to a @ref RateLimit.
+        uint64_t coalescedMotionSensorEvents;       // Number of motion sensor events that have been coalesced into other events due to a @ref RateLimit.
+        uint64_t droppedDatagrams;                  // Number of datagrams that have been dropped by the kernel, because a socket receive buffer was full (Linux only).
+        uint64_t rejectedDatagrams;                 // Number of datagrams that have been dropped by the kernel filter of a socket, see @ref NetworkConfiguration::kernelFilter (Linux only).
+        uint64_t missingDeviceStates;               // Number of devices that connected while UDP_TOUCHPAD_MAX_DEVICE_STATES devices were connected, their states are not available.
+
+        /**
+         * @brief Construct new statistics, where all counters are zero.
+         */
+        Statistics(): suppressedTouchpadPointerEvents(0), suppressedMotionSensorEvents(0), coalescedTouchpadPointerEvents(0), coalescedMotionSensorEvents(0), droppedDatagrams(0), rejectedDatagrams(0), missingDeviceStates(0) {}
+};
+
+
+} /* namespace: udptouchpad */
+
@@ -0,0 +1,227 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+
+
+namespace udptouchpad {
+
+
+namespace detail {
+
+
+/**
+ * @brief A recorded trace span.
+ */
+class TraceEvent {
+    public:
+        const char* name;     // Name of the span, must be a string literal.
+        uint64_t begin;       // Begin of the span in nanoseconds of the steady clock.
+        uint64_t duration;    // Duration of the span in nanoseconds.
+        uint64_t argument;    // Additional value, e.g. a device ID or a message length.
+};
+
+
+/**
+ * @brief Ring buffer of trace events of one thread. Only the owning thread writes, any other thread may read concurrently.
+ * If the buffer is full, the oldest events are overwritten.
+ */
+class TraceBuffer: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Construct a new trace buffer.
+         * @param[in] threadIndex Index of the thread, used as thread ID of the exported events.
+         */
+        explicit TraceBuffer(uint32_t threadIndex): threadIndex(threadIndex), threadName(nullptr), active(true), numWritten(0), discarded(0) {}
+
+        /**
+         * @brief Add a trace event. Must only be called by the owning thread.
+         * @param[in] name Name of the span, must be a string literal.
+         * @param[in] begin Begin of the span in nanoseconds.
+         * @param[in] end End of the span in nanoseconds.
+         * @param[in] argument Additional value.
+         */
+        void Push(const char* name, uint64_t begin, uint64_t end, uint64_t argument){
+            uint64_t n = numWritten.load(std::memory_order_relaxed);
+            udptouchpad::detail::TraceEvent& e = events[n & (UDP_TOUCHPAD_TRACE_BUFFER_CAPACITY - 1)];
+            std::atomic_ref<const char*>(e.name).store(name, std::memory_order_relaxed);
+            std::atomic_ref<uint64_t>(e.begin).store(begin, std::memory_order_relaxed);
+            std::atomic_ref<uint64_t>(e.duration).store(end - begin, std::memory_order_relaxed);
+            std::atomic_ref<uint64_t>(e.argument).store(argument, std::memory_order_relaxed);
+            numWritten.store(n + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Copy all events of this buffer. Events that are overwritten while being copied are skipped.
+         * @param[out] result Container to which the events are appended.
+         */
+        void Read(std::vector<udptouchpad::detail::TraceEvent>& result){
+            uint64_t last = numWritten.load(std::memory_order_acquire);
+            uint64_t first = discarded.load(std::memory_order_relaxed);
+            if(last > UDP_TOUCHPAD_TRACE_BUFFER_CAPACITY){
+                first = std::max(first, last - UDP_TOUCHPAD_TRACE_BUFFER_CAPACITY);
+            }
+            size_t offset = result.size();
+            for(uint64_t n = first; n < last; ++n){
+                udptouchpad::detail::TraceEvent& e = events[n & (UDP_TOUCHPAD_TRACE_BUFFER_CAPACITY - 1)];
+                result.push_back({std::atomic_ref<const char*>(e.name).load(std::memory_order_relaxed), std::atomic_ref<uint64_t>(e.begin).load(std::memory_order_relaxed), std::atomic_ref<uint64_t>(e.duration).load(std::memory_order_relaxed), std::atomic_ref<uint64_t>(e.argument).load(std::memory_order_relaxed)});
+            }
+
+            // drop the events that may have been overwritten by the owning thread in the meantime
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t written = numWritten.load(std::memory_order_relaxed);
+            if(written > UDP_TOUCHPAD_TRACE_BUFFER_CAPACITY){
+                uint64_t firstValid = written - UDP_TOUCHPAD_TRACE_BUFFER_CAPACITY;
+                size_t numInvalid = (firstValid > first) ? static_cast<size_t>(std::min(firstValid, last) - first) : 0;
+                result.erase(result.begin() + offset, result.begin() + offset + numInvalid);
+            }
+        }
+
+        /**
+         * @brief Discard all events that have been written so far.
+         */
+        void Clear(void){ discarded.store(numWritten.load(std::memory_order_acquire), std::memory_order_relaxed); }
+
+        uint32_t threadIndex;                   // Index of the owning thread.
+        std::atomic<const char*> threadName;    // Name of the owning thread or nullptr if not set.
+        std::atomic<bool> active;               // True if the buffer is owned by a running thread, false if it can be reused.
+
+    private:
+        std::array<udptouchpad::detail::TraceEvent, UDP_TOUCHPAD_TRACE_BUFFER_CAPACITY> events;   // Ring buffer of events.
+        std::atomic<uint64_t> numWritten;                                                         // Total number of written events.
+        std::atomic<uint64_t> discarded;                                                          // Number of events that have been discarded by @ref Clear.
+};
+
+
+/**
+ * @brief Process-wide registry of all trace buffers. Each thread obtains its own buffer on first use. Buffers of terminated
+ * threads are kept, so that their events can still be exported, and are reused by new threads.
+ */
+class TraceRegistry: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Get the process-wide registry.
+         * @return Reference to the registry.
+         */
+        static udptouchpad::detail::TraceRegistry& Get(void){
+            static udptouchpad::detail::TraceRegistry registry;
+            return registry;
+        }
+
+        /**
+         * @brief Get the trace buffer of the calling thread. Only the first call of a thread takes a lock.
+         * @return Reference to the trace buffer of the calling thread.
+         */
+        udptouchpad::detail::TraceBuffer& ThreadBuffer(void){
+            thread_local ThreadBufferOwner owner(*this);
+            return *owner.buffer;
+        }
+
+        /**
+         * @brief Copy all events of all buffers.
+         * @param[out] result Container of (thread index, thread name, events) for each buffer.
+         */
+        void Read(std::vector<std::tuple<uint32_t, const char*, std::vector<udptouchpad::detail::TraceEvent>>>& result){
+            const std::lock_guard<std::mutex> lock(mtx);
+            result.clear();
+            for(auto&& buffer : buffers){
+                result.emplace_back(buffer->threadIndex, buffer->threadName.load(), std::vector<udptouchpad::detail::TraceEvent>());
+                buffer->Read(std::get<2>(result.back()));
+            }
+        }
+
+        /**
+         * @brief Discard all events of all buffers.
+         */
+        void Clear(void){
+            const std::lock_guard<std::mutex> lock(mtx);
+            for(auto&& buffer : buffers){
+                buffer->Clear();
+            }
+        }
+
+    private:
+        std::mutex mtx;                                                           // Protects the list of buffers.
+        std::vector<std::shared_ptr<udptouchpad::detail::TraceBuffer>> buffers;   // All trace buffers.
+
+        /**
+         * @brief Thread-local owner of a trace buffer, which releases the buffer when the thread terminates.
+         */
+        class ThreadBufferOwner {
+            public:
+                explicit ThreadBufferOwner(udptouchpad::detail::TraceRegistry& registry){ buffer = registry.Acquire(); }
+                ~ThreadBufferOwner(){ buffer->active = false; }
+                std::shared_ptr<udptouchpad::detail::TraceBuffer> buffer;   // The owned trace buffer.
+        };
+
+        /**
+         * @brief Get an unused trace buffer or create a new one.
+         * @return The trace buffer for the calling thread.
+         */
+        std::shared_ptr<udptouchpad::detail::TraceBuffer> Acquire(void){
+            const std::lock_guard<std::mutex> lock(mtx);
+            for(auto&& buffer : buffers){
+                if(!buffer->active){
+                    buffer->active = true;
+                    return buffer;
+                }
+            }
+            buffers.push_back(std::make_shared<udptouchpad::detail::TraceBuffer>(static_cast<uint32_t>(buffers.size() + 1)));
+            return buffers.back();
+        }
+};
+
+
+/**
+ * @brief Records the lifetime of a scope as trace span of the calling thread.
+ */
+class TraceScope: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Begin a trace span.
+         * @param[in] name Name of the span, must be a string literal.
+         * @param[in] argument Additional value, e.g. a device ID or a message length.
+         */
+        TraceScope(const char* name, uint64_t argument): name(name), argument(argument), begin(Now()) {}
+
+        /**
+         * @brief End the trace span and record it.
+         */
+        ~TraceScope(){
+            uint64_t end = Now();
+            udptouchpad::detail::TraceRegistry::Get().ThreadBuffer().Push(name, begin, end, argument);
+        }
+
+        /**
+         * @brief Get the current time.
+         * @return Nanoseconds of the steady clock.
+         */
+        static uint64_t Now(void){
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+    private:
+        const char* name;     // Name of the span.
+        uint64_t argument;    // Additional value.
+        uint64_t begin;       // Begin of the span in nanoseconds.
+};
+
+
+} /* namespace: detail */
+
+
+} /* namespace: udptouchpad */
+
+
+/* trace points compile to nothing unless UDP_TOUCHPAD_ENABLE_TRACING is defined */
+#ifdef UDP_TOUCHPAD_ENABLE_TRACING
+#define UDP_TOUCHPAD_TRACE_CONCAT_IMPL(a, b) a##b
+#define UDP_TOUCHPAD_TRACE_CONCAT(a, b) UDP_TOUCHPAD_TRACE_CONCAT_IMPL(a, b)
+#define UDP_TOUCHPAD_TRACE_SCOPE(name, argument) udptouchpad::detail::TraceScope UDP_TOUCHPAD_TRACE_CONCAT(udptouchpadTraceScope, __LINE__)(name, static_cast<uint64_t>(argument))
+#define UDP_TOUCHPAD_TRACE_THREAD_NAME(name) udptouchpad::detail::TraceRegistry::Get().ThreadBuffer().threadName = (name)
+#else
+#define UDP_TOUCHPAD_TRACE_SCOPE(name, argument) ((void)0)
+#define UDP_TOUCHPAD_TRACE_THREAD_NAME(name) ((void)0)
+#endif
+
@@ -0,0 +1,103 @@
+#pragma once
+
+
+#include <udptouchpad/detail/Common.hpp>
+#include <udptouchpad/detail/NonCopyable.hpp>
+
+
+namespace udptouchpad {
+
+
+/**
+ * @brief The reason why @ref Transport::Receive has returned.
+ */
+enum TransportStatus: uint8_t {
+    transport_status_stopped = 0,    // Receiving has been stopped by @ref Transport::WakeUp or the transport has to be re-opened.
+    transport_status_error = 1,      // Receiving failed, the transport is re-opened after the retry time of the network configuration.
+    transport_status_finished = 2    // The transport has no more data, e.g. a replayed recording has ended. The transport is not re-opened.
+};
+
+
+/**
+ * @brief Interface for all objects that process the raw datagrams of a @ref Transport.
+ */
+class DatagramSink {
+    public:
+        /**
+         * @brief Destroy the datagram sink.
+         */
+        virtual ~DatagramSink(){}
+
+        /**
+         * @brief Process a received datagram.
+         * @param[in] source The source address from where the datagram was sent, which is used as device ID.
+         * @param[in] endpoint Index of the network endpoint on which the datagram has been received.
+         * @param[in] bytes The bytes of the datagram. The bytes may be modified by the sink, e.g. to swap the byte order.
+         * @param[in] length The number of bytes.
+         * @param[in] timestamp Time when the datagram has been received.
+         */
+        virtual void ProcessDatagram(const uint32_t source, const uint16_t endpoint, uint8_t* bytes, const int32_t length, const std::chrono::time_point<std::chrono::steady_clock> timestamp) = 0;
+
+        /**
+         * @brief Process an error of the transport that does not stop receiving, e.g. the fallback to another receive backend.
+         * @param[in] msg The error message.
+         */
+        virtual void ProcessTransportError(const std::string& msg) = 0;
+
+        /**
+         * @brief Process datagrams that have been dropped before they could be received.
+         * @param[in] endpoint Index of the network endpoint on which the datagrams have been dropped.
+         * @param[in] numDropped Number of datagrams that have been dropped, because the receive buffer was full.
+         * @param[in] numRejected Number of datagrams that have been rejected by a filter.
+         */
+        virtual void ProcessDroppedDatagrams(const uint16_t endpoint, const uint64_t numDropped, const uint64_t numRejected) = 0;
+};
+
+
+/**
+ * @brief Interface for all sources of datagrams from which an @ref EventSystem receives messages, e.g. multicast UDP, an
+ * in-process channel or a replayed recording. The receive thread of the event system opens the transport, receives until
+ * @ref Receive returns and closes the transport again.
+ */
+class Transport: public udptouchpad::detail::NonCopyable {
+    public:
+        /**
+         * @brief Destroy the transport.
+         */
+        virtual ~Transport(){}
+
+        /**
+         * @brief Open the transport. Pending wake-up requests are cleared.
+         * @return True if success, false otherwise. In this case, @ref GetErrorString gives information about the error and
+         * the transport is opened again after the retry time of the network configuration.
+         */
+        virtual bool Open(void) = 0;
+
+        /**
+         * @brief Close the transport.
+         */
+        virtual void Close(void) = 0;
+
+        /**
+         * @brief Receive datagrams and pass them to a sink until @ref WakeUp is called, an error occurs or no more data is available.
+         * @param[in] sink The sink to which all datagrams are passed.
+         * @return The reason why receiving has returned.
+         */
+        virtual udptouchpad::TransportStatus Receive(udptouchpad::DatagramSink& sink) = 0;
+
+        /**
+         * @brief Make @ref Receive return as soon as possible. This member function can be called from any thread. If the
+         * transport is not receiving, the next call to @ref Receive returns immediately.
+         */
+        virtual void WakeUp(void) = 0;
+
+        /**
+         * @brief Get the last error string that has been set by @ref Open or @ref Receive.
+         * @return String giving information about the last error.
+         */
+        virtual std::string GetErrorString(void) = 0;
+};
+
+
+} /* namespace: udptouchpad */
+
@@ -13,16 +13,49 @@
 #include <udptouchpad/detail/EventSystem.hpp>
 #include <udptouchpad/detail/Events.hpp>
 #include <udptouchpad/detail/TouchpadPointer.hpp>
+#include <udptouchpad/detail/DeviceState.hpp>
+#include <udptouchpad/detail/CompactEvents.hpp>
+#include <udptouchpad/detail/SharedMemorySubscriber.hpp>
+#include <udptouchpad/detail/EventAwaiter.hpp>
+#include <udptouchpad/detail/EventFilter.hpp>
+#include <udptouchpad/detail/ChangeThresholds.hpp>
+#include <udptouchpad/detail/Statistics.hpp>
+#include <udptouchpad/detail/RateLimit.hpp>
+#include <udptouchpad/detail/BatchEncoder.hpp>
+#include <udptouchpad/detail/NetworkConfiguration.hpp>
+#include <udptouchpad/detail/ChromeTraceExporter.hpp>
+#include <udptouchpad/detail/MessageRecording.hpp>
+#include <udptouchpad/detail/RecordingAnalyzer.hpp>
+#include <udptouchpad/detail/Transport.hpp>
+#include <udptouchpad/detail/InProcessTransport.hpp>
+#include <udptouchpad/detail/ReplayTransport.hpp>
 
 
 /* implementation details */
 #include <udptouchpad/detail/Common.hpp>
 #include <udptouchpad/detail/MulticastSocket.hpp>
+#include <udptouchpad/detail/InterfaceMonitor.hpp>
+#include <udptouchpad/detail/IoUringReceiver.hpp>
+#include <udptouchpad/detail/SocketPoller.hpp>
+#include <udptouchpad/detail/MulticastTransport.hpp>
 #include <udptouchpad/detail/NonCopyable.hpp>
 #include <udptouchpad/detail/ConditionVariable.hpp>
 #include <udptouchpad/detail/EventSystemNetworkBase.hpp>
+#include <udptouchpad/detail/MessageSink.hpp>
+#include <udptouchpad/detail/ReceiverHub.hpp>
+#include <udptouchpad/detail/Trace.hpp>
 #include <udptouchpad/detail/TouchpadMessage.hpp>
-#include <udptouchpad/detail/CircularFIFOBuffer.hpp>
+#include <udptouchpad/detail/BatchMessage.hpp>
+#include <udptouchpad/detail/LockFreeRingBuffer.hpp>
 #include <udptouchpad/detail/DeviceDatabase.hpp>
+#include <udptouchpad/detail/EventBatch.hpp>
 #include <udptouchpad/detail/DeviceData.hpp>
+#include <udptouchpad/detail/RateLimiter.hpp>
+#include <udptouchpad/detail/SeqLock.hpp>
+#include <udptouchpad/detail/DeviceStateTable.hpp>
+#include <udptouchpad/detail/DeviceStatePool.hpp>
+#include <udptouchpad/detail/SharedMemory.hpp>
+#include <udptouchpad/detail/MappedFile.hpp>
+#include <udptouchpad/detail/SharedMemoryLayout.hpp>
+#include <udptouchpad/detail/SharedMemoryPublisher.hpp>
 
@@ -0,0 +1,206 @@
+#include <udptouchpad.hpp>
+#include <iostream>
+#include <cstdlib>
+
+
+static std::atomic<uint64_t> numAllocations = 0;     // Number of allocations that have been counted.
+static thread_local bool countAllocations = false;   // True if allocations of the calling thread are to be counted.
+
+
+/**
+ * @brief Allocate memory and count the allocation if counting is enabled for the calling thread.
+ * @param[in] size Number of bytes to be allocated.
+ * @param[in] alignment Alignment of the memory.
+ * @return Pointer to the allocated memory or nullptr if no memory is available.
+ */
+static void* CountedAllocate(std::size_t size, std::size_t alignment){
+    if(countAllocations){
+        numAllocations++;
+    }
+    size = std::max<std::size_t>(size, 1);
+    if(alignment <= alignof(std::max_align_t)){
+        return std::malloc(size);
+    }
+    return std::aligned_alloc(alignment, ((size + alignment - 1) / alignment) * alignment);
+}
+
+
+/**
+ * @brief Free memory that has been allocated by @ref CountedAllocate.
+ * @param[in] p Pointer to the memory to be freed.
+ * @details Not inlined, so that the compiler does not match the replaced operator new against the free function.
+ */
+[[gnu::noinline]] static void CountedFree(void* p) noexcept {
+    std::free(p);
+}
+
+
+void* operator new(std::size_t size){
+    void* p = CountedAllocate(size, alignof(std::max_align_t));
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t size){
+    void* p = CountedAllocate(size, alignof(std::max_align_t));
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new(std::size_t size, std::align_val_t alignment){
+    void* p = CountedAllocate(size, static_cast<std::size_t>(alignment));
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t size, std::align_val_t alignment){
+    void* p = CountedAllocate(size, static_cast<std::size_t>(alignment));
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size, alignof(std::max_align_t)); }
+void operator delete(void* p) noexcept { CountedFree(p); }
+void operator delete[](void* p) noexcept { CountedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { CountedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { CountedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { CountedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { CountedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { CountedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { CountedFree(p); }
+
+
+/**
+ * @brief An event system whose error messages can be generated by the test.
+ */
+class TestEventSystem: public udptouchpad::EventSystem {
+    public:
+        using udptouchpad::EventSystem::EventSystem;
+        using udptouchpad::EventSystem::ProcessErrorMessage;
+};
+
+
+/**
+ * @brief Number of events that have been delivered to the callbacks.
+ */
+struct Counters {
+    uint64_t errors = 0;                  // Number of error events.
+    uint64_t connections = 0;             // Number of device connection events.
+    uint64_t touchpadPointers = 0;        // Number of touchpad pointer events.
+    uint64_t compactPointers = 0;         // Number of compact touchpad pointer events.
+    uint64_t motionSensors = 0;           // Number of motion sensor events.
+    uint64_t batchConnections = 0;        // Number of device connection events delivered by batch callbacks.
+    uint64_t batchTouchpadPointers = 0;   // Number of touchpad pointer events delivered by batch callbacks.
+    uint64_t batchCompactPointers = 0;    // Number of compact touchpad pointer events delivered by batch callbacks.
+    uint64_t batchMotionSensors = 0;      // Number of motion sensor events delivered by batch callbacks.
+};
+
+
+/**
+ * @brief Send one message per device, where all pointer positions and motion sensor values depend on the round.
+ * @param[in] transport The transport via which the messages are sent.
+ * @param[in] numDevices Number of devices.
+ * @param[in] round The round that defines the message counter and the data.
+ */
+static void SendMessages(udptouchpad::InProcessTransport& transport, uint32_t numDevices, uint32_t round){
+    for(uint32_t d = 0; d < numDevices; ++d){
+        udptouchpad::detail::SerializationTouchpadMessageUnion msg;
+        msg.data.header = 0x42;
+        msg.data.counter = static_cast<uint8_t>(round);
+        msg.data.screenWidth = udptouchpad::detail::NetworkToNative(uint32_t(1000));
+        msg.data.screenHeight = udptouchpad::detail::NetworkToNative(uint32_t(2000));
+        msg.data.pointerID.fill(0xFF);
+        msg.data.pointerID[0] = 0;
+        for(auto&& p : msg.data.pointerPosition){
+            p.fill(0.0f);
+        }
+        msg.data.pointerPosition[0][0] = udptouchpad::detail::NetworkToNative(static_cast<float>(round % 1000));
+        msg.data.pointerPosition[0][1] = udptouchpad::detail::NetworkToNative(static_cast<float>(d % 2000));
+        for(size_t i = 0; i < 3; ++i){
+            msg.data.rotationVector[i] = udptouchpad::detail::NetworkToNative(0.001f * static_cast<float>(round));
+            msg.data.acceleration[i] = udptouchpad::detail::NetworkToNative(9.81f + 0.001f * static_cast<float>(round));
+            msg.data.angularRate[i] = udptouchpad::detail::NetworkToNative(0.002f * static_cast<float>(round));
+        }
+        (void) transport.Send(0x7F010001 + d, 0, &msg.bytes[0], sizeof(msg));
+    }
+    transport.Flush();
+}
+
+
+/**
+ * @brief Poll events of many devices with all callbacks set or with batch callbacks only and count the allocations of
+ * PollEvents in steady state.
+ * @param[in] singleCallbacks True if callbacks for single events are set in addition to batch callbacks.
+ * @return True if success, false otherwise.
+ */
+static bool Run(bool singleCallbacks){
+    // more devices than pending events are reserved, so that all internal containers must grow during warm-up
+    constexpr uint32_t numDevices = 2 * UDP_TOUCHPAD_PENDING_EVENTS_RESERVE;
+    constexpr uint32_t numWarmUpRounds = 8;
+    constexpr uint32_t numRounds = 64;
+    auto transport = std::make_shared<udptouchpad::InProcessTransport>();
+    TestEventSystem eventSystem(transport);
+    Counters counters;
+    eventSystem.SetErrorCallback([&counters](udptouchpad::ErrorEvent){ counters.errors++; });
+    if(singleCallbacks){
+        eventSystem.SetDeviceConnectionCallback([&counters](udptouchpad::DeviceConnectionEvent){ counters.connections++; });
+        eventSystem.SetTouchpadPointerCallback([&counters](udptouchpad::TouchpadPointerEvent){ counters.touchpadPointers++; });
+        eventSystem.SetCompactTouchpadPointerCallback([&counters](const udptouchpad::CompactTouchpadPointerEvent&){ counters.compactPointers++; });
+        eventSystem.SetMotionSensorCallback([&counters](udptouchpad::MotionSensorEvent){ counters.motionSensors++; });
+    }
+    eventSystem.SetDeviceConnectionBatchCallback([&counters](std::span<const udptouchpad::DeviceConnectionEvent> s){ counters.batchConnections += s.size(); });
+    eventSystem.SetTouchpadPointerBatchCallback([&counters](std::span<const udptouchpad::TouchpadPointerEvent> s){ counters.batchTouchpadPointers += s.size(); });
+    eventSystem.SetCompactTouchpadPointerBatchCallback([&counters](std::span<const udptouchpad::CompactTouchpadPointerEvent> s){ counters.batchCompactPointers += s.size(); });
+    eventSystem.SetMotionSensorBatchCallback([&counters](std::span<const udptouchpad::MotionSensorEvent> s){ counters.batchMotionSensors += s.size(); });
+
+    // warm-up: all devices connect and all containers reach their steady-state capacity
+    const std::string errorMessage("an error message that does not fit into the small string buffer");
+    for(uint32_t round = 0; round < numWarmUpRounds; ++round){
+        SendMessages(*transport, numDevices, round);
+        eventSystem.ProcessErrorMessage(errorMessage);
+        eventSystem.PollEvents();
+    }
+    if(counters.batchConnections != numDevices){
+        std::cerr << "[FAIL] expected " << numDevices << " connected devices, got " << counters.batchConnections << "\n";
+        return false;
+    }
+
+    // each connected device has a state of its own
+    std::vector<udptouchpad::DeviceState> states;
+    eventSystem.GetAllDeviceStates(states);
+    udptouchpad::DeviceState state;
+    bool allStates = (numDevices == states.size());
+    for(uint32_t d = 0; d < numDevices; ++d){
+        allStates &= eventSystem.GetDeviceState(0x7F010001 + d, state) && ((0x7F010001 + d) == state.deviceID);
+    }
+    if(!allStates){
+        std::cerr << "[FAIL] expected states of " << numDevices << " devices, got " << states.size() << "\n";
+        return false;
+    }
+
+    // steady state: only the allocations of PollEvents are counted
+    counters = Counters();
+    numAllocations = 0;
+    for(uint32_t round = numWarmUpRounds; round < (numWarmUpRounds + numRounds); ++round){
+        SendMessages(*transport, numDevices, round);
+        eventSystem.ProcessErrorMessage(errorMessage);
+        countAllocations = true;
+        eventSystem.PollEvents();
+        countAllocations = false;
+    }
+    const uint64_t numExpected = static_cast<uint64_t>(numRounds) * numDevices;
+    const uint64_t numExpectedSingle = singleCallbacks ? numExpected : 0;
+    bool success = (0 == numAllocations);
+    success &= (numRounds == counters.errors) && (0 == counters.connections) && (0 == counters.batchConnections);
+    success &= (numExpectedSingle == counters.touchpadPointers) && (numExpectedSingle == counters.compactPointers) && (numExpectedSingle == counters.motionSensors);
+    success &= (numExpected == counters.batchTouchpadPointers) && (numExpected == counters.batchCompactPointers) && (numExpected == counters.batchMotionSensors);
+    std::cerr << (success ? "[PASS]" : "[FAIL]") << (singleCallbacks ? " all callbacks," : " batch callbacks only,") << " allocations in " << numRounds << " calls to PollEvents: " << numAllocations << "\n";
+    std::cerr << "       errors: " << counters.errors << ", touchpad pointers: " << counters.touchpadPointers << "/" << counters.compactPointers << ", motion sensors: " << counters.motionSensors << " (expected " << numExpectedSingle << " each)";
+    std::cerr << ", batched: " << counters.batchTouchpadPointers << "/" << counters.batchCompactPointers << "/" << counters.batchMotionSensors << " (expected " << numExpected << " each)\n";
+    return success;
+}
+
+
+int main(int, char**){
+    bool success = Run(true);
+    success &= Run(false);
+    return success ? 0 : 1;
+}
+
@@ -0,0 +1,265 @@
+#include <udptouchpad.hpp>
+#include <iostream>
+
+
+using Message = udptouchpad::detail::SerializationTouchpadMessageUnion::SerializationTouchpadMessageStruct;
+using DeltaSample = udptouchpad::detail::SerializationBatchDeltaSampleV1;
+
+
+/**
+ * @brief A sample that has been decoded from a batched touchpad message.
+ */
+struct DecodedSample {
+    Message msg;    // The decoded message in native byte order.
+    uint32_t age;   // Time in microseconds between the sample and the transmission of the message.
+};
+
+
+/**
+ * @brief Generate samples of a device with moving pointers and motion sensor data.
+ * @param[in] numSamples Number of samples to be generated.
+ * @param[in] withMotionSensor True if the samples contain motion sensor data, false if all motion sensor values are NaN.
+ * @return The generated samples, one sample every millisecond.
+ */
+static std::vector<udptouchpad::BatchSample> GenerateSamples(size_t numSamples, bool withMotionSensor){
+    std::vector<udptouchpad::BatchSample> samples(numSamples);
+    for(size_t n = 0; n < numSamples; ++n){
+        udptouchpad::BatchSample& s = samples[n];
+        const float t = static_cast<float>(n);
+        s.timestamp = 1000000 + 1000 * static_cast<uint32_t>(n);
+        s.pointerID[0] = 0;
+        s.pointerPosition[0] = {100.0f + 3.3f * t, 200.0f - 1.7f * t};
+        if(n % 4){
+            s.pointerID[1] = 1;
+            s.pointerPosition[1] = {512.25f + 0.01f * t, 77.77f + 5.0f * t};
+        }
+        if(withMotionSensor){
+            s.rotationVector = {0.1f + 0.001f * t, -0.2f, 0.3f - 0.0003f * t};
+            s.acceleration = {0.05f * t, 9.81f, -0.123f};
+            s.angularRate = {0.01f, -0.02f * t, 0.0f};
+        }
+    }
+    return samples;
+}
+
+
+/**
+ * @brief Decode a batched touchpad message and append all samples.
+ * @param[in] message The message to be decoded.
+ * @param[inout] decoded The container to which the decoded samples are appended.
+ * @return True if the message is valid, false otherwise.
+ */
+static bool Decode(const std::vector<uint8_t>& message, std::vector<DecodedSample>& decoded){
+    return udptouchpad::detail::DecodeBatchMessage(message.data(), message.size(), [&decoded](const Message& msg, uint32_t age){
+        decoded.push_back(DecodedSample{msg, age});
+    });
+}
+
+
+/**
+ * @brief Check whether a decoded value is equal to the original value within half a quantization step.
+ * @param[in] original The original value.
+ * @param[in] value The decoded value.
+ * @param[in] scale The quantization step or zero if the value must be equal.
+ * @return True if both values are NaN or if they differ by at most half a quantization step, false otherwise.
+ */
+static bool IsClose(float original, float value, float scale){
+    if(std::isnan(original) || std::isnan(value)){
+        return std::isnan(original) && std::isnan(value);
+    }
+    const double tolerance = 0.5 * static_cast<double>(scale) + 4.0 * std::numeric_limits<float>::epsilon() * std::fabs(static_cast<double>(original));
+    return std::fabs(static_cast<double>(original) - static_cast<double>(value)) <= tolerance;
+}
+
+
+/**
+ * @brief Check whether a decoded sample is equal to the original sample within the quantization of delta samples.
+ * @param[in] s The original sample.
+ * @param[in] d The decoded sample.
+ * @param[in] exact True if the values must be equal, e.g. for complete samples.
+ * @return True if the samples are equal, false otherwise.
+ */
+static bool IsEqual(const udptouchpad::BatchSample& s, const Message& d, bool exact){
+    bool equal = (s.pointerID == d.pointerID);
+    for(size_t i = 0; i < s.pointerPosition.size(); ++i){
+        for(size_t k = 0; k < 2; ++k){
+            equal &= IsClose(s.pointerPosition[i][k], d.pointerPosition[i][k], exact ? 0.0f : DeltaSample::pointerPositionScale);
+        }
+    }
+    for(size_t i = 0; i < 3; ++i){
+        equal &= IsClose(s.rotationVector[i], d.rotationVector[i], exact ? 0.0f : DeltaSample::rotationVectorScale);
+        equal &= IsClose(s.acceleration[i], d.acceleration[i], exact ? 0.0f : DeltaSample::accelerationScale);
+        equal &= IsClose(s.angularRate[i], d.angularRate[i], exact ? 0.0f : DeltaSample::angularRateScale);
+    }
+    return equal;
+}
+
+
+/**
+ * @brief Encode samples into as many messages as required, decode all messages and compare the decoded samples with the
+ * original samples.
+ * @param[in] samples The samples to be encoded.
+ * @param[in] deltaEncoding True if samples are to be delta-encoded.
+ * @param[out] numMessages Number of messages that have been encoded.
+ * @return True if all samples have been decoded within the quantization step, in order and with the correct counter and age.
+ */
+static bool RoundTrip(const std::vector<udptouchpad::BatchSample>& samples, bool deltaEncoding, size_t& numMessages){
+    udptouchpad::BatchEncoder encoder(1000, 2000, deltaEncoding);
+    std::vector<uint8_t> message;
+    std::vector<DecodedSample> decoded;
+    std::vector<bool> complete;
+    const uint32_t transmitTimestamp = samples.back().timestamp + 500;
+    numMessages = 0;
+    bool success = true;
+    for(size_t offset = 0; offset < samples.size();){
+        size_t n = encoder.Encode(message, samples.data() + offset, samples.size() - offset, transmitTimestamp);
+        if(!n){
+            return false;
+        }
+        for(size_t i = 0; i < n; ++i){
+            complete.push_back(!deltaEncoding || !i);
+        }
+        success &= Decode(message, decoded);
+        offset += n;
+        numMessages++;
+    }
+    success &= (samples.size() == decoded.size());
+    for(size_t i = 0; success && (i < samples.size()); ++i){
+        success &= IsEqual(samples[i], decoded[i].msg, complete[i]);
+        success &= (static_cast<uint8_t>(i) == decoded[i].msg.counter);
+        success &= ((transmitTimestamp - samples[i].timestamp) == decoded[i].age);
+        success &= (1000 == decoded[i].msg.screenWidth) && (2000 == decoded[i].msg.screenHeight);
+    }
+    return success;
+}
+
+
+/**
+ * @brief Check that complete and delta-encoded messages are decoded within the quantization step.
+ * @return True if success, false otherwise.
+ */
+static bool TestRoundTrip(void){
+    constexpr size_t numSamples = 16;
+    constexpr size_t samplesPerMessage = (UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE - sizeof(udptouchpad::detail::SerializationBatchHeader)) / sizeof(udptouchpad::detail::SerializationBatchSampleV1);
+    constexpr size_t numExpectedComplete = (numSamples + samplesPerMessage - 1) / samplesPerMessage;
+    size_t numComplete = 0;
+    size_t numDelta = 0;
+    std::vector<udptouchpad::BatchSample> samples = GenerateSamples(numSamples, true);
+    bool success = RoundTrip(samples, false, numComplete) && RoundTrip(samples, true, numDelta);
+    success &= (numExpectedComplete == numComplete) && (1 == numDelta);
+    std::cerr << (success ? "[PASS]" : "[FAIL]") << " round trip: " << numSamples << " samples in " << numComplete << "/" << numExpectedComplete << " complete messages, " << numDelta << "/1 delta-encoded message\n";
+    return success;
+}
+
+
+/**
+ * @brief Check that a sample whose differences cannot be delta-encoded starts a new message with a complete sample.
+ * @return True if success, false otherwise.
+ */
+static bool TestDeltaOverflow(void){
+    std::vector<udptouchpad::BatchSample> samples = GenerateSamples(30, true);
+    for(size_t n = 10; n < samples.size(); ++n){
+        samples[n].pointerPosition[0][0] += 5000.0f;   // the step at sample 10 exceeds the range of a pointer position delta
+    }
+    for(size_t n = 20; n < samples.size(); ++n){
+        samples[n].acceleration[1] = -40.0f;           // the step at sample 20 exceeds the range of an acceleration delta
+    }
+    for(size_t n = 25; n < samples.size(); ++n){
+        samples[n].timestamp += 100000;                // the step at sample 25 exceeds the range of a timestamp delta
+    }
+    size_t numMessages = 0;
+    bool success = RoundTrip(samples, true, numMessages) && (4 == numMessages);
+    std::cerr << (success ? "[PASS]" : "[FAIL]") << " delta overflow: 30 samples in " << numMessages << "/4 messages\n";
+    return success;
+}
+
+
+/**
+ * @brief Check that NaN motion sensor data is delta-encoded if no motion sensor is available and that a change between NaN
+ * and finite values starts a new message.
+ * @return True if success, false otherwise.
+ */
+static bool TestNaN(void){
+    size_t numWithoutSensor = 0;
+    size_t numSwitching = 0;
+    std::vector<udptouchpad::BatchSample> samples = GenerateSamples(16, false);
+    bool success = RoundTrip(samples, true, numWithoutSensor) && (1 == numWithoutSensor);
+    std::vector<udptouchpad::BatchSample> withSensor = GenerateSamples(16, true);
+    for(size_t n = 10; n < samples.size(); ++n){
+        samples[n].rotationVector = withSensor[n].rotationVector;
+        samples[n].acceleration = withSensor[n].acceleration;
+        samples[n].angularRate = withSensor[n].angularRate;
+    }
+    samples[13].angularRate[2] = std::numeric_limits<float>::quiet_NaN();
+    success &= RoundTrip(samples, true, numSwitching) && (4 == numSwitching);
+    std::cerr << (success ? "[PASS]" : "[FAIL]") << " NaN: " << numWithoutSensor << "/1 message without motion sensor, " << numSwitching << "/4 messages with NaN changes\n";
+    return success;
+}
+
+
+/**
+ * @brief Check that a modified message is rejected and that no sample is decoded.
+ * @param[in] name The name of the modification.
+ * @param[in] message The modified message.
+ * @return True if the message is rejected, false otherwise.
+ */
+static bool ExpectRejected(const char* name, const std::vector<uint8_t>& message){
+    std::vector<DecodedSample> decoded;
+    bool success = !Decode(message, decoded) && decoded.empty();
+    if(!success){
+        std::cerr << "[FAIL] " << name << " has not been rejected\n";
+    }
+    return success;
+}
+
+
+/**
+ * @brief Check that invalid messages are rejected.
+ * @return True if success, false otherwise.
+ */
+static bool TestRejection(void){
+    std::vector<udptouchpad::BatchSample> samples = GenerateSamples(8, true);
+    bool success = true;
+    for(bool deltaEncoding : {false, true}){
+        udptouchpad::BatchEncoder encoder(1000, 2000, deltaEncoding);
+        std::vector<uint8_t> valid;
+        std::vector<DecodedSample> decoded;
+        success &= (samples.size() == encoder.Encode(valid, samples, 0)) && Decode(valid, decoded) && (samples.size() == decoded.size());
+        std::vector<uint8_t> m = valid;
+        m.pop_back();
+        success &= ExpectRejected("message that is one byte too short", m);
+        m = valid;
+        m.push_back(0);
+        success &= ExpectRejected("message that is one byte too long", m);
+        m.assign(valid.begin(), valid.begin() + sizeof(udptouchpad::detail::SerializationBatchHeader) - 1);
+        success &= ExpectRejected("truncated header", m);
+        m = valid;
+        m[offsetof(udptouchpad::detail::SerializationBatchHeader, header)] = 0x42;
+        success &= ExpectRejected("message with a wrong header", m);
+        m = valid;
+        m[offsetof(udptouchpad::detail::SerializationBatchHeader, version)] = 0xFF;
+        success &= ExpectRejected("message with an unknown version", m);
+        m = valid;
+        m[offsetof(udptouchpad::detail::SerializationBatchHeader, numSamples)] = 0;
+        success &= ExpectRejected("message without samples", m);
+        m.resize(sizeof(udptouchpad::detail::SerializationBatchHeader));
+        success &= ExpectRejected("header without samples", m);
+        m = valid;
+        m[offsetof(udptouchpad::detail::SerializationBatchHeader, numSamples)]++;
+        success &= ExpectRejected("message with too many samples", m);
+        m = valid;
+        m[offsetof(udptouchpad::detail::SerializationBatchHeader, flags)] ^= udptouchpad::detail::batch_flag_delta_encoded;
+        success &= ExpectRejected("message with a wrong encoding flag", m);
+    }
+    std::cerr << (success ? "[PASS]" : "[FAIL]") << " rejection of wrong lengths, unknown versions and messages without samples\n";
+    return success;
+}
+
+
+int main(int, char**){
+    bool success = TestRoundTrip();
+    success &= TestDeltaOverflow();
+    success &= TestNaN();
+    success &= TestRejection();
+    return success ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+#include <udptouchpad.hpp>
+#include <iostream>
+#include <future>
+#include <latch>
+
+
+/**
+ * @brief The callback that blocks until the receive side has processed all messages.
+ */
+enum BlockingCallback {
+    blocking_device_connection,   // The device connection callback blocks.
+    blocking_touchpad_pointer     // The touchpad pointer callback blocks.
+};
+
+
+/**
+ * @brief Send a message of a device with one pointer, whose position depends on the message counter.
+ * @param[in] transport The transport via which the message is sent.
+ * @param[in] device Index of the device.
+ * @param[in] counter The message counter.
+ */
+static void SendMessage(udptouchpad::InProcessTransport& transport, uint32_t device, uint8_t counter){
+    udptouchpad::detail::SerializationTouchpadMessageUnion msg;
+    msg.data.header = 0x42;
+    msg.data.counter = counter;
+    msg.data.screenWidth = udptouchpad::detail::NetworkToNative(uint32_t(1000));
+    msg.data.screenHeight = udptouchpad::detail::NetworkToNative(uint32_t(2000));
+    msg.data.pointerID.fill(0xFF);
+    msg.data.pointerID[0] = 0;
+    for(auto&& p : msg.data.pointerPosition){
+        p.fill(0.0f);
+    }
+    msg.data.pointerPosition[0][0] = udptouchpad::detail::NetworkToNative(static_cast<float>(counter));
+    msg.data.pointerPosition[0][1] = udptouchpad::detail::NetworkToNative(static_cast<float>(device));
+    msg.data.rotationVector.fill(std::numeric_limits<float>::quiet_NaN());
+    msg.data.acceleration.fill(std::numeric_limits<float>::quiet_NaN());
+    msg.data.angularRate.fill(std::numeric_limits<float>::quiet_NaN());
+    (void) transport.Send(0x7F010001 + device, 0, &msg.bytes[0], sizeof(msg));
+}
+
+
+/**
+ * @brief Block a callback inside PollEvents and check that the receive side continues to process messages.
+ * @param[in] blocking The callback that blocks.
+ * @return True if success, false otherwise.
+ */
+static bool Run(BlockingCallback blocking){
+    constexpr uint32_t numDevices = 64;
+    constexpr uint8_t numMessages = 16;
+    constexpr auto timeout = std::chrono::seconds(5);
+    auto transport = std::make_shared<udptouchpad::InProcessTransport>();
+    udptouchpad::EventSystem eventSystem(transport);
+    std::latch release(1);
+    std::atomic<bool> blocked = false;
+    uint64_t numConnections = 0;
+    uint64_t numTouchpadPointers = 0;
+    auto block = [&](void){
+        if(!blocked.exchange(true)){
+            release.wait();
+        }
+    };
+    eventSystem.SetDeviceConnectionCallback([&](udptouchpad::DeviceConnectionEvent){
+        numConnections++;
+        if(blocking_device_connection == blocking) block();
+    });
+    eventSystem.SetTouchpadPointerCallback([&](udptouchpad::TouchpadPointerEvent){
+        numTouchpadPointers++;
+        if(blocking_touchpad_pointer == blocking) block();
+    });
+
+    // the first device connects and moves its pointer, the callback blocks in the poll thread
+    SendMessage(*transport, 0, 0);
+    SendMessage(*transport, 0, 1);
+    transport->Flush();
+    std::thread pollThread([&eventSystem](){ eventSystem.PollEvents(); });
+    auto tStart = std::chrono::steady_clock::now();
+    while(!blocked){
+        if((std::chrono::steady_clock::now() - tStart) > timeout){
+            std::cerr << "[FAIL] the callback has not been called\n";
+            std::_Exit(1);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // all devices send messages while the callback blocks, the receive thread must process them
+    auto receiving = std::async(std::launch::async, [&](){
+        for(uint8_t counter = 0; counter < numMessages; ++counter){
+            for(uint32_t device = 0; device < numDevices; ++device){
+                if(device || (counter > 1)){
+                    SendMessage(*transport, device, counter);
+                }
+            }
+        }
+        transport->Flush();
+        (void) eventSystem.GetStatistics();
+    });
+    if(std::future_status::ready != receiving.wait_for(timeout)){
+        std::cerr << "[FAIL] PushNewMessage is blocked by a callback\n";
+        std::_Exit(1);
+    }
+    release.count_down();
+    pollThread.join();
+    eventSystem.PollEvents();
+    const uint64_t numExpectedTouchpadPointers = static_cast<uint64_t>(numDevices) * (numMessages - 1);
+    bool success = (numDevices == numConnections) && (numExpectedTouchpadPointers == numTouchpadPointers);
+    std::cerr << (success ? "[PASS]" : "[FAIL]") << " blocking " << ((blocking_device_connection == blocking) ? "device connection" : "touchpad pointer") << " callback: ";
+    std::cerr << numConnections << "/" << numDevices << " device connections, " << numTouchpadPointers << "/" << numExpectedTouchpadPointers << " touchpad pointers\n";
+    return success;
+}
+
+
+int main(int, char**){
+    bool success = Run(blocking_device_connection);
+    success &= Run(blocking_touchpad_pointer);
+    return success ? 0 : 1;
+}
+
@@ -0,0 +1,530 @@
+#include <udptouchpad.hpp>
+#include <iostream>
+#include <csignal>
+#include <random>
+#include <queue>
+#ifdef __linux__
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#else
+#error "Platform is not supported!"
+#endif
+
+
+/**
+ * @brief Pointer patterns that can be emulated.
+ */
+enum PointerPattern {
+    pattern_none,    // No pointer touches the screen.
+    pattern_tap,     // One pointer taps the screen once per second.
+    pattern_circle,  // One pointer moves on a circle.
+    pattern_swipe,   // One pointer swipes from left to right, is released and starts again.
+    pattern_multi    // Five pointers move on circles.
+};
+
+
+/**
+ * @brief Command line options of the load generator.
+ */
+struct Options {
+    uint32_t numDevices = 1;                                    // Number of virtual devices.
+    double rate = 50.0;                                         // Samples per second and device.
+    double duration = 10.0;                                     // Duration in seconds, zero runs until terminated.
+    std::string destination = "127.0.0.1";                      // Destination address, either unicast or multicast.
+    uint16_t port = UDP_TOUCHPAD_MULTICAST_DESTINATION_PORT;    // Destination port.
+    std::string sourceBase = "127.1.0.1";                       // Source address of the first device, device i uses sourceBase + i.
+    PointerPattern pattern = pattern_circle;                    // Pointer pattern of all devices.
+    bool motion = false;                                        // True if motion sensor data should be sent, false for NaN.
+    double loss = 0.0;                                          // Probability that a message is dropped.
+    double reorder = 0.0;                                       // Probability that a message is sent after the next message of the same device.
+    uint32_t batch = 0;                                         // Samples per batched message (header 0x43), zero sends single messages (header 0x42).
+    bool delta = false;                                         // True if batched messages should be delta-encoded.
+    uint32_t gso = 0;                                           // Number of single messages of a device that are sent as one UDP GSO buffer, zero sends each message on its own.
+    uint32_t seed = 1;                                          // Seed of the random number generator.
+    std::string record;                                         // Name of a recording file to which all sent messages are written, empty disables recording.
+};
+
+
+/**
+ * @brief State of one virtual device.
+ */
+struct VirtualDevice {
+    uint32_t sourceIP;                                              // Source address in host byte order.
+    uint8_t counter;                                                // Counter of the next single message.
+    double phase;                                                   // Phase offset of the pointer pattern and motion data in seconds.
+    std::vector<uint8_t> held;                                      // Message that is held back for reordering, empty if none.
+    std::vector<uint8_t> segments;                                  // Single messages that are collected for one UDP GSO buffer.
+    std::vector<udptouchpad::BatchSample> samples;                  // Samples of the next batched message.
+    std::unique_ptr<udptouchpad::BatchEncoder> encoder;             // Encoder for batched messages.
+};
+
+
+/**
+ * @brief Counters that are printed once per second.
+ */
+struct Counters {
+    uint64_t samples = 0;      // Number of generated samples.
+    uint64_t sent = 0;         // Number of sent datagrams, where each message of a UDP GSO buffer counts as one datagram.
+    uint64_t dropped = 0;      // Number of datagrams that have been dropped intentionally.
+    uint64_t reordered = 0;    // Number of datagrams that have been reordered intentionally.
+    uint64_t errors = 0;       // Number of datagrams that could not be sent.
+};
+
+
+/**
+ * @brief Sends datagrams with individual source addresses via sendmmsg. The source address of each datagram is selected by
+ * IP_PKTINFO, so that a single socket can emulate thousands of devices. Several messages of the same device can be sent as
+ * one UDP GSO buffer, which the kernel splits into datagrams of the segment size. On the loopback interface, a receiver with
+ * UDP GRO gets such a buffer in one piece, just like a burst of datagrams that has been coalesced by a network card.
+ */
+class Sender {
+    public:
+        static constexpr size_t maxPending = 64;   // Maximum number of datagrams per sendmmsg call.
+
+        /**
+         * @brief Construct a new sender.
+         */
+        Sender(): fd(-1), numPending(0) {}
+
+        /**
+         * @brief Destroy the sender and close the socket.
+         */
+        ~Sender(){
+            if(fd >= 0){
+                close(fd);
+            }
+        }
+
+        /**
+         * @brief Open the socket.
+         * @param[in] options The options containing the destination.
+         * @return True if success, false otherwise.
+         */
+        bool Open(const Options& options){
+            size_t maxLength = options.gso ? (options.gso * sizeof(udptouchpad::detail::SerializationTouchpadMessageUnion)) : static_cast<size_t>(UDP_TOUCHPAD_MAX_BATCH_MESSAGE_SIZE);
+            for(auto&& p : pending){
+                p.payload.resize(maxLength);
+            }
+            fd = socket(AF_INET, SOCK_DGRAM, 0);
+            if(fd < 0){
+                std::cerr << "[ERROR] Could not create socket: " << strerror(errno) << "\n";
+                return false;
+            }
+            destination = {};
+            destination.sin_family = AF_INET;
+            destination.sin_port = htons(options.port);
+            if(1 != inet_pton(AF_INET, options.destination.c_str(), &destination.sin_addr)){
+                std::cerr << "[ERROR] Invalid destination address \"" << options.destination << "\"!\n";
+                return false;
+            }
+            if(IN_MULTICAST(ntohl(destination.sin_addr.s_addr))){
+                int ttl = 1;
+                int loop = 1;
+                setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+                setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+            }
+            int sendBufferSize = 4 * 1024 * 1024;
+            setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize));
+            return true;
+        }
+
+        /**
+         * @brief Add a datagram to the pending datagrams, which are sent if @ref maxPending datagrams are pending.
+         * @param[in] sourceIP The source address in host byte order.
+         * @param[in] bytes The bytes of the datagram.
+         * @param[in] length The length of the datagram.
+         * @param[inout] counters The counters to be updated.
+         * @param[in] segmentSize If not zero, the datagram is sent as UDP GSO buffer that is split into datagrams of this size.
+         */
+        void Push(uint32_t sourceIP, const uint8_t* bytes, size_t length, Counters& counters, uint16_t segmentSize = 0){
+            Pending& p = pending[numPending++];
+            std::memcpy(p.payload.data(), bytes, std::min(length, p.payload.size()));
+            p.iov.iov_base = p.payload.data();
+            p.iov.iov_len = std::min(length, p.payload.size());
+            p.numDatagrams = segmentSize ? ((p.iov.iov_len + segmentSize - 1) / segmentSize) : 1;
+            std::memset(p.control, 0, sizeof(p.control));
+            cmsghdr* cmsg = reinterpret_cast<cmsghdr*>(p.control);
+            cmsg->cmsg_level = IPPROTO_IP;
+            cmsg->cmsg_type = IP_PKTINFO;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+            in_pktinfo* info = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
+            info->ipi_spec_dst.s_addr = htonl(sourceIP);
+            size_t controlLength = CMSG_SPACE(sizeof(in_pktinfo));
+            if(segmentSize){
+                cmsg = reinterpret_cast<cmsghdr*>(p.control + controlLength);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                std::memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(segmentSize));
+                controlLength += CMSG_SPACE(sizeof(uint16_t));
+            }
+            mmsghdr& m = headers[numPending - 1];
+            m = {};
+            m.msg_hdr.msg_name = &destination;
+            m.msg_hdr.msg_namelen = sizeof(destination);
+            m.msg_hdr.msg_iov = &p.iov;
+            m.msg_hdr.msg_iovlen = 1;
+            m.msg_hdr.msg_control = p.control;
+            m.msg_hdr.msg_controllen = controlLength;
+            if(numPending == maxPending){
+                Flush(counters);
+            }
+        }
+
+        /**
+         * @brief Send all pending datagrams.
+         * @param[inout] counters The counters to be updated.
+         */
+        void Flush(Counters& counters){
+            size_t offset = 0;
+            while(offset < numPending){
+                int n = sendmmsg(fd, &headers[offset], static_cast<unsigned int>(numPending - offset), 0);
+                if(n <= 0){
+                    counters.errors++;
+                    offset++;
+                    continue;
+                }
+                for(int i = 0; i < n; ++i){
+                    counters.sent += pending[offset++].numDatagrams;
+                }
+            }
+            numPending = 0;
+        }
+
+    private:
+        struct Pending {
+            std::vector<uint8_t> payload;                                                                     // Bytes of the datagram.
+            iovec iov;                                                                                        // Points to the payload.
+            size_t numDatagrams;                                                                              // Number of datagrams into which the payload is split.
+            alignas(cmsghdr) uint8_t control[CMSG_SPACE(sizeof(in_pktinfo)) + CMSG_SPACE(sizeof(uint16_t))];   // Control messages that select the source address and the segment size.
+        };
+        int fd;                                      // The socket.
+        sockaddr_in destination;                     // Destination of all datagrams.
+        std::array<Pending, maxPending> pending;     // Pending datagrams.
+        std::array<mmsghdr, maxPending> headers;     // Message headers of the pending datagrams.
+        size_t numPending;                           // Number of pending datagrams.
+};
+
+
+static std::atomic<bool> terminate = false;
+static void SignalHandler(int){ terminate = true; }
+
+
+/**
+ * @brief Print the command line options.
+ */
+static void PrintUsage(void){
+    std::cerr << "Usage: loadgenerator [options]\n"
+                 "  --devices N        number of virtual devices (default: 1)\n"
+                 "  --rate HZ          samples per second and device (default: 50)\n"
+                 "  --duration S       duration in seconds, 0 runs until Ctrl+C (default: 10)\n"
+                 "  --destination A    unicast or multicast destination address (default: 127.0.0.1)\n"
+                 "  --port P           destination port (default: 10891)\n"
+                 "  --source-base A    source address of the first device, device i uses A + i (default: 127.1.0.1)\n"
+                 "  --pattern P        pointer pattern: none, tap, circle, swipe, multi (default: circle)\n"
+                 "  --motion           send motion sensor data instead of NaN\n"
+                 "  --loss P           probability that a message is dropped (default: 0)\n"
+                 "  --reorder P        probability that a message is sent after the next one (default: 0)\n"
+                 "  --batch N          send batched messages with N samples, 0 sends single messages (default: 0)\n"
+                 "  --delta            delta-encode batched messages\n"
+                 "  --gso N            send N single messages of a device as one UDP GSO buffer, 0 sends each message on its own (default: 0)\n"
+                 "  --seed N           seed of the random number generator (default: 1)\n"
+                 "  --record FILE      write all sent single messages to a recording file for the recording analyzer\n";
+}
+
+
+/**
+ * @brief Parse the command line options.
+ * @param[in] argc Number of arguments.
+ * @param[in] argv Arguments.
+ * @param[out] options The parsed options.
+ * @return True if success, false if an option is invalid.
+ */
+static bool ParseOptions(int argc, char** argv, Options& options){
+    for(int i = 1; i < argc; ++i){
+        std::string key(argv[i]);
+        auto value = [&](void) -> std::string {
+            return (i + 1 < argc) ? std::string(argv[++i]) : std::string();
+        };
+        try{
+            if("--devices" == key) options.numDevices = static_cast<uint32_t>(std::stoul(value()));
+            else if("--rate" == key) options.rate = std::stod(value());
+            else if("--duration" == key) options.duration = std::stod(value());
+            else if("--destination" == key) options.destination = value();
+            else if("--port" == key) options.port = static_cast<uint16_t>(std::stoul(value()));
+            else if("--source-base" == key) options.sourceBase = value();
+            else if("--motion" == key) options.motion = true;
+            else if("--loss" == key) options.loss = std::stod(value());
+            else if("--reorder" == key) options.reorder = std::stod(value());
+            else if("--batch" == key) options.batch = static_cast<uint32_t>(std::stoul(value()));
+            else if("--delta" == key) options.delta = true;
+            else if("--gso" == key) options.gso = static_cast<uint32_t>(std::stoul(value()));
+            else if("--seed" == key) options.seed = static_cast<uint32_t>(std::stoul(value()));
+            else if("--record" == key) options.record = value();
+            else if("--pattern" == key){
+                std::string p = value();
+                if("none" == p) options.pattern = pattern_none;
+                else if("tap" == p) options.pattern = pattern_tap;
+                else if("circle" == p) options.pattern = pattern_circle;
+                else if("swipe" == p) options.pattern = pattern_swipe;
+                else if("multi" == p) options.pattern = pattern_multi;
+                else return false;
+            }
+            else return false;
+        }
+        catch(...){
+            return false;
+        }
+    }
+    return (options.numDevices > 0) && (options.rate > 0.0) && (options.batch <= 255) && (options.record.empty() || !options.batch) && (options.gso <= 64) && (!options.gso || !options.batch);
+}
+
+
+/**
+ * @brief Generate the sample of a device at a given time.
+ * @param[in] options The options containing the pointer pattern.
+ * @param[in] t Time in seconds, including the phase offset of the device.
+ * @param[in] width Width of the screen in pixels.
+ * @param[in] height Height of the screen in pixels.
+ * @return The generated sample, where the timestamp is not set.
+ */
+static udptouchpad::BatchSample GenerateSample(const Options& options, double t, float width, float height){
+    udptouchpad::BatchSample s;
+    auto circle = [&](size_t index, double radius, double speed){
+        s.pointerID[index] = static_cast<uint8_t>(index);
+        s.pointerPosition[index][0] = static_cast<float>(0.5 * width + radius * width * std::cos(speed * t + static_cast<double>(index)));
+        s.pointerPosition[index][1] = static_cast<float>(0.5 * height + radius * width * std::sin(speed * t + static_cast<double>(index)));
+    };
+    switch(options.pattern){
+        case pattern_none:
+            break;
+        case pattern_tap:
+            if(std::fmod(t, 1.0) < 0.1){
+                s.pointerID[0] = 0;
+                s.pointerPosition[0] = {0.5f * width, 0.5f * height};
+            }
+            break;
+        case pattern_circle:
+            circle(0, 0.3, 2.0);
+            break;
+        case pattern_swipe:
+            if(std::fmod(t, 1.0) < 0.8){
+                s.pointerID[0] = 0;
+                s.pointerPosition[0] = {static_cast<float>(std::fmod(t, 1.0) / 0.8) * width, 0.5f * height};
+            }
+            break;
+        case pattern_multi:
+            for(size_t i = 0; i < 5; ++i){
+                circle(i, 0.1 + 0.05 * static_cast<double>(i), 1.0 + 0.5 * static_cast<double>(i));
+            }
+            break;
+    }
+    if(options.motion){
+        for(size_t i = 0; i < 3; ++i){
+            double w = 0.5 + static_cast<double>(i);
+            s.rotationVector[i] = static_cast<float>(0.1 * std::sin(w * t));
+            s.acceleration[i] = static_cast<float>(((2 == i) ? 9.81 : 0.0) + 0.2 * std::sin(3.0 * w * t));
+            s.angularRate[i] = static_cast<float>(0.1 * w * std::cos(w * t));
+        }
+    }
+    return s;
+}
+
+
+/**
+ * @brief Convert a sample to a single touchpad message (header 0x42) in network byte order.
+ * @param[in] s The sample to be converted.
+ * @param[in] counter The message counter.
+ * @param[in] width Width of the screen in pixels.
+ * @param[in] height Height of the screen in pixels.
+ * @return The serialized message.
+ */
+static udptouchpad::detail::SerializationTouchpadMessageUnion ToSingleMessage(const udptouchpad::BatchSample& s, uint8_t counter, uint32_t width, uint32_t height){
+    udptouchpad::detail::SerializationTouchpadMessageUnion msg;
+    msg.data.header = 0x42;
+    msg.data.counter = counter;
+    msg.data.screenWidth = udptouchpad::detail::NetworkToNative(width);
+    msg.data.screenHeight = udptouchpad::detail::NetworkToNative(height);
+    msg.data.pointerID = s.pointerID;
+    for(size_t i = 0; i < s.pointerPosition.size(); ++i){
+        msg.data.pointerPosition[i][0] = udptouchpad::detail::NetworkToNative(s.pointerPosition[i][0]);
+        msg.data.pointerPosition[i][1] = udptouchpad::detail::NetworkToNative(s.pointerPosition[i][1]);
+    }
+    for(size_t i = 0; i < 3; ++i){
+        msg.data.rotationVector[i] = udptouchpad::detail::NetworkToNative(s.rotationVector[i]);
+        msg.data.acceleration[i] = udptouchpad::detail::NetworkToNative(s.acceleration[i]);
+        msg.data.angularRate[i] = udptouchpad::detail::NetworkToNative(s.angularRate[i]);
+    }
+    return msg;
+}
+
+
+/**
+ * @brief Send a message of a device or collect it for a UDP GSO buffer, which is sent as soon as it is full.
+ * @param[in] options The options containing the number of messages per UDP GSO buffer.
+ * @param[inout] device The device that sends the message.
+ * @param[in] bytes The bytes of the message.
+ * @param[in] length The length of the message.
+ * @param[inout] sender The sender.
+ * @param[inout] counters The counters to be updated.
+ */
+static void Send(const Options& options, VirtualDevice& device, const uint8_t* bytes, size_t length, Sender& sender, Counters& counters){
+    if(!options.gso){
+        sender.Push(device.sourceIP, bytes, length, counters);
+        return;
+    }
+    device.segments.insert(device.segments.end(), bytes, bytes + length);
+    if(device.segments.size() >= options.gso * length){
+        sender.Push(device.sourceIP, device.segments.data(), device.segments.size(), counters, static_cast<uint16_t>(length));
+        device.segments.clear();
+    }
+}
+
+
+/**
+ * @brief Send a message of a device, where packet loss and reordering are emulated.
+ * @param[in] options The options containing loss and reorder probabilities.
+ * @param[inout] device The device that sends the message.
+ * @param[inout] message The message to be sent. The content is undefined afterwards.
+ * @param[inout] sender The sender.
+ * @param[inout] recorder The recorder to which all sent messages are written if it is open.
+ * @param[inout] counters The counters to be updated.
+ * @param[inout] rng The random number generator.
+ */
+static void Emit(const Options& options, VirtualDevice& device, std::vector<uint8_t>& message, Sender& sender, udptouchpad::MessageRecorder& recorder, Counters& counters, std::mt19937& rng){
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    if(uniform(rng) < options.loss){
+        counters.dropped++;
+        return;
+    }
+    if(device.held.empty() && (uniform(rng) < options.reorder)){
+        device.held.swap(message);
+        counters.reordered++;
+        return;
+    }
+    Send(options, device, message.data(), message.size(), sender, counters);
+    if(recorder.IsOpen()){
+        (void) recorder.Record(device.sourceIP, 0, message.data(), message.size(), std::chrono::steady_clock::now());
+    }
+    if(!device.held.empty()){
+        Send(options, device, device.held.data(), device.held.size(), sender, counters);
+        if(recorder.IsOpen()){
+            (void) recorder.Record(device.sourceIP, 0, device.held.data(), device.held.size(), std::chrono::steady_clock::now());
+        }
+        device.held.clear();
+    }
+}
+
+
+int main(int argc, char** argv){
+    Options options;
+    if(!ParseOptions(argc, argv, options)){
+        PrintUsage();
+        return 1;
+    }
+    std::signal(SIGINT, &SignalHandler);
+    std::signal(SIGTERM, &SignalHandler);
+
+    Sender sender;
+    if(!sender.Open(options)){
+        return 1;
+    }
+    in_addr sourceBase;
+    if(1 != inet_pton(AF_INET, options.sourceBase.c_str(), &sourceBase)){
+        std::cerr << "[ERROR] Invalid source address \"" << options.sourceBase << "\"!\n";
+        return 1;
+    }
+    udptouchpad::MessageRecorder recorder;
+    if(!options.record.empty() && !recorder.Open(options.record)){
+        std::cerr << "[ERROR] " << recorder.GetErrorString() << "\n";
+        return 1;
+    }
+
+    // create virtual devices with random counters, so that counters wrap around at different times
+    constexpr uint32_t width = 1080;
+    constexpr uint32_t height = 1920;
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<VirtualDevice> devices(options.numDevices);
+    for(uint32_t i = 0; i < options.numDevices; ++i){
+        devices[i].sourceIP = ntohl(sourceBase.s_addr) + i;
+        devices[i].counter = static_cast<uint8_t>(rng());
+        devices[i].phase = 10.0 * uniform(rng);
+        if(options.batch){
+            devices[i].encoder = std::make_unique<udptouchpad::BatchEncoder>(width, height, options.delta);
+            devices[i].samples.reserve(options.batch);
+        }
+    }
+
+    // the schedule contains the next sample time (in periods) of each device, devices are spread uniformly over one period
+    using Entry = std::pair<uint64_t, uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> schedule;
+    const auto period = std::chrono::duration<double>(1.0 / options.rate);
+    const uint64_t subdivisions = options.numDevices;
+    for(uint32_t i = 0; i < options.numDevices; ++i){
+        schedule.push({i, i});
+    }
+    std::cerr << "Emulating " << options.numDevices << " devices at " << options.rate << " Hz to " << options.destination << ":" << options.port << "\nPress Ctrl+C to terminate\n";
+
+    // generate and send messages
+    Counters counters, previous;
+    auto tStart = std::chrono::steady_clock::now();
+    auto tPrint = tStart + std::chrono::seconds(1);
+    std::vector<uint8_t> message;
+    while(!terminate){
+        auto [slot, index] = schedule.top();
+        auto tDue = tStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(period * (static_cast<double>(slot) / static_cast<double>(subdivisions)));
+        auto tNow = std::chrono::steady_clock::now();
+        if(tDue > tNow){
+            sender.Flush(counters);
+            if(tNow >= tPrint){
+                Counters d{counters.samples - previous.samples, counters.sent - previous.sent, counters.dropped - previous.dropped, counters.reordered - previous.reordered, counters.errors - previous.errors};
+                std::cerr << "samples/s: " << d.samples << "  datagrams/s: " << d.sent << "  dropped: " << d.dropped << "  reordered: " << d.reordered << "  errors: " << d.errors << "\n";
+                previous = counters;
+                tPrint += std::chrono::seconds(1);
+            }
+            if((options.duration > 0.0) && ((tNow - tStart) >= std::chrono::duration<double>(options.duration))){
+                break;
+            }
+            std::this_thread::sleep_until(std::min(tDue, tPrint));
+            continue;
+        }
+        schedule.pop();
+        schedule.push({slot + subdivisions, index});
+
+        // generate the next sample of this device
+        VirtualDevice& device = devices[index];
+        double t = std::chrono::duration<double>(tDue - tStart).count();
+        udptouchpad::BatchSample sample = GenerateSample(options, t + device.phase, static_cast<float>(width), static_cast<float>(height));
+        sample.timestamp = static_cast<uint32_t>(static_cast<uint64_t>((t + device.phase) * 1.0e6));
+        counters.samples++;
+
+        // serialize as single or batched message(s)
+        if(options.batch){
+            device.samples.push_back(sample);
+            if(device.samples.size() < options.batch){
+                continue;
+            }
+            for(size_t offset = 0; offset < device.samples.size();){
+                offset += device.encoder->Encode(message, &device.samples[offset], device.samples.size() - offset, sample.timestamp);
+                Emit(options, device, message, sender, recorder, counters, rng);
+            }
+            device.samples.clear();
+        }
+        else{
+            udptouchpad::detail::SerializationTouchpadMessageUnion msg = ToSingleMessage(sample, device.counter++, width, height);
+            message.assign(&msg.bytes[0], &msg.bytes[0] + sizeof(msg));
+            Emit(options, device, message, sender, recorder, counters, rng);
+        }
+    }
+    for(auto&& device : devices){
+        if(!device.segments.empty()){
+            sender.Push(device.sourceIP, device.segments.data(), device.segments.size(), counters, static_cast<uint16_t>(sizeof(udptouchpad::detail::SerializationTouchpadMessageUnion)));
+        }
+    }
+    sender.Flush(counters);
+    std::cerr << "total samples: " << counters.samples << "  datagrams: " << counters.sent << "  dropped: " << counters.dropped << "  reordered: " << counters.reordered << "  errors: " << counters.errors << "\n";
+    return 0;
+}
+
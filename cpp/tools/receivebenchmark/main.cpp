@@ -0,0 +1,198 @@
+#ifndef UDP_TOUCHPAD_ENABLE_IO_URING
+#define UDP_TOUCHPAD_ENABLE_IO_URING
+#endif
+#include <udptouchpad.hpp>
+#include <iostream>
+#include <csignal>
+#ifdef __linux__
+#include <poll.h>
+#include <time.h>
+#else
+#error "Platform is not supported!"
+#endif
+
+
+/**
+ * @brief Receive backends that can be compared.
+ */
+enum ReceiveBackend {
+    backend_recvfrom,   // One recvmsg call per datagram, poll if no datagram is pending.
+    backend_io_uring    // Multishot recvmsg into a provided buffer ring, one io_uring_enter call per wake-up.
+};
+
+
+/**
+ * @brief Command line options of the receive benchmark.
+ */
+struct Options {
+    ReceiveBackend backend = backend_recvfrom;                         // The receive backend to be measured.
+    double duration = 10.0;                                            // Duration in seconds, zero runs until terminated.
+    std::string groupAddress = UDP_TOUCHPAD_MULTICAST_GROUP_ADDRESS;   // Multicast group address.
+    uint16_t port = UDP_TOUCHPAD_MULTICAST_DESTINATION_PORT;           // Destination port.
+};
+
+
+/**
+ * @brief Counters that are printed once per second.
+ */
+struct Counters {
+    uint64_t datagrams = 0;   // Number of received datagrams.
+    uint64_t syscalls = 0;    // Number of receive and wait system calls.
+    double cpuTime = 0.0;     // CPU time of the receiving thread in seconds.
+};
+
+
+static std::atomic<bool> terminate = false;
+static void SignalHandler(int){ terminate = true; }
+
+
+/**
+ * @brief Print the command line options.
+ */
+static void PrintUsage(void){
+    std::cerr << "Usage: receivebenchmark [options]\n"
+                 "  --backend B        receive backend: recvfrom, io_uring (default: recvfrom)\n"
+                 "  --duration S       duration in seconds, 0 runs until Ctrl+C (default: 10)\n"
+                 "  --group A          multicast group address (default: 239.192.82.74)\n"
+                 "  --port P           destination port (default: 10891)\n";
+}
+
+
+/**
+ * @brief Parse the command line options.
+ * @param[in] argc Number of arguments.
+ * @param[in] argv Arguments.
+ * @param[out] options The parsed options.
+ * @return True if success, false if an option is invalid.
+ */
+static bool ParseOptions(int argc, char** argv, Options& options){
+    for(int i = 1; i < argc; ++i){
+        std::string key(argv[i]);
+        auto value = [&](void) -> std::string {
+            return (i + 1 < argc) ? std::string(argv[++i]) : std::string();
+        };
+        try{
+            if("--duration" == key) options.duration = std::stod(value());
+            else if("--group" == key) options.groupAddress = value();
+            else if("--port" == key) options.port = static_cast<uint16_t>(std::stoul(value()));
+            else if("--backend" == key){
+                std::string b = value();
+                if("recvfrom" == b) options.backend = backend_recvfrom;
+                else if("io_uring" == b) options.backend = backend_io_uring;
+                else return false;
+            }
+            else return false;
+        }
+        catch(...){
+            return false;
+        }
+    }
+    return (options.duration >= 0.0);
+}
+
+
+/**
+ * @brief Get the CPU time of the calling thread.
+ * @return CPU time in seconds.
+ */
+static double GetThreadCpuTime(void){
+    timespec ts;
+    (void) clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + 1.0e-9 * static_cast<double>(ts.tv_nsec);
+}
+
+
+/**
+ * @brief Print the datagrams per second, system calls per datagram and CPU time per datagram.
+ * @param[in] label Label of the printed line.
+ * @param[in] d Counters of the measured interval.
+ * @param[in] seconds Length of the measured interval in seconds.
+ */
+static void PrintCounters(const char* label, const Counters& d, double seconds){
+    double n = static_cast<double>(std::max<uint64_t>(d.datagrams, 1));
+    std::cerr << label << "datagrams/s: " << static_cast<uint64_t>(static_cast<double>(d.datagrams) / seconds) << "  syscalls/datagram: " << (static_cast<double>(d.syscalls) / n) << "  cpu ns/datagram: " << static_cast<uint64_t>(1.0e9 * d.cpuTime / n) << "\n";
+}
+
+
+int main(int argc, char** argv){
+    Options options;
+    if(!ParseOptions(argc, argv, options)){
+        PrintUsage();
+        return 1;
+    }
+    std::signal(SIGINT, &SignalHandler);
+    std::signal(SIGTERM, &SignalHandler);
+
+    // datagrams are received one by one, so that both backends are compared for the same work per datagram
+    udptouchpad::NetworkConfiguration configuration;
+    configuration.receiveOffload = false;
+    udptouchpad::detail::MulticastSocket udpSocket;
+    if(!udpSocket.Open(udptouchpad::NetworkEndpoint(options.groupAddress, options.port), configuration)){
+        std::cerr << "[ERROR] " << udpSocket.GetErrorString() << "\n";
+        return 1;
+    }
+    udptouchpad::detail::IoUringReceiver ioUring;
+    if((backend_io_uring == options.backend) && !ioUring.Open(udpSocket.GetDescriptor())){
+        std::cerr << "[ERROR] " << ioUring.GetErrorString() << "\n";
+        return 1;
+    }
+    std::cerr << "Receiving via " << ((backend_io_uring == options.backend) ? "io_uring" : "recvfrom") << " on " << options.groupAddress << ":" << options.port << "\nPress Ctrl+C to terminate\n";
+
+    // the io_uring receiver is woken up periodically, so that counters can be printed while no datagrams arrive
+    std::thread timer([&ioUring](){
+        while(!terminate){
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            ioUring.WakeUp();
+        }
+        ioUring.WakeUp();
+    });
+
+    // receive and print the counters once per second
+    Counters counters, previous;
+    std::vector<uint8_t> buffer(65507);
+    pollfd descriptor{udpSocket.GetDescriptor(), POLLIN, 0};
+    double cpuStart = GetThreadCpuTime();
+    auto tStart = std::chrono::steady_clock::now();
+    auto tPrint = tStart + std::chrono::seconds(1);
+    while(!terminate){
+        if(backend_io_uring == options.backend){
+            counters.syscalls++;
+            int32_t result = ioUring.Receive([&counters](uint32_t, uint8_t*, int32_t){
+                counters.datagrams++;
+            }, [](){});
+            if(result < 0){
+                std::cerr << "[ERROR] io_uring receive failed with error code (" << -result << ")!\n";
+                break;
+            }
+        }
+        else{
+            uint32_t source;
+            int32_t segmentSize;
+            counters.syscalls++;
+            auto [rx, errorCode] = udpSocket.ReceiveFrom(source, segmentSize, &buffer[0], static_cast<int32_t>(buffer.size()), false);
+            if(rx < 0){
+                counters.syscalls++;
+                (void) poll(&descriptor, 1, 100);
+            }
+            else{
+                counters.datagrams++;
+            }
+        }
+        auto tNow = std::chrono::steady_clock::now();
+        if(tNow >= tPrint){
+            counters.cpuTime = GetThreadCpuTime() - cpuStart;
+            PrintCounters("", Counters{counters.datagrams - previous.datagrams, counters.syscalls - previous.syscalls, counters.cpuTime - previous.cpuTime}, 1.0);
+            previous = counters;
+            tPrint += std::chrono::seconds(1);
+        }
+        if((options.duration > 0.0) && ((tNow - tStart) >= std::chrono::duration<double>(options.duration))){
+            break;
+        }
+    }
+    terminate = true;
+    timer.join();
+    counters.cpuTime = GetThreadCpuTime() - cpuStart;
+    PrintCounters("total ", counters, std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count());
+    return 0;
+}
+
@@ -0,0 +1,100 @@
+#include <udptouchpad.hpp>
+#include <iostream>
+#include <iomanip>
+
+
+/**
+ * @brief Command line options of the recording analyzer.
+ */
+struct Options {
+    uint32_t numThreads = 0;              // Number of threads, zero uses one thread per hardware thread.
+    double maxEventRate = 0.0;            // Maximum number of events per second and device, zero disables rate limiting.
+    std::vector<std::string> filenames;   // Names of the recording files.
+};
+
+
+/**
+ * @brief Print the command line options.
+ */
+static void PrintUsage(void){
+    std::cerr << "Usage: recordinganalyzer [options] file...\n"
+                 "  --threads N        number of threads, 0 uses one thread per hardware thread (default: 0)\n"
+                 "  --rate HZ          maximum event rate per device, 0 disables rate limiting (default: 0)\n";
+}
+
+
+/**
+ * @brief Parse the command line options.
+ * @param[in] argc Number of arguments.
+ * @param[in] argv Arguments.
+ * @param[out] options The parsed options.
+ * @return True if success, false if an option is invalid.
+ */
+static bool ParseOptions(int argc, char** argv, Options& options){
+    for(int i = 1; i < argc; ++i){
+        std::string key(argv[i]);
+        auto value = [&](void) -> std::string {
+            return (i + 1 < argc) ? std::string(argv[++i]) : std::string();
+        };
+        try{
+            if("--threads" == key) options.numThreads = static_cast<uint32_t>(std::stoul(value()));
+            else if("--rate" == key) options.maxEventRate = std::stod(value());
+            else if(("--help" == key) || ("-h" == key)) return false;
+            else options.filenames.push_back(key);
+        }
+        catch(...){
+            return false;
+        }
+    }
+    return !options.filenames.empty() && (options.maxEventRate >= 0.0);
+}
+
+
+/**
+ * @brief Convert a device ID to its dotted IPv4 address.
+ * @param[in] deviceID The device ID, which is equal to the IPv4 address.
+ * @return The IPv4 address as string.
+ */
+static std::string ToAddressString(uint32_t deviceID){
+    return std::to_string((deviceID >> 24) & 0xFF) + "." + std::to_string((deviceID >> 16) & 0xFF) + "." + std::to_string((deviceID >> 8) & 0xFF) + "." + std::to_string(deviceID & 0xFF);
+}
+
+
+int main(int argc, char** argv){
+    Options options;
+    if(!ParseOptions(argc, argv, options)){
+        PrintUsage();
+        return 1;
+    }
+    udptouchpad::RecordingAnalyzer analyzer;
+    analyzer.SetNumberOfThreads(options.numThreads);
+    analyzer.SetRateLimit(udptouchpad::RateLimit(options.maxEventRate, udptouchpad::rate_limit_latest));
+
+    // analyze all recordings and measure the processing time
+    std::vector<udptouchpad::RecordedDeviceReport> reports;
+    auto tStart = std::chrono::steady_clock::now();
+    if(!analyzer.Analyze(options.filenames, reports)){
+        std::cerr << "[ERROR] " << analyzer.GetErrorString() << "\n";
+        return 1;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+    // print one line per device and the totals
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "device           endpoint  messages      lost  loss[%]  reordered  interval[ms]  jitter[ms]  max[ms]  reconnects  touches  touch[s]  duration[s]\n";
+    uint64_t numMessages = 0, numLostMessages = 0;
+    double recordedDuration = 0.0;
+    for(auto&& r : reports){
+        std::cout << std::left << std::setw(17) << ToAddressString(r.deviceID) << std::right;
+        std::cout << std::setw(8) << r.endpoint << std::setw(10) << r.numMessages << std::setw(10) << r.numLostMessages << std::setw(9) << (100.0 * r.GetLossRatio());
+        std::cout << std::setw(11) << r.numOutOfOrderMessages << std::setw(14) << (1000.0 * r.meanMessageInterval) << std::setw(12) << (1000.0 * r.stdMessageInterval) << std::setw(9) << (1000.0 * r.maxMessageInterval);
+        std::cout << std::setw(12) << (r.numConnections ? (r.numConnections - 1) : 0) << std::setw(9) << r.numTouches << std::setw(10) << r.touchDuration << std::setw(13) << r.GetDuration() << "\n";
+        numMessages += r.numMessages;
+        numLostMessages += r.numLostMessages;
+        recordedDuration += r.GetDuration();
+    }
+    std::cerr << "devices: " << reports.size() << "  messages: " << numMessages << "  lost: " << numLostMessages << "\n";
+    std::cerr << "processed " << recordedDuration << " s of recorded device time in " << elapsed << " s (" << (1.0e-6 * static_cast<double>(numMessages) / std::max(elapsed, 1.0e-9)) << " million messages per second)\n";
+    return 0;
+}
+